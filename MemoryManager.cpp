@@ -9,62 +9,94 @@
  */
 
 #include <stdint.h>
+#include "include/dit_math.h"
+
+extern "C" {
+#include "kernel/sched.h"
+#include "kernel/e820.h"
+#include "kernel/paging.h"
+}
 
 extern "C" {
     void memory_init(void);
     void memory_timestep(uint32_t global_time);
+    void memory_sweep(uint32_t global_time, uint32_t budget_cycles);
+    uint32_t memory_allocate(uint32_t size);
+    void memory_free(uint32_t address);
+    void memory_discard(uint32_t address);
+    void memory_register_reclaimer(uint32_t (*reclaim)(uint32_t pages_wanted));
+    uint32_t memory_allocate_zeroed(uint32_t size);
+    void memory_zero_pool_refill(void);
+    uint32_t memory_handle_alloc(uint32_t size);
+    uint32_t memory_handle_lock(uint32_t handle);
+    void memory_handle_unlock(uint32_t handle);
+    void memory_handle_free(uint32_t handle);
+    void memory_compact(uint32_t budget_cycles);
 }
 
-/* Local definitions to avoid host headers */
-#define M_PI 3.14159265358979323846
-
+// Cabeza byte a byte hasta alinear el destino a 4, cuerpo con rep
+// stos/movs de 32 bits y cola byte a byte. Sin SSE (el kernel no
+// habilita OSFXSR): las instrucciones de cadena ya copian por líneas
+// en CPUs con ERMSB
 extern "C" void* memset(void* dest, int ch, uint32_t count) {
     uint8_t* ptr = (uint8_t*)dest;
+    while (count && ((uintptr_t)ptr & 3)) {
+        *ptr++ = (uint8_t)ch;
+        count--;
+    }
+    
+    uint32_t words = count >> 2;
+    uint32_t pattern = (uint8_t)ch * 0x01010101u;
+    __asm__ __volatile__("rep stosl" : "+D"(ptr), "+c"(words) : "a"(pattern) : "memory");
+    
+    count &= 3;
     while (count--) *ptr++ = (uint8_t)ch;
     return dest;
 }
 
-/* Math approximations for bare-metal metriplectic dynamics */
-static double fabs(double x) { return x < 0 ? -x : x; }
-
-static double sin(double x) {
-    // Bhaskara I approximation
-    double x_deg = x * 180.0 / M_PI;
-    while (x_deg > 180) x_deg -= 360;
-    while (x_deg < -180) x_deg += 360;
+extern "C" void* memcpy(void* dest, const void* src, uint32_t count) {
+    uint8_t* d = (uint8_t*)dest;
+    const uint8_t* s = (const uint8_t*)src;
+    while (count && ((uintptr_t)d & 3)) {
+        *d++ = *s++;
+        count--;
+    }
     
-    int sign = 1;
-    if (x_deg < 0) { sign = -1; x_deg = -x_deg; }
-    if (x_deg > 180) { sign = -sign; x_deg -= 180; }
+    uint32_t words = count >> 2;
+    __asm__ __volatile__("rep movsl" : "+D"(d), "+S"(s), "+c"(words) : : "memory");
     
-    return sign * (4.0 * x_deg * (180.0 - x_deg)) / (40500.0 - x_deg * (180.0 - x_deg));
-}
-
-static double cos(double x) {
-    return sin(x + M_PI / 2.0);
-}
-
-static double exp(double x) {
-    // Simple Taylor approximation for small x
-    double sum = 1.0;
-    double term = 1.0;
-    for (int i = 1; i < 10; i++) {
-        term *= x / i;
-        sum += term;
-    }
-    return sum;
+    count &= 3;
+    while (count--) *d++ = *s++;
+    return dest;
 }
 
 // ============================================================
 // CONSTANTES FÍSICAS
 // ============================================================
 
-#define PHI 0.18                    // Razón áurea conjugada
+#define MEMORY_PHI 0.18             // Razón áurea conjugada
 #define THERMAL_BATH_TEMP 300.0     // Temperatura baño (unidades arbitrarias)
 #define VISCOSITY_BASE 0.1          // η₀ (viscosidad basal)
-#define MAX_MEMORY_PAGES 256        // Max páginas: 256 × 4KB = 1MB
 #define PAGE_SIZE 4096              // Tamaño de página
-#define MEMORY_BASE 0x100000        // 1MB físicos disponibles
+#define MEMORY_BASE 0x100000        // Página 0 del gestor: por debajo, kernel y BIOS
+#define MEMORY_DEFAULT_PAGES 256    // Sin mapa E820: el megabyte sobre MEMORY_BASE
+#define MEMORY_LIMIT_PAGES ((PAGING_IDENTITY_LIMIT - MEMORY_BASE) >> PAGE_SHIFT) // Bajo la ventana de arenas
+#define MEMORY_PRESSURE_PAGES 16    // Marca baja: por debajo se reclaman cachés
+#define MAX_RECLAIMERS 4            // Cachés del kernel registradas
+#define PAGE_SHIFT 12               // log2(PAGE_SIZE)
+#define BUDDY_MAX_ORDER 10          // Bloque máximo: 2^10 páginas = 4MB
+#define BUDDY_ORDERS (BUDDY_MAX_ORDER + 1)
+#define PAGE_NONE 0xFFFFFFFFu       // Fin de lista / ninguna página
+#define AGGREGATE_RESYNC_UPDATES 4096 // Recuento exacto de las sumas cada N deltas
+#define EVAPORATION_EPSILON 0.1     // Evaporada cuando θ > 2π - ε
+#define CATCHUP_MAX_STEPS 4         // Pasos exactos al poner al día una página viva
+#define RELAX_SEGMENTS 4            // Tramos de la relajación en forma cerrada
+#define EVAP_WHEEL_SLOTS 256        // Rueda de evaporación: un slot por tick (potencia de 2)
+#define PAGE_FRESH_THETA 0.1        // θ de una página recién asignada
+#define MAX_MEMORY_HANDLES 256      // Bloques reubicables (memory_handle_*)
+#define COMPACT_MAX_ORDER 6         // Mayor bloque que mueve la compactación (256KB)
+#define COMPACT_SCAN_LIMIT 64       // Cabezas libres examinadas al buscar destino
+#define ZERO_POOL_PAGES 32          // Páginas a cero que el bucle ocioso mantiene listas
 
 // Estados de una página metriplética
 typedef enum {
@@ -75,28 +107,61 @@ typedef enum {
 } MemoryState;
 
 // ============================================================
-// ESTRUCTURA: Página de memoria metriplética
+// ESTRUCTURA: Páginas de memoria metriplética (estructura de arrays)
+// ============================================================
+
+// Un array contiguo por campo: la puesta al día de una página toca
+// sólo los campos que usa. La dirección física no se guarda: es
+// MEMORY_BASE + índice · PAGE_SIZE (page_address). Los arrays tienen
+// page_limit entradas y viven en RAM tomada del mapa E820 (memory_init)
+typedef struct {
+    double *theta;              // Ángulo en esfera de Bloch [0, 2π]
+    double *O_n;                // Operador cuasiperiódico (tabulado, ver PASO 3)
+    double *entropy;            // Entropía local S_BH = (Area/4)
+    double *viscosity;          // η(θ) acoplada al baño
+    double *rho;                // Densidad de información ρ(página)
+    uint8_t *state;             // MemoryState empaquetado
+    uint16_t *size;             // Bytes asignados (≤ PAGE_SIZE)
+    uint32_t *allocation_time;  // Timestamp asignación
+    uint32_t *last_update;      // Tick hasta el que θ está al día
+} MetripleticPages;
+
+// Mapa de bits con resumen: el bit w de summary indica words[w] ≠ 0,
+// así que buscar el siguiente bit salta 1024 páginas vacías por palabra
+typedef struct {
+    uint32_t *words;
+    uint32_t *summary;
+} PageBitmap;
+
+// ============================================================
+// ESTRUCTURA: Manejador de un bloque reubicable
 // ============================================================
 
+// El dueño guarda el manejador, no la dirección: la pide con
+// memory_handle_lock (que fija el bloque) y la suelta con
+// memory_handle_unlock. Sólo un bloque sin fijar puede moverse
 typedef struct {
-    uint32_t address;           // Dirección física
-    uint32_t size;              // Bytes asignados
-    double theta;               // Ángulo en esfera de Bloch [0, 2π]
-    double O_n;                 // Operador cuasiperiódico en esta página
-    MemoryState state;          // Estado termodinámico
-    double entropy;             // Entropía local S_BH = (Area/4)
-    double thermal_viscosity;   // η(θ) acoplada al baño
-    uint32_t allocation_time;   // Timestamp asignación
-} MetripleticPage;
+    uint32_t head;              // Cabeza del bloque (índice de página)
+    uint32_t stuck_pass;        // Pasada de compactación en la que no halló destino
+    uint16_t pins;              // Locks sin su unlock
+    uint8_t order;
+    uint8_t used;
+} MemoryHandle;
 
 // ============================================================
 // ESTRUCTURA: Gestor de memoria global
 // ============================================================
 
 typedef struct {
-    MetripleticPage pages[MAX_MEMORY_PAGES];
-    uint32_t total_pages;
-    uint32_t allocated_pages;
+    MetripleticPages pages;
+    uint32_t page_limit;        // Índices de página: [MEMORY_BASE, tope de la RAM)
+    uint32_t total_pages;       // Páginas utilizables entregadas al buddy
+    uint32_t metadata_pages;    // Páginas ocupadas por los arrays por página
+    uint32_t e820_entries;      // Entradas del mapa de la BIOS (0: megabyte por defecto)
+    uint32_t allocated_pages;   // Vivas más liberadas aún evaporándose
+    uint32_t live_pages;        // Bits en live
+    uint32_t now;               // Último tick visto (memory_sweep/memory_timestep)
+    uint32_t operator_pages;    // Páginas con Ô_n ya tabulado en pages.O_n
     
     // Observables del plasma
     double centroid_x;          // x̄ (componente X del centroide)
@@ -112,15 +177,220 @@ typedef struct {
     double metric_determinant;  // det(g_ij) ≈ responde a distribución
     double curvature;           // Curvatura de Ricci (geometría responde a masa)
     
+    // Sumas sobre las páginas no vacías, mantenidas por deltas
+    double sum_theta;
+    double sum_entropy;
+    double sum_viscosity;
+    double sum_rho;
+    uint32_t counted_pages;     // Páginas que aportan a las sumas
+    uint32_t aggregate_updates; // Deltas desde el último recuento exacto
+    
+    // Barrido incremental (memory_sweep): cursor round-robin y coste
+    uint32_t sweep_cursor;      // Siguiente página a evolucionar
+    uint32_t sweep_laps;        // Vueltas completas a la tabla
+    uint32_t sweep_last_pages;  // Páginas recorridas en el último barrido
+    uint32_t sweep_last_cycles; // Ciclos del último barrido
+    uint32_t sweep_max_cycles;  // Peor barrido observado
+    uint32_t sweep_overruns;    // Barridos que excedieron su presupuesto
+    uint32_t sweep_page_cost;   // Ciclos estimados por página evolucionada
+    uint32_t sweep_tail_cost;   // Ciclos estimados del cierre (observables)
+    
+    // Buddy: bloques EMPTY de 2^k páginas alineados a 2^k, en una
+    // lista doblemente enlazada por orden; bit k de free_orders marca
+    // la lista k no vacía. block_order es el orden de cada cabeza de
+    // bloque, libre o entregado. Las páginas fuera de las regiones
+    // utilizables (huecos del mapa, metadatos) nunca entran en las
+    // listas, así que ningún bloque se fusiona con ellas
+    uint32_t order_head[BUDDY_ORDERS];
+    uint32_t *buddy_next;
+    uint32_t *buddy_prev;
+    uint8_t *block_order;
+    uint32_t free_orders;
+    PageBitmap free_blocks;         // Cabezas de bloques libres
+    uint32_t *head_bitmap;          // Cabezas de bloques entregados
+    
+    // Páginas entregadas por memory_allocate y aún no liberadas, y
+    // páginas no vacías (vivas o evaporándose)
+    PageBitmap live;
+    PageBitmap held;
+    
+    // Rueda de evaporación: cada página liberada está en el slot de su
+    // tick previsto de evaporación (deadline mod EVAP_WHEEL_SLOTS)
+    uint32_t wheel_head[EVAP_WHEEL_SLOTS];
+    uint32_t *wheel_next;
+    uint32_t *wheel_deadline;
+    uint32_t wheel_time;        // Último tick procesado por la rueda
+    
+    // Reserva de páginas ya a cero (pila de índices): la rellena el
+    // bucle ocioso y la vacía memory_allocate_zeroed sin limpiar nada
+    uint32_t zero_pool[ZERO_POOL_PAGES];
+    uint32_t zero_pool_count;
+    uint32_t zero_pool_hits;    // Peticiones servidas desde la reserva
+    uint32_t zero_pool_misses;  // Peticiones de una página que tuvieron que limpiar
+    
+    // Bloques reubicables y compactación incremental (memory_compact)
+    MemoryHandle handles[MAX_MEMORY_HANDLES];
+    uint32_t compact_pass;      // Pasada en curso o última terminada
+    uint8_t compact_active;     // Hay una pasada a medias
+    uint8_t compact_dirty;      // Volvieron páginas al buddy desde la última pasada
+    uint32_t compact_moves;     // Bloques movidos
+    uint32_t compact_pages;     // Páginas movidas
+    uint32_t compact_page_cost; // Ciclos estimados por página movida
+    
+    // sin(θ) y η(θ) de una página recién asignada (PAGE_FRESH_THETA)
+    double fresh_sin_theta;
+    double fresh_viscosity;
+    
 } MemoryManager;
 
 static MemoryManager memmgr = {0};
 
+// Cachés que liberan páginas bajo presión (devuelven páginas liberadas)
+typedef uint32_t (*MemoryReclaimer)(uint32_t pages_wanted);
+static MemoryReclaimer reclaimers[MAX_RECLAIMERS];
+static uint32_t num_reclaimers = 0;
+
+// ============================================================
+// ASIGNADOR BUDDY E ÍNDICE DE PÁGINA
+// ============================================================
+
+static inline int bitmap_test(const uint32_t *map, uint32_t i) {
+    return (map[i >> 5] >> (i & 31)) & 1;
+}
+
+static inline void bitmap_set(uint32_t *map, uint32_t i) {
+    map[i >> 5] |= 1u << (i & 31);
+}
+
+static inline void bitmap_clear(uint32_t *map, uint32_t i) {
+    map[i >> 5] &= ~(1u << (i & 31));
+}
+
+static inline void page_bitmap_set(PageBitmap *map, uint32_t i) {
+    bitmap_set(map->words, i);
+    bitmap_set(map->summary, i >> 5);
+}
+
+static inline void page_bitmap_clear(PageBitmap *map, uint32_t i) {
+    bitmap_clear(map->words, i);
+    if (map->words[i >> 5] == 0) bitmap_clear(map->summary, i >> 5);
+}
+
+// Primer bit a 1 con índice ≥ from, o PAGE_NONE
+static uint32_t page_bitmap_next(const PageBitmap *map, uint32_t from) {
+    if (from >= memmgr.page_limit) return PAGE_NONE;
+    
+    uint32_t w = from >> 5;
+    uint32_t bits = map->words[w] & (~0u << (from & 31));
+    if (bits) return (w << 5) + (uint32_t)__builtin_ctz(bits);
+    
+    // Palabras siguientes no vacías, según el resumen
+    uint32_t words = (memmgr.page_limit + 31) >> 5;
+    if (++w >= words) return PAGE_NONE;
+    uint32_t summary_words = (words + 31) >> 5;
+    for (uint32_t s = w >> 5; s < summary_words; s++) {
+        uint32_t sbits = map->summary[s];
+        if (s == (w >> 5)) sbits &= ~0u << (w & 31);
+        if (sbits) {
+            uint32_t nw = (s << 5) + (uint32_t)__builtin_ctz(sbits);
+            return (nw << 5) + (uint32_t)__builtin_ctz(map->words[nw]);
+        }
+    }
+    return PAGE_NONE;
+}
+
+static void buddy_list_insert(uint32_t head, uint32_t order) {
+    uint32_t first = memmgr.order_head[order];
+    memmgr.buddy_prev[head] = PAGE_NONE;
+    memmgr.buddy_next[head] = first;
+    if (first != PAGE_NONE) memmgr.buddy_prev[first] = head;
+    memmgr.order_head[order] = head;
+    memmgr.block_order[head] = (uint8_t)order;
+    memmgr.free_orders |= 1u << order;
+    page_bitmap_set(&memmgr.free_blocks, head);
+}
+
+static void buddy_list_remove(uint32_t head) {
+    uint32_t order = memmgr.block_order[head];
+    uint32_t prev = memmgr.buddy_prev[head];
+    uint32_t next = memmgr.buddy_next[head];
+    
+    if (prev != PAGE_NONE) memmgr.buddy_next[prev] = next;
+    else memmgr.order_head[order] = next;
+    if (next != PAGE_NONE) memmgr.buddy_prev[next] = prev;
+    
+    if (memmgr.order_head[order] == PAGE_NONE) memmgr.free_orders &= ~(1u << order);
+    page_bitmap_clear(&memmgr.free_blocks, head);
+}
+
+// Bloque EMPTY a las listas, fusionándolo con su buddy mientras éste
+// esté libre y entero (mismo orden): O(log n)
+static void buddy_free_block(uint32_t head, uint32_t order) {
+    while (order < BUDDY_MAX_ORDER) {
+        uint32_t buddy = head ^ (1u << order);
+        if (buddy >= memmgr.page_limit ||
+            !bitmap_test(memmgr.free_blocks.words, buddy) ||
+            memmgr.block_order[buddy] != order) break;
+        
+        buddy_list_remove(buddy);
+        head &= buddy;  // La mitad baja es la cabeza del bloque fusionado
+        order++;
+    }
+    buddy_list_insert(head, order);
+}
+
+// Sacar el bloque libre head de su lista y quedarse con sus primeras
+// 2^order páginas: las mitades altas sobrantes vuelven a su lista
+static void buddy_take_block(uint32_t head, uint32_t order) {
+    uint32_t k = memmgr.block_order[head];
+    buddy_list_remove(head);
+    while (k > order) {
+        k--;
+        buddy_list_insert(head + (1u << k), k);
+    }
+    memmgr.block_order[head] = (uint8_t)order;
+}
+
+// Cabeza de un bloque de 2^order páginas, partiendo el menor bloque
+// mayor disponible (O(log n)); PAGE_NONE si no hay ninguno
+static uint32_t buddy_alloc_block(uint32_t order) {
+    if (order > BUDDY_MAX_ORDER) return PAGE_NONE;
+    uint32_t avail = memmgr.free_orders & (~0u << order);
+    if (avail == 0) return PAGE_NONE;
+    
+    uint32_t head = memmgr.order_head[__builtin_ctz(avail)];
+    buddy_take_block(head, order);
+    return head;
+}
+
+// Menor orden cuyo bloque cubre pages páginas
+static inline uint32_t pages_to_order(uint32_t pages) {
+    uint32_t order = 0;
+    while ((1u << order) < pages) order++;
+    return order;
+}
+
+static inline uint32_t page_address(uint32_t idx) {
+    return MEMORY_BASE + (idx << PAGE_SHIFT);
+}
+
+// Dirección física → índice, o PAGE_NONE si no es una página
+static inline uint32_t page_index(uint32_t address) {
+    uint32_t offset = address - MEMORY_BASE;
+    if (address < MEMORY_BASE || (offset & (PAGE_SIZE - 1))) return PAGE_NONE;
+    uint32_t idx = offset >> PAGE_SHIFT;
+    return (idx < memmgr.page_limit) ? idx : PAGE_NONE;
+}
+
+static inline int page_is_live(uint32_t idx) {
+    return bitmap_test(memmgr.live.words, idx);
+}
+
 // ============================================================
 // PASO 1: Centroide Z-Finch (Plasma mean field)
 // ============================================================
 
-double compute_centroid_z(void) {
+static double compute_centroid_z(double sum_theta, uint32_t count) {
     /*
      * z̄ = (1/A) ∫∫ θ(x,y) dA  sobre todas las páginas
      * 
@@ -128,18 +398,11 @@ double compute_centroid_z(void) {
      * - z̄ ≈ 0 → memoria confinada (polo norte, baja temperatura)
      * - z̄ ≈ 1 → memoria en equilibrio (ecuador)
      * - z̄ ≈ 2π → evaporación completa (polo sur)
+     * 
+     * Σθ y el número de páginas no vacías llegan del barrido de
+     * memory_timestep.
      */
     
-    double sum_theta = 0.0;
-    uint32_t count = 0;
-    
-    for (uint32_t i = 0; i < memmgr.total_pages; i++) {
-        if (memmgr.pages[i].state != MEM_EMPTY) {
-            sum_theta += memmgr.pages[i].theta;
-            count++;
-        }
-    }
-    
     if (count == 0) return 0.0;
     
     double z_finch = sum_theta / count;
@@ -164,8 +427,8 @@ double compute_thermal_viscosity(double theta) {
      * η_total = η₀ · [1 + β · sin(π·θ/(2π))]
      */
     
-    double base_visc = VISCOSITY_BASE * exp(theta / THERMAL_BATH_TEMP);
-    double oscillation = sin(M_PI * theta / (2.0 * M_PI));
+    double base_visc = VISCOSITY_BASE * dit_exp(theta / THERMAL_BATH_TEMP);
+    double oscillation = dit_sin(M_PI * theta / (2.0 * M_PI));
     
     return base_visc * (1.0 + 0.5 * oscillation);
 }
@@ -180,10 +443,20 @@ double compute_O_n_for_page(uint32_t page_idx) {
      * donde n = page_idx (cada página es un "paso temporal")
      */
     
-    double phase = M_PI * PHI * page_idx;
+    double phase = M_PI * MEMORY_PHI * page_idx;
     double parity = (page_idx & 1) ? -1.0 : 1.0;
     
-    return page_idx * parity * cos(phase);
+    return page_idx * parity * dit_cos(phase);
+}
+
+// Ô_n sólo depende del índice: se tabula una vez en pages.O_n y la
+// evolución lo lee. Si crece el número de páginas gestionadas se
+// completan las nuevas entradas; al decrecer, la tabla sigue válida.
+static void page_operator_table_resize(uint32_t total_pages) {
+    for (uint32_t i = memmgr.operator_pages; i < total_pages; i++) {
+        memmgr.pages.O_n[i] = compute_O_n_for_page(i);
+    }
+    if (total_pages > memmgr.operator_pages) memmgr.operator_pages = total_pages;
 }
 
 // ============================================================
@@ -203,9 +476,9 @@ MemoryState project_memory_state(double O_n, double theta) {
     
     if (theta > 5.0 * M_PI / 4.0) {
         return MEM_EVAPORATING;
-    } else if (theta > 3.0 * M_PI / 4.0 && fabs(O_n) > 1.5) {
+    } else if (theta > 3.0 * M_PI / 4.0 && dit_fabs(O_n) > 1.5) {
         return MEM_THERMAL;
-    } else if (theta > M_PI / 4.0 && fabs(O_n) > 0.5) {
+    } else if (theta > M_PI / 4.0 && dit_fabs(O_n) > 0.5) {
         return MEM_ALLOCATED;
     } else {
         return MEM_EMPTY;
@@ -216,7 +489,7 @@ MemoryState project_memory_state(double O_n, double theta) {
 // PASO 5: Métrica invertida (geometría responde a información)
 // ============================================================
 
-void update_inverted_geometry(void) {
+static void update_inverted_geometry(double rho_total) {
     /*
      * Métrica de flujo laminar inverso:
      * g_ij = δ_ij · [1 + λ · ρ(x,y)]
@@ -228,17 +501,12 @@ void update_inverted_geometry(void) {
      *   la métrica se "contrae" (g_ij crece)
      * - El espacio se deforma según la distribución
      * - Determinante: det(g_ij) ≈ evolución de la topología
+     * 
+     * rho_total = Σ ρ(página) sobre las páginas no vacías, con
+     * ρ(página) = (tamaño / PAGE_SIZE) × (1 + sin(θ)), acumulada en el
+     * barrido de memory_timestep.
      */
     
-    double rho_total = 0.0;
-    
-    for (uint32_t i = 0; i < memmgr.allocated_pages; i++) {
-        // ρ(página) = (tamaño / PAGE_SIZE) × (1 + sin(θ))
-        double rho = (memmgr.pages[i].size / (double)PAGE_SIZE) * 
-                     (1.0 + sin(memmgr.pages[i].theta));
-        rho_total += rho;
-    }
-    
     // Normalizar
     double rho_mean = memmgr.allocated_pages > 0 ? 
                       rho_total / memmgr.allocated_pages : 0.0;
@@ -256,7 +524,32 @@ void update_inverted_geometry(void) {
 // PASO 6: Dinámica metriplética de la página
 // ============================================================
 
-void metripletic_page_evolution(uint32_t page_idx, uint32_t timestep) {
+// θ nueva y sus campos derivados (estado, entropía, viscosidad, ρ)
+static void page_store(uint32_t page_idx, double theta, double eta) {
+    MetripleticPages *pg = &memmgr.pages;
+    double sin_theta = dit_sin(theta);
+    
+    pg->theta[page_idx] = theta;
+    
+    // Actualizar estado. La proyección no decide el ciclo de vida: una
+    // página viva nunca queda EMPTY (dejaría de evolucionar fuera de la
+    // lista libre) y una liberada sigue EVAPORATING hasta evaporarse
+    MemoryState state = project_memory_state(pg->O_n[page_idx], theta);
+    if (!page_is_live(page_idx)) state = MEM_EVAPORATING;
+    else if (state == MEM_EMPTY) state = MEM_ALLOCATED;
+    pg->state[page_idx] = (uint8_t)state;
+    
+    // Entropía de Bekenstein-Hawking (área ~θ)
+    pg->entropy[page_idx] = (dit_fabs(sin_theta) + 0.1) / 4.0;
+    
+    // Viscosidad local
+    pg->viscosity[page_idx] = eta;
+    
+    // Densidad de información (métrica invertida)
+    pg->rho[page_idx] = (pg->size[page_idx] / (double)PAGE_SIZE) * (1.0 + sin_theta);
+}
+
+static void metripletic_page_evolution(uint32_t page_idx, uint32_t timestep) {
     /*
      * dθ/dt = {θ, H} + (θ, S)
      *         -------    -------
@@ -269,75 +562,330 @@ void metripletic_page_evolution(uint32_t page_idx, uint32_t timestep) {
      * dθ_Diss/dt = η(θ) · (θ - θ_thermal_eq)
      */
     
-    MetripleticPage *page = &memmgr.pages[page_idx];
+    MetripleticPages *pg = &memmgr.pages;
+    double theta = pg->theta[page_idx];
+    (void)timestep;
+    
+    // Operador de la página (tabulado)
+    double O_n = pg->O_n[page_idx];
     
-    // Operador actualizado
-    page->O_n = compute_O_n_for_page(page_idx);
+    // Una página liberada ya no guarda información: sin rotación, sólo
+    // disipa hacia el polo sur (evaporación). Con la parte reversible
+    // quedaría atrapada en los puntos fijos de sin(2θ)
+    int live = page_is_live(page_idx);
     
     // Parte Hamiltoniana (reversible)
-    double dtheta_ham = (M_PI / 2.0) * sin(2.0 * page->theta) * 
-                        page->O_n / (memmgr.total_pages + 1);
+    double dtheta_ham = live ? (M_PI / 2.0) * dit_sin(2.0 * theta) * 
+                               O_n / (memmgr.page_limit + 1) : 0.0;
     
-    // Parte disipativa (viscosidad del baño)
-    double eta = compute_thermal_viscosity(page->theta);
-    double theta_eq = M_PI; // Equilibrio termodinámico en el ecuador
-    double dtheta_diss = eta * (theta_eq - page->theta) * 0.01; // Amortiguamiento
+    // Parte disipativa (viscosidad del baño): una página viva relaja
+    // hacia el ecuador, una liberada hacia 2π
+    double eta = compute_thermal_viscosity(theta);
+    double theta_eq = live ? M_PI : 2.0 * M_PI;
+    double dtheta_diss = eta * (theta_eq - theta) * 0.01; // Amortiguamiento
     
     // Evolución total
-    page->theta += dtheta_ham + dtheta_diss;
+    theta += dtheta_ham + dtheta_diss;
     
-    // Mantener en [0, 2π]
-    if (page->theta < 0.0) page->theta += 2.0 * M_PI;
-    if (page->theta > 2.0 * M_PI) page->theta -= 2.0 * M_PI;
+    // Mantener en [0, 2π]; una página liberada que cruza 2π se evaporó
+    if (theta < 0.0) theta += 2.0 * M_PI;
+    if (theta > 2.0 * M_PI) theta = live ? theta - 2.0 * M_PI : 2.0 * M_PI;
+    
+    page_store(page_idx, theta, eta);
+}
+
+// ============================================================
+// AGREGADOS INCREMENTALES
+// ============================================================
+
+/*
+ * Las sumas de θ, S, η y ρ sobre las páginas no vacías se corrigen con
+ * el delta de cada página que cambia (evolución, asignación,
+ * evaporación); los observables globales salen de ellas en O(1). Cada
+ * AGGREGATE_RESYNC_UPDATES deltas se recuentan exactamente para que el
+ * error de redondeo de restar y sumar no se acumule.
+ */
+
+static inline void aggregate_add(uint32_t i) {
+    MetripleticPages *pg = &memmgr.pages;
+    if (pg->state[i] == MEM_EMPTY) return;
+    memmgr.sum_theta += pg->theta[i];
+    memmgr.sum_entropy += pg->entropy[i];
+    memmgr.sum_viscosity += pg->viscosity[i];
+    memmgr.sum_rho += pg->rho[i];
+    memmgr.counted_pages++;
+    memmgr.aggregate_updates++;
+}
+
+static inline void aggregate_remove(uint32_t i) {
+    MetripleticPages *pg = &memmgr.pages;
+    if (pg->state[i] == MEM_EMPTY) return;
+    memmgr.sum_theta -= pg->theta[i];
+    memmgr.sum_entropy -= pg->entropy[i];
+    memmgr.sum_viscosity -= pg->viscosity[i];
+    memmgr.sum_rho -= pg->rho[i];
+    memmgr.counted_pages--;
+}
+
+static void aggregate_resync(void) {
+    MetripleticPages *pg = &memmgr.pages;
+    memmgr.sum_theta = 0.0;
+    memmgr.sum_entropy = 0.0;
+    memmgr.sum_viscosity = 0.0;
+    memmgr.sum_rho = 0.0;
+    memmgr.counted_pages = 0;
     
-    // Actualizar estado
-    page->state = project_memory_state(page->O_n, page->theta);
+    for (uint32_t i = page_bitmap_next(&memmgr.held, 0); i != PAGE_NONE;
+         i = page_bitmap_next(&memmgr.held, i + 1)) {
+        memmgr.sum_theta += pg->theta[i];
+        memmgr.sum_entropy += pg->entropy[i];
+        memmgr.sum_viscosity += pg->viscosity[i];
+        memmgr.sum_rho += pg->rho[i];
+        memmgr.counted_pages++;
+    }
+    memmgr.aggregate_updates = 0;
+}
+
+// Centroide, promedios y métrica desde las sumas (O(1))
+static void update_global_observables(void) {
+    if (memmgr.aggregate_updates >= AGGREGATE_RESYNC_UPDATES) {
+        aggregate_resync();
+    } else if (memmgr.counted_pages == 0) {
+        // Sin páginas: las sumas son exactamente cero
+        memmgr.sum_theta = memmgr.sum_entropy = 0.0;
+        memmgr.sum_viscosity = memmgr.sum_rho = 0.0;
+    }
     
-    // Entropía de Bekenstein-Hawking (área ~θ)
-    page->entropy = (fabs(sin(page->theta)) + 0.1) / 4.0;
+    memmgr.centroid_z = compute_centroid_z(memmgr.sum_theta, memmgr.counted_pages);
+    memmgr.global_theta = memmgr.sum_theta;
+    memmgr.total_entropy = memmgr.sum_entropy;
+    memmgr.total_viscosity = memmgr.sum_viscosity;
     
-    // Viscosidad local
-    page->thermal_viscosity = eta;
+    if (memmgr.allocated_pages > 0) {
+        memmgr.global_theta /= memmgr.allocated_pages;
+        memmgr.total_viscosity /= memmgr.allocated_pages;
+    }
+    
+    // Actualizar métrica invertida
+    update_inverted_geometry(memmgr.sum_rho);
+}
+
+// ============================================================
+// PUESTA AL DÍA PEREZOSA
+// ============================================================
+
+/*
+ * Cada página guarda el tick hasta el que su θ está al día
+ * (pages.last_update) y sólo se evoluciona cuando alguien la mira: la
+ * inspección, el refresco de páginas vivas del latido o la rueda de
+ * evaporación. Una página quieta no cuesta nada.
+ * 
+ * La parte disipativa es una relajación lineal hacia θ_eq con factor
+ * (1 - 0.01·η) por tick, así que tras k ticks
+ *     θ_eq - θ = (θ_eq - θ₀) · (1 - 0.01·η)^k
+ * con η(θ) evaluada en el punto medio de cada uno de RELAX_SEGMENTS
+ * tramos (η sube ~50% hacia el ecuador; con 4 tramos el error frente
+ * a pasos exactos queda por debajo de 0.01 rad en 1000 ticks). Una
+ * página liberada sólo disipa: se pone al día en O(1). Una viva da
+ * hasta CATCHUP_MAX_STEPS pasos exactos y el resto del intervalo sólo
+ * relaja; la rotación reversible no tiene forma cerrada en el mapa
+ * discreto y oscila alrededor del equilibrio.
+ */
+
+static inline double relax_factor(double eta, double ticks) {
+    return dit_exp(ticks * dit_log(1.0 - 0.01 * eta));
+}
+
+static double relax_theta(double theta, double theta_eq, uint32_t ticks) {
+    uint32_t segments = (ticks < RELAX_SEGMENTS) ? 1 : RELAX_SEGMENTS;
+    double span = (double)ticks / segments;
+    
+    for (uint32_t s = 0; s < segments; s++) {
+        double gap = theta_eq - theta;
+        double theta_mid = theta_eq - gap * relax_factor(compute_thermal_viscosity(theta), 0.5 * span);
+        theta = theta_eq - gap * relax_factor(compute_thermal_viscosity(theta_mid), span);
+    }
+    return theta;
+}
+
+// Llevar una página no vacía hasta el tick now, con su delta en los
+// agregados. Retorna 1 si evolucionó, 0 si estaba vacía o al día
+static int page_catch_up(uint32_t i, uint32_t now) {
+    MetripleticPages *pg = &memmgr.pages;
+    if (pg->state[i] == MEM_EMPTY) return 0;
+    
+    int32_t ticks = (int32_t)(now - pg->last_update[i]);
+    if (ticks <= 0) return 0;
+    
+    aggregate_remove(i);
+    if (page_is_live(i)) {
+        uint32_t steps = ((uint32_t)ticks < CATCHUP_MAX_STEPS) ? (uint32_t)ticks : CATCHUP_MAX_STEPS;
+        if ((uint32_t)ticks > steps) {
+            double theta = relax_theta(pg->theta[i], M_PI, (uint32_t)ticks - steps);
+            page_store(i, theta, compute_thermal_viscosity(theta));
+        }
+        for (uint32_t s = steps; s > 0; s--) {
+            metripletic_page_evolution(i, now - s + 1);
+        }
+    } else {
+        double theta = relax_theta(pg->theta[i], 2.0 * M_PI, (uint32_t)ticks);
+        page_store(i, theta, compute_thermal_viscosity(theta));
+    }
+    pg->last_update[i] = now;
+    aggregate_add(i);
+    return 1;
+}
+
+// ============================================================
+// RUEDA DE EVAPORACIÓN
+// ============================================================
+
+/*
+ * Una página liberada se evapora cuando θ > 2π - ε. Como su θ tiene
+ * forma cerrada, el tick en que lo cruzará se predice al liberarla y
+ * se agenda en la rueda; al vencer se pone al día y, si aún no llegó
+ * (η cambió por el camino), se vuelve a agendar. Deadlines a más de
+ * EVAP_WHEEL_SLOTS ticks esperan en su slot hasta su vuelta.
+ */
+
+// Ticks hasta que la página liberada i cruce 2π - ε (al menos 1)
+static uint32_t evaporation_ticks(uint32_t i) {
+    double theta = memmgr.pages.theta[i];
+    double gap = 2.0 * M_PI - theta;
+    if (gap <= EVAPORATION_EPSILON) return 1;
+    
+    double eta = compute_thermal_viscosity(theta + 0.5 * gap);
+    double ticks = dit_log(EVAPORATION_EPSILON / gap) / dit_log(1.0 - 0.01 * eta);
+    if (ticks >= 1e9) return 1000000000u;
+    return (uint32_t)ticks + 1;
+}
+
+// Agendar la evaporación de una página liberada y al día
+static void evaporation_arm(uint32_t i) {
+    uint32_t deadline = memmgr.pages.last_update[i] + evaporation_ticks(i);
+    uint32_t slot = deadline & (EVAP_WHEEL_SLOTS - 1);
+    memmgr.wheel_deadline[i] = deadline;
+    memmgr.wheel_next[i] = memmgr.wheel_head[slot];
+    memmgr.wheel_head[slot] = i;
+}
+
+// Página evaporada: fuera de los agregados y de vuelta al buddy, donde
+// se fusiona con las vecinas ya evaporadas
+static void page_reclaim(uint32_t i) {
+    MetripleticPages *pg = &memmgr.pages;
+    aggregate_remove(i);
+    pg->state[i] = MEM_EMPTY;
+    pg->theta[i] = 0.0;
+    page_bitmap_clear(&memmgr.held, i);
+    memmgr.allocated_pages--;
+    buddy_free_block(i, 0);
+    memmgr.compact_dirty = 1;   // Hueco nuevo: la compactación puede aprovecharlo
+}
+
+// Disparar los slots de los ticks (wheel_time, now]
+static void evaporation_wheel_advance(uint32_t now) {
+    uint32_t elapsed = now - memmgr.wheel_time;
+    if ((int32_t)elapsed <= 0) return;
+    if (elapsed > EVAP_WHEEL_SLOTS) elapsed = EVAP_WHEEL_SLOTS;
+    
+    for (uint32_t t = now - elapsed + 1; t != now + 1; t++) {
+        uint32_t *link = &memmgr.wheel_head[t & (EVAP_WHEEL_SLOTS - 1)];
+        while (*link != PAGE_NONE) {
+            uint32_t i = *link;
+            if ((int32_t)(memmgr.wheel_deadline[i] - now) > 0) {
+                link = &memmgr.wheel_next[i];   // Vence en otra vuelta
+                continue;
+            }
+            
+            // Desenlazar; si se reagenda entra por la cabeza de un slot
+            // ya pasado en este recorrido o de uno futuro
+            *link = memmgr.wheel_next[i];
+            page_catch_up(i, now);
+            if (memmgr.pages.theta[i] > 2.0 * M_PI - EVAPORATION_EPSILON) {
+                page_reclaim(i);
+            } else {
+                evaporation_arm(i);
+            }
+        }
+    }
+    memmgr.wheel_time = now;
 }
 
 // ============================================================
 // API PÚBLICA: Asignar memoria
 // ============================================================
 
+// Página entregada con bytes de datos: arranca en el polo norte
+// (θ = PAGE_FRESH_THETA; memory_init calcula su seno y viscosidad)
+static void page_activate(uint32_t i, uint32_t bytes) {
+    MetripleticPages *pg = &memmgr.pages;
+    pg->size[i] = (uint16_t)bytes;
+    pg->theta[i] = PAGE_FRESH_THETA;
+    pg->state[i] = MEM_ALLOCATED;
+    pg->entropy[i] = (memmgr.fresh_sin_theta + 0.1) / 4.0;
+    pg->viscosity[i] = memmgr.fresh_viscosity;
+    pg->rho[i] = (bytes / (double)PAGE_SIZE) * (1.0 + memmgr.fresh_sin_theta);
+    pg->allocation_time[i] = 0;
+    pg->last_update[i] = memmgr.now;
+}
+
 uint32_t memory_allocate(uint32_t size) {
     /*
-     * Buscar página libre (EMPTY) con θ mínima
-     * Asignar en modo MEM_ALLOCATED
-     * Retornar dirección física
+     * Bloque buddy de 2^k páginas EMPTY contiguas que cubre size
+     * Asignar cada página en modo MEM_ALLOCATED con su parte de size
+     * Retornar la dirección física de la primera
+     * 
+     * Con IF=0: el latido evoluciona páginas desde la ISR (memory_sweep)
      */
     
-    if (memmgr.allocated_pages >= MAX_MEMORY_PAGES) {
-        return 0; // Error: sin memoria
-    }
+    uint32_t pages = (size >> PAGE_SHIFT) + ((size & (PAGE_SIZE - 1)) != 0);
+    if (pages == 0) pages = 1;
+    if (pages > memmgr.total_pages) return 0;
     
-    // Búsqueda de página óptima (menor theta = menos acoplamiento)
-    uint32_t best_idx = 0;
-    double min_theta = 2.0 * M_PI + 1.0;
+    uint32_t order = pages_to_order(pages);
+    uint32_t block_pages = 1u << order;
     
-    for (uint32_t i = 0; i < memmgr.total_pages; i++) {
-        if (memmgr.pages[i].state == MEM_EMPTY && 
-            memmgr.pages[i].theta < min_theta) {
-            best_idx = i;
-            min_theta = memmgr.pages[i].theta;
+    uint32_t flags = sched_irq_save();
+    
+    // Presión de memoria: pedir a las cachés que suelten páginas
+    uint32_t free_pages = memmgr.total_pages - memmgr.allocated_pages;
+    if (free_pages < MEMORY_PRESSURE_PAGES + block_pages) {
+        uint32_t wanted = MEMORY_PRESSURE_PAGES + block_pages - free_pages;
+        for (uint32_t r = 0; r < num_reclaimers && wanted > 0; r++) {
+            uint32_t got = reclaimers[r](wanted);
+            wanted = (got >= wanted) ? 0 : wanted - got;
         }
     }
     
-    // Inicializar página
-    memmgr.pages[best_idx].address = MEMORY_BASE + (best_idx * PAGE_SIZE);
-    memmgr.pages[best_idx].size = (size > PAGE_SIZE) ? PAGE_SIZE : size;
-    memmgr.pages[best_idx].theta = 0.1; // Empezar en polo norte
-    memmgr.pages[best_idx].O_n = compute_O_n_for_page(best_idx);
-    memmgr.pages[best_idx].state = MEM_ALLOCATED;
-    memmgr.pages[best_idx].allocation_time = 0;
+    uint32_t head = buddy_alloc_block(order);
+    
+    if (head == PAGE_NONE) {
+        sched_irq_restore(flags);
+        return 0; // Ningún bloque libre del orden pedido (en uso o evaporándose)
+    }
+    
+    bitmap_set(memmgr.head_bitmap, head);
+    
+    // Inicializar páginas: cada una arranca en el polo norte y lleva
+    // los bytes de size que le tocan (las de relleno del bloque, 0)
+    uint32_t remaining = size;
+    
+    for (uint32_t i = head; i < head + block_pages; i++) {
+        uint32_t bytes = (remaining > PAGE_SIZE) ? PAGE_SIZE : remaining;
+        remaining -= bytes;
+        
+        page_bitmap_set(&memmgr.live, i);
+        page_bitmap_set(&memmgr.held, i);
+        page_activate(i, bytes);
+        aggregate_add(i);
+    }
     
-    memmgr.allocated_pages++;
+    memmgr.allocated_pages += block_pages;
+    memmgr.live_pages += block_pages;
+    update_global_observables();
     
-    return memmgr.pages[best_idx].address;
+    sched_irq_restore(flags);
+    return page_address(head);
 }
 
 // ============================================================
@@ -346,17 +894,167 @@ uint32_t memory_allocate(uint32_t size) {
 
 void memory_free(uint32_t address) {
     /*
-     * Buscar página con dirección
-     * Establecer state = MEM_EVAPORATING
+     * Índice desde la dirección; sólo cabezas de bloques entregados
+     * (ignora dobles liberaciones y direcciones ajenas o interiores)
+     * Establecer state = MEM_EVAPORATING en cada página del bloque
      * Permitir que se evapore gradualmente (θ → 2π)
-     * Marcar EMPTY solo cuando θ > 2π - ε
+     * Marcar EMPTY solo cuando θ > 2π - ε: la rueda de evaporación
+     * lo comprueba en el tick previsto, página a página; el buddy
+     * vuelve a fusionar el bloque a medida que se evaporan
      */
     
-    for (uint32_t i = 0; i < memmgr.total_pages; i++) {
-        if (memmgr.pages[i].address == address) {
-            memmgr.pages[i].state = MEM_EVAPORATING;
-            return;
+    uint32_t head = page_index(address);
+    if (head == PAGE_NONE) return;
+    
+    uint32_t flags = sched_irq_save();
+    if (!bitmap_test(memmgr.head_bitmap, head)) {
+        sched_irq_restore(flags);
+        return;
+    }
+    
+    bitmap_clear(memmgr.head_bitmap, head);
+    uint32_t block_pages = 1u << memmgr.block_order[head];
+    
+    for (uint32_t i = head; i < head + block_pages; i++) {
+        // Al día como página viva antes de cambiar de dinámica
+        page_catch_up(i, memmgr.now);
+        
+        page_bitmap_clear(&memmgr.live, i);
+        aggregate_remove(i);
+        memmgr.pages.state[i] = MEM_EVAPORATING;
+        memmgr.pages.last_update[i] = memmgr.now;
+        aggregate_add(i);
+        evaporation_arm(i);
+    }
+    
+    memmgr.live_pages -= block_pages;
+    update_global_observables();
+    sched_irq_restore(flags);
+}
+
+void memory_discard(uint32_t address) {
+    /*
+     * Como memory_free, pero el contenido del bloque se descarta: no
+     * hay información que evaporar, así que sus páginas vuelven al
+     * buddy en el acto. Para los reclamadores, cuyas páginas deben
+     * quedar disponibles para la asignación que los invocó.
+     */
+    
+    uint32_t head = page_index(address);
+    if (head == PAGE_NONE) return;
+    
+    uint32_t flags = sched_irq_save();
+    if (!bitmap_test(memmgr.head_bitmap, head)) {
+        sched_irq_restore(flags);
+        return;
+    }
+    
+    bitmap_clear(memmgr.head_bitmap, head);
+    uint32_t order = memmgr.block_order[head];
+    uint32_t block_pages = 1u << order;
+    
+    for (uint32_t i = head; i < head + block_pages; i++) {
+        aggregate_remove(i);
+        page_bitmap_clear(&memmgr.live, i);
+        page_bitmap_clear(&memmgr.held, i);
+        memmgr.pages.state[i] = MEM_EMPTY;
+        memmgr.pages.theta[i] = 0.0;
+    }
+    
+    memmgr.live_pages -= block_pages;
+    memmgr.allocated_pages -= block_pages;
+    buddy_free_block(head, order);
+    memmgr.compact_dirty = 1;
+    update_global_observables();
+    sched_irq_restore(flags);
+}
+
+// ============================================================
+// API PÚBLICA: Registro de cachés reclamables
+// ============================================================
+
+void memory_register_reclaimer(uint32_t (*reclaim)(uint32_t pages_wanted)) {
+    /*
+     * memory_allocate invoca a cada reclamador, en orden de registro,
+     * cuando las páginas libres caen a MEMORY_PRESSURE_PAGES. Los
+     * reclamadores devuelven sus bloques con memory_discard: con
+     * memory_free las páginas se evaporarían ticks después y la
+     * asignación que los invocó seguiría sin sitio.
+     */
+    
+    if (num_reclaimers >= MAX_RECLAIMERS) return;
+    reclaimers[num_reclaimers++] = reclaim;
+}
+
+// ============================================================
+// API PÚBLICA: Reserva de páginas a cero
+// ============================================================
+
+/*
+ * memory_allocate_zeroed sirve una página desde la reserva en O(1):
+ * sólo reinicia su estado metriplético, sin tocar sus 4KB. El bucle
+ * ocioso la rellena (memory_zero_pool_refill) limpiando con las
+ * interrupciones activas, así que la limpieza no está en el camino de
+ * quien pide. Bajo presión la reserva es el primer reclamador: sus
+ * páginas vuelven al buddy antes que los slabs de las cachés.
+ */
+
+static uint32_t zero_pool_reclaim(uint32_t pages_wanted) {
+    uint32_t flags = sched_irq_save();
+    uint32_t freed = 0;
+    while (memmgr.zero_pool_count > 0 && freed < pages_wanted) {
+        memory_discard(page_address(memmgr.zero_pool[--memmgr.zero_pool_count]));
+        freed++;
+    }
+    sched_irq_restore(flags);
+    return freed;
+}
+
+uint32_t memory_allocate_zeroed(uint32_t size) {
+    if (size <= PAGE_SIZE) {
+        uint32_t flags = sched_irq_save();
+        if (memmgr.zero_pool_count > 0) {
+            uint32_t i = memmgr.zero_pool[--memmgr.zero_pool_count];
+            aggregate_remove(i);
+            page_activate(i, size);
+            aggregate_add(i);
+            memmgr.zero_pool_hits++;
+            update_global_observables();
+            sched_irq_restore(flags);
+            return page_address(i);
         }
+        memmgr.zero_pool_misses++;
+        sched_irq_restore(flags);
+    }
+    
+    uint32_t address = memory_allocate(size);
+    if (address) memset((void *)(uintptr_t)address, 0, size);
+    return address;
+}
+
+void memory_zero_pool_refill(void) {
+    /*
+     * Llenar la reserva hasta ZERO_POOL_PAGES. Sólo con holgura: la
+     * reserva es un reclamador, y pedir bajo presión la vaciaría para
+     * volver a llenarla. Lo llaman los bucles ociosos antes de hlt.
+     */
+    
+    while (memmgr.zero_pool_count < ZERO_POOL_PAGES) {
+        if (memmgr.total_pages - memmgr.allocated_pages <= MEMORY_PRESSURE_PAGES + 1) return;
+        
+        uint32_t address = memory_allocate(PAGE_SIZE);
+        if (!address) return;
+        memset((void *)(uintptr_t)address, 0, PAGE_SIZE);
+        
+        uint32_t flags = sched_irq_save();
+        if (memmgr.zero_pool_count < ZERO_POOL_PAGES) {
+            memmgr.zero_pool[memmgr.zero_pool_count++] = page_index(address);
+            address = 0;
+        }
+        sched_irq_restore(flags);
+        
+        // Otro bucle ocioso la llenó mientras limpiábamos
+        if (address) memory_free(address);
     }
 }
 
@@ -366,48 +1064,351 @@ void memory_free(uint32_t address) {
 
 void memory_timestep(uint32_t global_time) {
     /*
-     * Evolucionar TODAS las páginas metriplécticametne
+     * Poner al día TODAS las páginas hasta global_time
      * Actualizar centroides
      * Actualizar geometría invertida
-     * Chequear evaporación
+     * Disparar las evaporaciones vencidas
+     * 
+     * Cada página aporta su delta a los agregados: el coste es el de
+     * las páginas no vacías, los observables salen en O(1).
+     */
+    
+    uint32_t flags = sched_irq_save();
+    if ((int32_t)(global_time - memmgr.now) > 0) memmgr.now = global_time;
+    for (uint32_t i = page_bitmap_next(&memmgr.held, 0); i != PAGE_NONE;
+         i = page_bitmap_next(&memmgr.held, i + 1)) {
+        page_catch_up(i, memmgr.now);
+    }
+    evaporation_wheel_advance(memmgr.now);
+    
+    update_global_observables();
+    sched_irq_restore(flags);
+}
+
+// ============================================================
+// API PÚBLICA: Barrido incremental con presupuesto
+// ============================================================
+
+static inline uint64_t read_tsc(void) {
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Estimación de coste: sube rápido (1/2) y baja lento (1/8), porque
+// subestimar es lo que desborda el latido
+static inline void cost_estimate_update(uint32_t *est, uint32_t cost) {
+    if (cost > *est) *est += (cost - *est) >> 1;
+    else *est -= (*est - cost) >> 3;
+}
+
+void memory_sweep(uint32_t global_time, uint32_t budget_cycles) {
+    /*
+     * Avanzar el reloj a global_time y disparar las evaporaciones
+     * vencidas. Después, poner al día páginas vivas desde sweep_cursor,
+     * round-robin, hasta agotar budget_cycles o completar una vuelta:
+     * refresca los observables globales sin esperar a una inspección.
+     * Las vacías y las liberadas no se recorren, así que el coste
+     * sigue a la actividad y no al número de páginas.
+     * 
+     * Antes de cada página se comprueba que ella y el cierre
+     * (observables globales) quepan en lo que queda según su coste
+     * estimado; si no, se sigue en el próximo latido. La primera
+     * página siempre avanza para que el barrido progrese con
+     * cualquier presupuesto.
+     * 
+     * Lo llama el latido tras el EOI, con IF=0 y el x87 guardado.
      */
     
-    // Evolucionar cada página
-    for (uint32_t i = 0; i < memmgr.total_pages; i++) {
-        if (memmgr.pages[i].state != MEM_EMPTY) {
-            metripletic_page_evolution(i, global_time);
+    uint64_t start = read_tsc();
+    
+    if ((int32_t)(global_time - memmgr.now) > 0) memmgr.now = global_time;
+    evaporation_wheel_advance(memmgr.now);
+    
+    uint64_t prev = read_tsc();
+    uint32_t elapsed = (uint32_t)(prev - start);
+    uint32_t stepped = 0;
+    
+    while (stepped < memmgr.live_pages) {
+        if (stepped > 0 &&
+            elapsed + memmgr.sweep_page_cost + memmgr.sweep_tail_cost > budget_cycles) break;
+        
+        uint32_t i = page_bitmap_next(&memmgr.live, memmgr.sweep_cursor);
+        if (i == PAGE_NONE) {
+            i = page_bitmap_next(&memmgr.live, 0);
+            memmgr.sweep_laps++;
         }
+        memmgr.sweep_cursor = i + 1;
+        int evolved = page_catch_up(i, memmgr.now);
+        stepped++;
         
-        // Chequear evaporación completa
-        if (memmgr.pages[i].state == MEM_EVAPORATING && 
-            memmgr.pages[i].theta > 2.0 * M_PI - 0.1) {
-            memmgr.pages[i].state = MEM_EMPTY;
-            memmgr.pages[i].theta = 0.0;
-            memmgr.allocated_pages--;
+        uint64_t tsc = read_tsc();
+        // Las ya al día cuestan casi nada: sólo las evolucionadas estiman
+        if (evolved) cost_estimate_update(&memmgr.sweep_page_cost, (uint32_t)(tsc - prev));
+        prev = tsc;
+        elapsed = (uint32_t)(tsc - start);
+    }
+    
+    update_global_observables();
+    
+    uint64_t end = read_tsc();
+    cost_estimate_update(&memmgr.sweep_tail_cost, (uint32_t)(end - prev));
+    elapsed = (uint32_t)(end - start);
+    memmgr.sweep_last_pages = stepped;
+    memmgr.sweep_last_cycles = elapsed;
+    if (elapsed > memmgr.sweep_max_cycles) memmgr.sweep_max_cycles = elapsed;
+    if (elapsed > budget_cycles) memmgr.sweep_overruns++;
+}
+
+// ============================================================
+// API PÚBLICA: Bloques reubicables (manejadores)
+// ============================================================
+
+/*
+ * memory_handle_alloc entrega un manejador (1..MAX_MEMORY_HANDLES, 0 si
+ * falla) en vez de una dirección. Mientras el dueño no lo fije con
+ * memory_handle_lock, la compactación puede mover el bloque; la
+ * dirección sólo vale hasta el memory_handle_unlock correspondiente.
+ * Un bloque de manejador se libera con memory_handle_free, nunca con
+ * memory_free.
+ */
+
+static inline MemoryHandle *handle_get(uint32_t handle) {
+    if (handle == 0 || handle > MAX_MEMORY_HANDLES) return 0;
+    MemoryHandle *mh = &memmgr.handles[handle - 1];
+    return mh->used ? mh : 0;
+}
+
+uint32_t memory_handle_alloc(uint32_t size) {
+    uint32_t flags = sched_irq_save();
+    
+    uint32_t h = 0;
+    while (h < MAX_MEMORY_HANDLES && memmgr.handles[h].used) h++;
+    uint32_t address = (h < MAX_MEMORY_HANDLES) ? memory_allocate(size) : 0;
+    if (!address) {
+        sched_irq_restore(flags);
+        return 0;
+    }
+    
+    MemoryHandle *mh = &memmgr.handles[h];
+    mh->head = page_index(address);
+    mh->order = memmgr.block_order[mh->head];
+    mh->pins = 0;
+    mh->stuck_pass = memmgr.compact_pass - 1;
+    mh->used = 1;
+    
+    sched_irq_restore(flags);
+    return h + 1;
+}
+
+uint32_t memory_handle_lock(uint32_t handle) {
+    uint32_t flags = sched_irq_save();
+    MemoryHandle *mh = handle_get(handle);
+    uint32_t address = 0;
+    if (mh) {
+        mh->pins++;
+        address = page_address(mh->head);
+    }
+    sched_irq_restore(flags);
+    return address;
+}
+
+void memory_handle_unlock(uint32_t handle) {
+    uint32_t flags = sched_irq_save();
+    MemoryHandle *mh = handle_get(handle);
+    if (mh && mh->pins > 0) mh->pins--;
+    sched_irq_restore(flags);
+}
+
+void memory_handle_free(uint32_t handle) {
+    uint32_t flags = sched_irq_save();
+    MemoryHandle *mh = handle_get(handle);
+    if (mh) {
+        memory_free(page_address(mh->head));
+        mh->used = 0;
+    }
+    sched_irq_restore(flags);
+}
+
+// ============================================================
+// API PÚBLICA: Compactación incremental
+// ============================================================
+
+/*
+ * Empaqueta los bloques reubicables hacia el principio de la RAM para
+ * que los huecos se fusionen en bloques grandes. Cada paso toma el
+ * bloque sin fijar de menor θ (el más frío: aún coherente, no ha
+ * empezado a disipar; a igual θ, el más alto) y lo baja al hueco libre
+ * más ajustado por debajo de él, sólo si al liberar su sitio se forma
+ * un bloque libre mayor que el hueco gastado: cada movimiento mejora
+ * la fragmentación. Los datos se copian y el estado metriplético viaja
+ * con ellos: la información se traslada, así que el origen vuelve al
+ * buddy sin evaporarse.
+ *
+ * Un bloque sin destino queda marcado en la pasada; la pasada termina
+ * cuando no quedan candidatos, y sólo empieza otra si desde entonces
+ * volvieron páginas al buddy (o la pasada movió algo). Cada movimiento
+ * se hace con IF=0 y el siguiente sólo si cabe en budget_cycles según
+ * el coste estimado por página.
+ */
+
+// Manejador a mover en esta pasada, o MAX_MEMORY_HANDLES
+static uint32_t compact_pick(void) {
+    uint32_t best = MAX_MEMORY_HANDLES;
+    for (uint32_t h = 0; h < MAX_MEMORY_HANDLES; h++) {
+        const MemoryHandle *mh = &memmgr.handles[h];
+        if (!mh->used || mh->pins || mh->order > COMPACT_MAX_ORDER ||
+            mh->stuck_pass == memmgr.compact_pass) continue;
+        if (best == MAX_MEMORY_HANDLES) {
+            best = h;
+            continue;
         }
+        double theta = memmgr.pages.theta[mh->head];
+        double best_theta = memmgr.pages.theta[memmgr.handles[best].head];
+        if (theta < best_theta || (theta == best_theta && mh->head > memmgr.handles[best].head)) best = h;
+    }
+    return best;
+}
+
+// Orden del bloque libre que formaría el bloque head de 2^order
+// páginas al volver al buddy (sin tocar las listas)
+static uint32_t buddy_merge_order(uint32_t head, uint32_t order) {
+    while (order < BUDDY_MAX_ORDER) {
+        uint32_t buddy = head ^ (1u << order);
+        if (buddy >= memmgr.page_limit ||
+            !bitmap_test(memmgr.free_blocks.words, buddy) ||
+            memmgr.block_order[buddy] != order) break;
+        head &= buddy;
+        order++;
+    }
+    return order;
+}
+
+// Destino del bloque src de 2^order páginas: la cabeza libre más baja
+// del menor orden ≥ order por debajo de src, fuera de la región en que
+// src se fusionaría y de orden menor que el de esa fusión (se gasta un
+// bloque libre menor que el que se crea). Examina hasta
+// COMPACT_SCAN_LIMIT cabezas; PAGE_NONE si ninguna sirve
+static uint32_t compact_destination(uint32_t src, uint32_t order) {
+    uint32_t merge = buddy_merge_order(src, order);
+    if (merge == order) return PAGE_NONE;   // Liberarlo no fusiona nada
+    
+    uint32_t best = PAGE_NONE;
+    uint32_t i = page_bitmap_next(&memmgr.free_blocks, 0);
+    for (uint32_t n = 0; i != PAGE_NONE && i < src && n < COMPACT_SCAN_LIMIT; n++) {
+        uint32_t k = memmgr.block_order[i];
+        if (k >= order && k < merge && (i >> merge) != (src >> merge) &&
+            (best == PAGE_NONE || k < memmgr.block_order[best])) {
+            best = i;
+            if (k == order) break;
+        }
+        i = page_bitmap_next(&memmgr.free_blocks, i + (1u << k));
+    }
+    return best;
+}
+
+// Mover el bloque de mh a la cabeza libre dest (con IF=0)
+static void compact_move(MemoryHandle *mh, uint32_t dest) {
+    MetripleticPages *pg = &memmgr.pages;
+    uint32_t src = mh->head;
+    uint32_t pages = 1u << mh->order;
+    
+    buddy_take_block(dest, mh->order);
+    memcpy((void *)(uintptr_t)page_address(dest), (const void *)(uintptr_t)page_address(src),
+           pages << PAGE_SHIFT);
+    
+    for (uint32_t p = 0; p < pages; p++) {
+        uint32_t s = src + p;
+        uint32_t t = dest + p;
+        page_catch_up(s, memmgr.now);
+        aggregate_remove(s);
+        
+        pg->theta[t] = pg->theta[s];
+        pg->entropy[t] = pg->entropy[s];
+        pg->viscosity[t] = pg->viscosity[s];
+        pg->rho[t] = pg->rho[s];
+        pg->state[t] = pg->state[s];
+        pg->size[t] = pg->size[s];
+        pg->allocation_time[t] = pg->allocation_time[s];
+        pg->last_update[t] = pg->last_update[s];
+        page_bitmap_set(&memmgr.live, t);
+        page_bitmap_set(&memmgr.held, t);
+        aggregate_add(t);
+        
+        page_bitmap_clear(&memmgr.live, s);
+        page_bitmap_clear(&memmgr.held, s);
+        pg->state[s] = MEM_EMPTY;
+        pg->theta[s] = 0.0;
     }
     
-    // Actualizar observables globales
-    memmgr.centroid_z = compute_centroid_z();
-    memmgr.global_theta = 0.0;
-    memmgr.total_entropy = 0.0;
-    memmgr.total_viscosity = 0.0;
+    bitmap_clear(memmgr.head_bitmap, src);
+    bitmap_set(memmgr.head_bitmap, dest);
+    buddy_free_block(src, mh->order);
+    mh->head = dest;
     
-    for (uint32_t i = 0; i < memmgr.total_pages; i++) {
-        if (memmgr.pages[i].state != MEM_EMPTY) {
-            memmgr.global_theta += memmgr.pages[i].theta;
-            memmgr.total_entropy += memmgr.pages[i].entropy;
-            memmgr.total_viscosity += memmgr.pages[i].thermal_viscosity;
+    memmgr.compact_moves++;
+    memmgr.compact_pages += pages;
+}
+
+void memory_compact(uint32_t budget_cycles) {
+    /*
+     * Avanzar la pasada de compactación hasta agotar budget_cycles.
+     * Lo llaman los bucles ociosos con IF=1: entre movimiento y
+     * movimiento las interrupciones quedan abiertas.
+     */
+    
+    uint64_t start = read_tsc();
+    uint32_t flags = sched_irq_save();
+    if (!memmgr.compact_active) {
+        if (!memmgr.compact_dirty) {
+            sched_irq_restore(flags);
+            return;
         }
+        memmgr.compact_dirty = 0;
+        memmgr.compact_active = 1;
+        memmgr.compact_pass++;
     }
+    sched_irq_restore(flags);
     
-    if (memmgr.allocated_pages > 0) {
-        memmgr.global_theta /= memmgr.allocated_pages;
-        memmgr.total_viscosity /= memmgr.allocated_pages;
+    uint32_t elapsed = 0;
+    uint32_t moved = 0;
+    while (elapsed < budget_cycles) {
+        flags = sched_irq_save();
+        
+        uint32_t h = compact_pick();
+        if (h == MAX_MEMORY_HANDLES) {
+            memmgr.compact_active = 0;  // Pasada terminada
+            sched_irq_restore(flags);
+            break;
+        }
+        
+        MemoryHandle *mh = &memmgr.handles[h];
+        uint32_t pages = 1u << mh->order;
+        if (moved > 0 && elapsed + pages * memmgr.compact_page_cost > budget_cycles) {
+            sched_irq_restore(flags);
+            break;
+        }
+        
+        uint32_t dest = compact_destination(mh->head, mh->order);
+        if (dest == PAGE_NONE) {
+            mh->stuck_pass = memmgr.compact_pass;
+        } else {
+            uint64_t t0 = read_tsc();
+            compact_move(mh, dest);
+            cost_estimate_update(&memmgr.compact_page_cost, (uint32_t)(read_tsc() - t0) / pages);
+            memmgr.compact_dirty = 1;   // Lo movido deja huecos: otra pasada
+            moved++;
+        }
+        
+        sched_irq_restore(flags);
+        elapsed = (uint32_t)(read_tsc() - start);
     }
     
-    // Actualizar métrica invertida
-    update_inverted_geometry();
+    if (moved > 0) {
+        flags = sched_irq_save();
+        update_global_observables();
+        sched_irq_restore(flags);
+    }
 }
 
 // ============================================================
@@ -425,45 +1426,303 @@ void memory_print_diagnostics(void) {
 
 extern "C" {
     void check_thermal_page_impl(uint32_t address, double threshold, double *out_entropy, int *out_critical) {
-        for (uint32_t i = 0; i < memmgr.total_pages; i++) {
-            if (memmgr.pages[i].address == address) {
-                *out_entropy = memmgr.pages[i].theta / (2.0 * M_PI); // Entropía normalizada [0, 1]
-                *out_critical = (memmgr.pages[i].theta > threshold * 2.0 * M_PI);
-                return;
-            }
+        uint32_t i = page_index(address);
+        if (i == PAGE_NONE) {
+            *out_entropy = 0.0;
+            *out_critical = 0;
+            return;
+        }
+        // Un bloque entregado se juzga por la θ media de sus páginas
+        uint32_t flags = sched_irq_save();
+        uint32_t count = bitmap_test(memmgr.head_bitmap, i) ? 1u << memmgr.block_order[i] : 1;
+        double theta = 0.0;
+        for (uint32_t p = i; p < i + count; p++) {
+            page_catch_up(p, memmgr.now);
+            theta += memmgr.pages.theta[p];
         }
-        *out_entropy = 0.0;
-        *out_critical = 0;
+        sched_irq_restore(flags);
+        theta /= count;
+        *out_entropy = theta / (2.0 * M_PI); // Entropía normalizada [0, 1]
+        *out_critical = (theta > threshold * 2.0 * M_PI);
     }
 
     uint32_t memory_get_used_pages(void) { return memmgr.allocated_pages; }
     uint32_t memory_get_total_pages(void) { return memmgr.total_pages; }
+    uint32_t memory_get_e820_entries(void) { return memmgr.e820_entries; }
+    uint32_t memory_get_top_address(void) { return page_address(memmgr.page_limit); }
+
+    // Fragmentación del buddy: páginas libres, mayor tramo libre contiguo
+    // (bloques libres adyacentes), mayor bloque e histograma de tramos
+    // (cubeta b: 2^b..2^(b+1)-1 páginas; la última acumula los mayores)
+    void memory_get_fragmentation(uint32_t *free_pages, uint32_t *largest_run, uint32_t *largest_block,
+                                  uint32_t *histogram, uint32_t buckets) {
+        for (uint32_t b = 0; b < buckets; b++) histogram[b] = 0;
+        uint32_t total = 0, largest = 0, run = 0, run_end = PAGE_NONE;
+        
+        uint32_t flags = sched_irq_save();
+        uint32_t i = page_bitmap_next(&memmgr.free_blocks, 0);
+        while (1) {
+            if (run > 0 && i != run_end) {
+                uint32_t b = 31 - (uint32_t)__builtin_clz(run);
+                if (buckets > 0) histogram[(b < buckets) ? b : buckets - 1]++;
+                if (run > largest) largest = run;
+                run = 0;
+            }
+            if (i == PAGE_NONE) break;
+            
+            uint32_t pages = 1u << memmgr.block_order[i];
+            run += pages;
+            total += pages;
+            run_end = i + pages;
+            i = page_bitmap_next(&memmgr.free_blocks, run_end);
+        }
+        uint32_t orders = memmgr.free_orders;
+        sched_irq_restore(flags);
+        
+        *free_pages = total;
+        *largest_run = largest;
+        *largest_block = orders ? 1u << (31 - __builtin_clz(orders)) : 0;
+    }
+
+    // Compactación: pasadas, bloques y páginas movidos, manejadores en uso
+    void memory_get_compact_stats(uint32_t *passes, uint32_t *moves, uint32_t *pages, uint32_t *handles) {
+        uint32_t flags = sched_irq_save();
+        *passes = memmgr.compact_pass;
+        *moves = memmgr.compact_moves;
+        *pages = memmgr.compact_pages;
+        *handles = 0;
+        for (uint32_t h = 0; h < MAX_MEMORY_HANDLES; h++) {
+            if (memmgr.handles[h].used) (*handles)++;
+        }
+        sched_irq_restore(flags);
+    }
+
+    // Reserva de páginas a cero: ocupación y aciertos/fallos de memory_allocate_zeroed
+    void memory_get_zero_pool_stats(uint32_t *count, uint32_t *hits, uint32_t *misses) {
+        uint32_t flags = sched_irq_save();
+        *count = memmgr.zero_pool_count;
+        *hits = memmgr.zero_pool_hits;
+        *misses = memmgr.zero_pool_misses;
+        sched_irq_restore(flags);
+    }
     double memory_get_centroid_z(void) { return memmgr.centroid_z; }
     double memory_get_total_entropy(void) { return memmgr.total_entropy; }
 
+    // Progreso del barrido incremental y desbordes de presupuesto
+    void memory_get_sweep_stats(uint32_t *cursor, uint32_t *laps, uint32_t *last_pages,
+                                uint32_t *max_cycles, uint32_t *overruns) {
+        uint32_t flags = sched_irq_save();
+        *cursor = memmgr.sweep_cursor;
+        *laps = memmgr.sweep_laps;
+        *last_pages = memmgr.sweep_last_pages;
+        *max_cycles = memmgr.sweep_max_cycles;
+        *overruns = memmgr.sweep_overruns;
+        sched_irq_restore(flags);
+    }
+
     int memory_get_page_stats(uint32_t idx, uint32_t *addr, double *theta, int *state) {
-        if (idx >= memmgr.total_pages) return 0;
-        *addr = memmgr.pages[idx].address;
-        *theta = memmgr.pages[idx].theta;
-        *state = (int)memmgr.pages[idx].state;
+        if (idx >= memmgr.page_limit) return 0;
+        uint32_t flags = sched_irq_save();
+        page_catch_up(idx, memmgr.now);
+        sched_irq_restore(flags);
+        *addr = page_address(idx);
+        *theta = memmgr.pages.theta[idx];
+        *state = (int)memmgr.pages.state[idx];
         return 1;
     }
 }
 
 // ============================================================
-// INICIALIZACIÓN
+// INICIALIZACIÓN: Mapa E820 y metadatos proporcionales a la RAM
 // ============================================================
 
+/*
+ * La RAM gestionada sale del mapa E820 que deja stage2: regiones de
+ * tipo 1 sobre MEMORY_BASE y bajo PAGING_IDENTITY_LIMIT (encima está la
+ * ventana de arenas de la paginación), recortadas a páginas enteras.
+ * El índice de página va de MEMORY_BASE al final de la región más
+ * alta (page_limit); los huecos entre regiones sólo cuestan sus
+ * metadatos. Los arrays por página (~72 bytes por página, ~1.8% de la
+ * RAM) se toman del final de la región utilizable más grande. Una
+ * página entra en el buddy si está en una región utilizable y no la
+ * pisa ninguna región de otro tipo ni los metadatos.
+ */
+
+// Páginas [first, end) en índices del gestor
+typedef struct {
+    uint32_t first;
+    uint32_t end;
+} PageRange;
+
+// Índices de la entrada recortados a [MEMORY_BASE, PAGING_IDENTITY_LIMIT): hacia dentro
+// (inward) para las utilizables, hacia fuera para las reservadas.
+// Retorna 0 si no queda ninguna página
+static int e820_page_range(const E820Entry *entry, int inward, PageRange *out) {
+    uint64_t first = inward ? (entry->base + PAGE_SIZE - 1) >> PAGE_SHIFT : entry->base >> PAGE_SHIFT;
+    uint64_t end = inward ? (entry->base + entry->length) >> PAGE_SHIFT
+                          : (entry->base + entry->length + PAGE_SIZE - 1) >> PAGE_SHIFT;
+    uint64_t floor = MEMORY_BASE >> PAGE_SHIFT;
+    
+    if (first < floor) first = floor;
+    if (end > floor + MEMORY_LIMIT_PAGES) end = floor + MEMORY_LIMIT_PAGES;
+    if (first >= end) return 0;
+    
+    out->first = (uint32_t)(first - floor);
+    out->end = (uint32_t)(end - floor);
+    return 1;
+}
+
+// Mapa de stage2, o NULL si la BIOS no dio ninguno
+static const E820Map *e820_map(void) {
+    const E820Map *map = (const E820Map *)(uintptr_t)E820_MAP_ADDR;
+    if (map->magic != E820_MAGIC || map->count == 0 || map->count > E820_MAX_ENTRIES) return 0;
+    return map;
+}
+
+static inline int e820_entry_usable(const E820Entry *entry) {
+    return entry->type == E820_TYPE_USABLE && (entry->acpi & E820_ACPI_VALID);
+}
+
+static void *metadata_carve(uint32_t *at, uint32_t bytes) {
+    uint32_t ptr = (*at + 7) & ~7u;
+    *at = ptr + bytes;
+    return (void *)(uintptr_t)ptr;
+}
+
+// Repartir los arrays de pages páginas desde base; retorna los bytes
+// ocupados. Con base 0 sólo mide
+static uint32_t metadata_layout(uint32_t base, uint32_t pages) {
+    MetripleticPages *pg = &memmgr.pages;
+    uint32_t words = (pages + 31) >> 5;
+    uint32_t summary_words = (words + 31) >> 5;
+    uint32_t at = base;
+    
+    pg->theta = (double *)metadata_carve(&at, pages * sizeof(double));
+    pg->O_n = (double *)metadata_carve(&at, pages * sizeof(double));
+    pg->entropy = (double *)metadata_carve(&at, pages * sizeof(double));
+    pg->viscosity = (double *)metadata_carve(&at, pages * sizeof(double));
+    pg->rho = (double *)metadata_carve(&at, pages * sizeof(double));
+    pg->allocation_time = (uint32_t *)metadata_carve(&at, pages * sizeof(uint32_t));
+    pg->last_update = (uint32_t *)metadata_carve(&at, pages * sizeof(uint32_t));
+    pg->size = (uint16_t *)metadata_carve(&at, pages * sizeof(uint16_t));
+    pg->state = (uint8_t *)metadata_carve(&at, pages);
+    
+    memmgr.buddy_next = (uint32_t *)metadata_carve(&at, pages * sizeof(uint32_t));
+    memmgr.buddy_prev = (uint32_t *)metadata_carve(&at, pages * sizeof(uint32_t));
+    memmgr.wheel_next = (uint32_t *)metadata_carve(&at, pages * sizeof(uint32_t));
+    memmgr.wheel_deadline = (uint32_t *)metadata_carve(&at, pages * sizeof(uint32_t));
+    memmgr.block_order = (uint8_t *)metadata_carve(&at, pages);
+    
+    memmgr.free_blocks.words = (uint32_t *)metadata_carve(&at, words * sizeof(uint32_t));
+    memmgr.free_blocks.summary = (uint32_t *)metadata_carve(&at, summary_words * sizeof(uint32_t));
+    memmgr.head_bitmap = (uint32_t *)metadata_carve(&at, words * sizeof(uint32_t));
+    memmgr.live.words = (uint32_t *)metadata_carve(&at, words * sizeof(uint32_t));
+    memmgr.live.summary = (uint32_t *)metadata_carve(&at, summary_words * sizeof(uint32_t));
+    memmgr.held.words = (uint32_t *)metadata_carve(&at, words * sizeof(uint32_t));
+    memmgr.held.summary = (uint32_t *)metadata_carve(&at, summary_words * sizeof(uint32_t));
+    
+    return at - base;
+}
+
+// Páginas [first, end) al buddy: los mayores bloques alineados que caben
+static void buddy_add_range(uint32_t first, uint32_t end) {
+    memmgr.total_pages += end - first;
+    while (first < end) {
+        uint32_t order = BUDDY_MAX_ORDER;
+        while ((first & ((1u << order) - 1)) || first + (1u << order) > end) order--;
+        buddy_list_insert(first, order);
+        first += 1u << order;
+    }
+}
+
+// page_limit según las regiones y la mayor de ellas (*largest), con
+// las páginas de metadatos que necesita. Retorna 0 si no caben en ella
+static int metadata_plan(const PageRange *usable, uint32_t count, uint32_t *largest, uint32_t *meta_pages) {
+    memmgr.page_limit = 0;
+    *largest = 0;
+    if (count == 0) return 0;
+    for (uint32_t r = 0; r < count; r++) {
+        if (usable[r].end > memmgr.page_limit) memmgr.page_limit = usable[r].end;
+        if (usable[r].end - usable[r].first > usable[*largest].end - usable[*largest].first) *largest = r;
+    }
+    *meta_pages = (metadata_layout(0, memmgr.page_limit) + PAGE_SIZE - 1) >> PAGE_SHIFT;
+    return usable[*largest].end - usable[*largest].first > *meta_pages;
+}
+
+static inline void bitmap_fill(uint32_t *map, uint32_t first, uint32_t end, int value) {
+    for (uint32_t i = first; i < end; i++) {
+        if (value) bitmap_set(map, i);
+        else bitmap_clear(map, i);
+    }
+}
+
 void memory_init(void) {
     memset(&memmgr, 0, sizeof(MemoryManager));
-    memmgr.total_pages = MAX_MEMORY_PAGES;
-    memmgr.allocated_pages = 0;
     
-    // Inicializar páginas en estado vacío (polo norte)
-    for (uint32_t i = 0; i < MAX_MEMORY_PAGES; i++) {
-        memmgr.pages[i].address = MEMORY_BASE + (i * PAGE_SIZE);
-        memmgr.pages[i].theta = 0.0;
-        memmgr.pages[i].state = MEM_EMPTY;
-        memmgr.pages[i].O_n = 0.0;
+    // Regiones utilizables; sin mapa, el megabyte sobre MEMORY_BASE
+    const E820Map *map = e820_map();
+    PageRange usable[E820_MAX_ENTRIES];
+    uint32_t count = 0;
+    if (map) {
+        for (uint32_t e = 0; e < map->count; e++) {
+            if (e820_entry_usable(&map->entries[e]) &&
+                e820_page_range(&map->entries[e], 1, &usable[count])) count++;
+        }
+    }
+    
+    // Metadatos al final de la región mayor (si no caben, por defecto)
+    uint32_t largest, meta_pages;
+    if (!metadata_plan(usable, count, &largest, &meta_pages)) {
+        map = 0;
+        count = 1;
+        usable[0].first = 0;
+        usable[0].end = MEMORY_DEFAULT_PAGES;
+        metadata_plan(usable, count, &largest, &meta_pages);
     }
+    memmgr.e820_entries = map ? map->count : 0;
+    
+    uint32_t meta_first = usable[largest].end - meta_pages;
+    uint32_t meta_bytes = metadata_layout(page_address(meta_first), memmgr.page_limit);
+    memset(memmgr.pages.theta, 0, meta_bytes);  // θ = 0, MEM_EMPTY
+    memmgr.metadata_pages = meta_pages;
+    
+    page_operator_table_resize(memmgr.page_limit);
+    
+    // Páginas libres: utilizables menos otras regiones y metadatos,
+    // marcadas en live.words (vacío hasta la primera asignación)
+    uint32_t *scratch = memmgr.live.words;
+    for (uint32_t r = 0; r < count; r++) {
+        bitmap_fill(scratch, usable[r].first, usable[r].end, 1);
+    }
+    for (uint32_t e = 0; map && e < map->count; e++) {
+        PageRange hole;
+        if (!e820_entry_usable(&map->entries[e]) &&
+            e820_page_range(&map->entries[e], 0, &hole)) bitmap_fill(scratch, hole.first, hole.end, 0);
+    }
+    bitmap_fill(scratch, meta_first, meta_first + meta_pages, 0);
+    
+    for (uint32_t k = 0; k < BUDDY_ORDERS; k++) {
+        memmgr.order_head[k] = PAGE_NONE;
+    }
+    for (uint32_t i = 0; i < memmgr.page_limit; ) {
+        if (!bitmap_test(scratch, i)) {
+            i++;
+            continue;
+        }
+        uint32_t end = i;
+        while (end < memmgr.page_limit && bitmap_test(scratch, end)) end++;
+        buddy_add_range(i, end);
+        i = end;
+    }
+    memset(scratch, 0, ((memmgr.page_limit + 31) >> 5) * sizeof(uint32_t));
+    
+    for (uint32_t s = 0; s < EVAP_WHEEL_SLOTS; s++) {
+        memmgr.wheel_head[s] = PAGE_NONE;
+    }
+    
+    memmgr.fresh_sin_theta = dit_sin(PAGE_FRESH_THETA);
+    memmgr.fresh_viscosity = compute_thermal_viscosity(PAGE_FRESH_THETA);
+    
+    // La reserva a cero cede sus páginas antes que las cachés
+    memory_register_reclaimer(zero_pool_reclaim);
 }
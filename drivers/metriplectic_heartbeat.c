@@ -1,11 +1,17 @@
 #include "metriplectic_heartbeat.h"
 #include "../kernel/golden_operator.h"
 #include "../kernel/idt.h"
+#include "../kernel/sched.h"
 #include "../drivers/bayesian_serial.h"
 
 static volatile uint32_t global_ticks = 0;
 extern GoldenState current_golden_state;
-extern GoldenObservables current_golden_obs;
+
+/* Barrido incremental del gestor de memoria (MemoryManager.cpp) */
+extern void memory_sweep(uint32_t global_time, uint32_t budget_cycles);
+
+/* x87 de la tarea interrumpida mientras corre el barrido */
+static uint8_t deferred_fpu[SCHED_FPU_STATE_SIZE];
 
 /* Envía un comando al PIT */
 static void pit_send_command(uint8_t cmd) {
@@ -23,16 +29,25 @@ void metriplectic_heartbeat_handler(void) {
     
     /* Avanzar el operador áureo en cada tick (1ms) */
     /* Nota: Esto desacopla la física de la velocidad de ejecución del shell */
+    /* Los observables no se tocan aquí: se calculan al consultarlos */
     golden_operator_step(&current_golden_state);
-    golden_operator_compute_observables(&current_golden_state, &current_golden_obs);
     
-    /* Mostrar un log cada 1000 ticks (1 segundo) por serial */
-    if (global_ticks % 1000 == 0) {
-        bayesian_serial_write("[HEARTBEAT] 1 second elapsed. O_n: ");
-        /* Aquí podríamos imprimir O_n si tuviéramos float to string, 
-           pero por ahora solo marcamos el paso del tiempo */
-        bayesian_serial_write("OK\n");
-    }
+    /* Rodajas, despertares y CPU por tarea; el log por serial
+     * de cada segundo lo escribe la tarea de telemetría */
+    sched_tick();
+}
+
+/*
+ * Trabajo diferido del latido, tras el EOI y con IF=0: evoluciona
+ * páginas de memoria round-robin sin pasar del presupuesto de ciclos,
+ * así la latencia añadida a IRQ0 está acotada. La dinámica de páginas
+ * usa x87 y la tarea interrumpida puede estar a mitad de una cuenta:
+ * su estado se guarda y se restaura alrededor del barrido.
+ */
+void metriplectic_heartbeat_deferred(void) {
+    __asm__ __volatile__("fnsave %0" : "=m"(deferred_fpu));
+    memory_sweep(global_ticks, HEARTBEAT_MEMORY_BUDGET_CYCLES);
+    __asm__ __volatile__("frstor %0" : : "m"(deferred_fpu));
 }
 
 void metriplectic_heartbeat_init(void) {
@@ -55,9 +70,6 @@ uint32_t metriplectic_heartbeat_get_ticks(void) {
 }
 
 void metriplectic_heartbeat_wait(uint32_t ticks) {
-    uint32_t start_ticks = global_ticks;
-    while ((global_ticks - start_ticks) < ticks) {
-        /* Busy wait pero basado en hardware ticks */
-        __asm__ __volatile__ ("pause");
-    }
+    /* Duerme el hilo; espera activa si el scheduler no arrancó */
+    sched_sleep(ticks);
 }
@@ -13,6 +13,9 @@
 /* Frecuencia deseada para el latido metriplético (1000 Hz = 1ms) */
 #define HEARTBEAT_HZ 1000
 
+/* Presupuesto por latido para evolucionar páginas de memoria (ciclos TSC) */
+#define HEARTBEAT_MEMORY_BUDGET_CYCLES 50000
+
 /* Estructura de estadísticas del latido */
 typedef struct {
     uint32_t total_ticks;
@@ -4,6 +4,7 @@
  */
 
 #include "metriplectic_kbd.h"
+#include "../kernel/sched.h"
 
 /* Funciones de puerto E/S */
 static inline uint8_t inb(uint16_t port) {
@@ -39,7 +40,9 @@ int metriplectic_kbd_has_key(void) {
 }
 
 char metriplectic_kbd_getc(void) {
+    /* Polling: sin tecla, el resto de la rodaja es para otros hilos */
     while (!metriplectic_kbd_has_key()) {
+        sched_yield();
         __asm__ __volatile__("pause");
     }
     
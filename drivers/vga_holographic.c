@@ -8,6 +8,7 @@
  */
 
 #include "vga_holographic.h"
+#include "../kernel/sched.h"
 
 /* Estado global del driver */
 static uint16_t *vga_buffer = (uint16_t *)VGA_MEMORY;
@@ -83,6 +84,9 @@ void vga_holographic_scroll(void) {
  * ============================================================ */
 
 void vga_holographic_write_char(char c) {
+    /* Varios hilos escriben: fila y columna se actualizan sin expropiación */
+    uint32_t flags = sched_irq_save();
+
     if (c == '\n') {
         vga_col = 0;
         vga_row++;
@@ -106,6 +110,8 @@ void vga_holographic_write_char(char c) {
     if (vga_row >= VGA_HEIGHT) {
         vga_holographic_scroll();
     }
+
+    sched_irq_restore(flags);
 }
 
 void vga_holographic_write(const char *str) {
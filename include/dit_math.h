@@ -0,0 +1,117 @@
+#ifndef DIT_MATH_H
+#define DIT_MATH_H
+
+/**
+ * dit_math.h
+ * Freestanding math library for Smopsys (no libm, no libgcc helpers).
+ *
+ * Three numeric forms share one set of algorithms:
+ *
+ *   double   dit_sin ... dit_atan2            "accurate" tier
+ *            dit_sin_fast ... dit_atan2_fast  "fast" tier
+ *   float    dit_sinf ... dit_atan2f          fast double kernels, rounded
+ *   Q16.16   dit_sin_q16 ... dit_atan2_q16    integer only (ISR-safe, no FPU)
+ *
+ * Accuracy and cost (errors measured against glibc libm over the sweeps
+ * in tests/test_dit_math.c; cycles are what `make bench`
+ * (tests/bench_dit_math.c) reports on an x86-64 host at -O2, a budget
+ * rather than a guarantee):
+ *
+ *   function   accurate          fast                  float     Q16.16
+ *   sin/cos    <= 1 ulp,  ~30 cy  <= 2e-9 abs,   ~25 cy  <= 1 ulp  <= 1 LSB
+ *   exp        <= 1 ulp,  ~30 cy  <= 3e-10 rel,  ~20 cy  <= 1 ulp  <= 1 LSB + 2^-15 rel
+ *   log        <= 2 ulp,  ~30 cy  <= 1e-10 rel,  ~23 cy  <= 1 ulp  <= 2 LSB
+ *   sqrt       <= 1 ulp,  ~23 cy  <= 4e-11 rel,  ~19 cy  <= 1 ulp  <= 0.5 LSB
+ *   rsqrt      <= 3 ulp,  ~21 cy  <= 4e-11 rel,  ~18 cy  <= 1 ulp  <= 1 LSB + 2^-15 rel
+ *   atan2      <= 4 ulp, ~110 cy  <= 1e-10 abs,  ~50 cy  <= 1 ulp  <= 1 LSB
+ *
+ * sin/cos are <= 1 ulp for |x| < 100 and <= 2 ulp up to |x| = 1e6.
+ *
+ * Range reduction: sin/cos use a three-part Cody-Waite PI/2 and are
+ * accurate for |x| < 2^20 * PI/2; up to 2^52 the result stays bounded but
+ * loses accuracy, and beyond that (or for inf/NaN) it is NaN. exp reduces
+ * by ln2 (two-part) and scales through the IEEE exponent; log splits the
+ * exponent and works on f = (m - 1) / (m + 1), m in [sqrt(1/2), sqrt(2)).
+ * sqrt/rsqrt start from the bit-trick guess 0x5FE6EB50C7B537A9 - (bits >> 1)
+ * and refine with Newton steps; atan2 folds to [0, tan(PI/8)] by symmetry.
+ */
+
+#include <stdint.h>
+#include "dit_math_fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline double dit_fabs(double x) {
+    return x < 0.0 ? -x : x;
+}
+
+// --- Double, accurate tier ---
+double dit_sin(double x);
+double dit_cos(double x);
+double dit_exp(double x);
+double dit_log(double x);
+double dit_sqrt(double x);
+double dit_rsqrt(double x);
+double dit_atan2(double y, double x);
+
+// --- Double, fast tier ---
+double dit_sin_fast(double x);
+double dit_cos_fast(double x);
+double dit_exp_fast(double x);
+double dit_log_fast(double x);
+double dit_sqrt_fast(double x);
+double dit_rsqrt_fast(double x);
+double dit_atan2_fast(double y, double x);
+
+// --- Float ---
+float dit_sinf(float x);
+float dit_cosf(float x);
+float dit_expf(float x);
+float dit_logf(float x);
+float dit_sqrtf(float x);
+float dit_rsqrtf(float x);
+float dit_atan2f(float y, float x);
+
+// --- Q16.16 (integer arithmetic only) ---
+// Always Q16.16, independent of the kernel's DIT_FP_FORMAT.
+
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE   (1 << Q16_SHIFT)
+
+static inline dit_angle_t dit_angle_from_q16(q16_t x) {
+    return (dit_angle_t)(((int64_t)x * DIT_RAD_TO_ANGLE) >> Q16_SHIFT);
+}
+
+/** Table-driven, constant time (see dit_math_fixed.h). */
+static inline q16_t dit_sin_q16(q16_t x) {
+    return (dit_sin_angle_q30(dit_angle_from_q16(x)) + (1 << 13)) >> 14;
+}
+
+static inline q16_t dit_cos_q16(q16_t x) {
+    return (dit_sin_angle_q30(dit_angle_from_q16(x) + DIT_ANGLE_QUARTER) + (1 << 13)) >> 14;
+}
+
+/** e^x, saturating to INT32_MAX for x > ln(32768). */
+q16_t dit_exp_q16(q16_t x);
+
+/** ln(x) for x > 0; INT32_MIN for x <= 0. */
+q16_t dit_log_q16(q16_t x);
+
+/** sqrt(x) for x >= 0; 0 for x <= 0. */
+q16_t dit_sqrt_q16(q16_t x);
+
+/** 1/sqrt(x) for x > 0, saturating to INT32_MAX; INT32_MAX for x <= 0. */
+q16_t dit_rsqrt_q16(q16_t x);
+
+/** atan2(y, x) in Q16.16 radians, (-PI, PI]. */
+q16_t dit_atan2_q16(q16_t y, q16_t x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -10,61 +10,373 @@
 #include <stdint.h>
 #include "dit_physics.h"
 
-// Fixed-point configuration (Q16.16)
-#define FP_SHIFT 16
-#define FP_ONE (1 << FP_SHIFT)
+// Fixed-point format, chosen at build time (make FP_FORMAT=Q32_32):
+//
+//   Q16_16  int32, range +-32768,  resolution 1.5e-5   (default)
+//   Q8_24   int32, range +-128,    resolution 6.0e-8   (precision)
+//   Q32_32  int64, range +-2^31,   resolution 2.3e-10  (range; slower)
+//
+// Code that is format-agnostic uses only FP_SHIFT, FP_ONE, fixed_t,
+// FP_FROM_DOUBLE and the fp_* helpers below.
+#define DIT_FP_Q16_16 1
+#define DIT_FP_Q8_24  2
+#define DIT_FP_Q32_32 3
+
+#ifndef DIT_FP_FORMAT
+#define DIT_FP_FORMAT DIT_FP_Q16_16
+#endif
 
+#if DIT_FP_FORMAT == DIT_FP_Q16_16
+#define FP_SHIFT 16
+#define DIT_FP_NAME "Q16.16"
+typedef int32_t fixed_t;
+#elif DIT_FP_FORMAT == DIT_FP_Q8_24
+#define FP_SHIFT 24
+#define DIT_FP_NAME "Q8.24"
 typedef int32_t fixed_t;
+#elif DIT_FP_FORMAT == DIT_FP_Q32_32
+#define FP_SHIFT 32
+#define DIT_FP_NAME "Q32.32"
+#define DIT_FP_WIDE 1
+typedef int64_t fixed_t;
+#else
+#error "DIT_FP_FORMAT must be DIT_FP_Q16_16, DIT_FP_Q8_24 or DIT_FP_Q32_32"
+#endif
+
+#define FP_ONE ((fixed_t)1 << FP_SHIFT)
+
+#ifdef DIT_FP_WIDE
+#define FP_MAX INT64_MAX
+#define FP_MIN INT64_MIN
+#else
+#define FP_MAX INT32_MAX
+#define FP_MIN INT32_MIN
+#endif
+
+// Constant conversion, rounded to nearest. Folded at compile time when x
+// is a constant; at run time it needs the FPU (never inside an ISR).
+#define FP_FROM_DOUBLE(x) ((fixed_t)((x) * (double)FP_ONE + ((x) < 0 ? -0.5 : 0.5)))
+
+// Binary angle measurement (BAM): a full turn is 2^32, so phase
+// wrapping is the natural uint32_t overflow and costs nothing.
+typedef uint32_t dit_angle_t;
+
+#define DIT_ANGLE_QUARTER   0x40000000u
+
+// Quarter-wave sine table: 256 intervals over [0, PI/2] in Q2.30
+#define DIT_SINE_TABLE_BITS 8
+#define DIT_SINE_TABLE_SIZE (1 << DIT_SINE_TABLE_BITS)
+#define DIT_SINE_FRAC_BITS  (30 - DIT_SINE_TABLE_BITS)
+
+// Radians to BAM: 2^32 / (2*PI); angle = (x * DIT_RAD_TO_ANGLE) >> FP_SHIFT
+#define DIT_RAD_TO_ANGLE    683565276LL
+
+// BAM to radians: 2*PI * 2^29, fits a uint32
+#define DIT_ANGLE_TO_RAD_Q29 3373259426ULL
+
+// Golden phase step PI*phi' per n, as a Q32.32 fraction of a turn (phi'/2 * 2^64)
+#define DIT_GOLDEN_PHASE_STEP 0x4f1bbcdcbfa53e0aULL
 
 /**
- * dit_cos_fixed
- * 4th order Taylor approximation for cosine.
- * Optimized for normalized phase within [0, 2*PI].
+ * fp_to_double
+ * For display and host-side checks only (uses the FPU).
  */
-static inline fixed_t dit_cos_fixed(fixed_t x) {
-    // Normalize x to [-PI_FP, PI_FP] for better Taylor accuracy
-    while (x > PI_FP) x -= 2 * PI_FP;
-    while (x < -PI_FP) x += 2 * PI_FP;
-
-    fixed_t sign = FP_ONE;
-    // Map to [-PI/2, PI/2] using cos(x) = -cos(pi-x) etc.
-    if (x > (PI_FP / 2)) {
-        x = PI_FP - x;
-        sign = -FP_ONE;
-    } else if (x < -(PI_FP / 2)) {
-        x = -PI_FP - x;
-        sign = -FP_ONE;
+static inline double fp_to_double(fixed_t x) {
+    return (double)x / (double)FP_ONE;
+}
+
+#ifdef DIT_FP_WIDE
+
+/* 64x64 -> 128 bit magnitude product, as (hi, lo) */
+static inline void fp_umul128(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
+    uint64_t al = (uint32_t)a, ah = a >> 32;
+    uint64_t bl = (uint32_t)b, bh = b >> 32;
+
+    uint64_t ll = al * bl;
+    uint64_t lh = al * bh;
+    uint64_t hl = ah * bl;
+    uint64_t hh = ah * bh;
+
+    uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+    *lo = (mid << 32) | (uint32_t)ll;
+    *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+/* Saturate a magnitude to the signed range */
+static inline fixed_t fp_saturate_mag(uint64_t mag, int negative) {
+    if (negative) return (mag > (uint64_t)INT64_MAX) ? INT64_MIN : -(int64_t)mag;
+    return (mag > (uint64_t)INT64_MAX) ? INT64_MAX : (int64_t)mag;
+}
+
+/**
+ * fp_mul
+ * a * b with a full-width (128-bit) intermediate, truncated toward
+ * minus infinity like ">>" on the 32-bit formats, saturating on overflow.
+ * Built from four 32x32 multiplies: no libgcc helpers on i386.
+ */
+static inline fixed_t fp_mul(fixed_t a, fixed_t b) {
+    int negative = (a < 0) != (b < 0);
+    uint64_t ua = (a < 0) ? -(uint64_t)a : (uint64_t)a;
+    uint64_t ub = (b < 0) ? -(uint64_t)b : (uint64_t)b;
+
+    uint64_t hi, lo;
+    fp_umul128(ua, ub, &hi, &lo);
+    if (hi >> 32) return negative ? FP_MIN : FP_MAX;
+
+    uint64_t mag = (hi << 32) | (lo >> 32);
+    // Floor for negative results: round the magnitude up if bits were lost
+    if (negative && (uint32_t)lo && mag <= (uint64_t)INT64_MAX) mag++;
+    return fp_saturate_mag(mag, negative);
+}
+
+/**
+ * fp_div
+ * a / b, truncated toward zero, saturating on overflow and on b == 0.
+ * (a << 32) needs a 128/64 division: restoring shift-subtract, 64
+ * iterations. This is the main cost of the wide format.
+ */
+static inline fixed_t fp_div(fixed_t a, fixed_t b) {
+    int negative = (a < 0) != (b < 0);
+    if (b == 0) return (a < 0) ? FP_MIN : FP_MAX;
+
+    uint64_t ua = (a < 0) ? -(uint64_t)a : (uint64_t)a;
+    uint64_t ub = (b < 0) ? -(uint64_t)b : (uint64_t)b;
+
+    // Numerator ua * 2^32 = (rem : lo); the quotient fits 64 bits iff rem < ub
+    uint64_t rem = ua >> 32;
+    uint64_t lo = ua << 32;
+    if (rem >= ub) return negative ? FP_MIN : FP_MAX;
+
+    uint64_t q = 0;
+    for (int i = 0; i < 64; i++) {
+        uint64_t carry = rem >> 63;
+        rem = (rem << 1) | (lo >> 63);
+        lo <<= 1;
+        q <<= 1;
+        if (carry || rem >= ub) {
+            rem -= ub;
+            q |= 1;
+        }
     }
+    return fp_saturate_mag(q, negative);
+}
+
+#else /* 32-bit formats */
+
+/**
+ * fp_mul
+ * a * b with a 64-bit intermediate, saturating on overflow. Same
+ * rounding as the historical "(a * b) >> FP_SHIFT".
+ */
+static inline fixed_t fp_mul(fixed_t a, fixed_t b) {
+    int64_t p = ((int64_t)a * b) >> FP_SHIFT;
+    if (p > FP_MAX) return FP_MAX;
+    if (p < FP_MIN) return FP_MIN;
+    return (fixed_t)p;
+}
+
+/* Unsigned 64/32 -> 32 division. Caller guarantees the quotient fits. */
+static inline uint32_t fp_udiv64_32(uint64_t n, uint32_t d) {
+#if defined(__i386__) || defined(__x86_64__)
+    // Single divl: a C 64-bit division would pull __udivdi3 from libgcc on i386
+    uint32_t q, r;
+    __asm__("divl %4"
+            : "=a"(q), "=d"(r)
+            : "a"((uint32_t)n), "d"((uint32_t)(n >> 32)), "rm"(d));
+    return q;
+#else
+    return (uint32_t)(n / d);
+#endif
+}
+
+/**
+ * fp_div
+ * a / b with the numerator widened to 64 bits before the shift,
+ * truncated toward zero, saturating on overflow and on b == 0.
+ */
+static inline fixed_t fp_div(fixed_t a, fixed_t b) {
+    int negative = (a < 0) != (b < 0);
+    if (b == 0) return (a < 0) ? FP_MIN : FP_MAX;
+
+    uint64_t n = (uint64_t)((a < 0) ? -(int64_t)a : a) << FP_SHIFT;
+    uint32_t d = (uint32_t)((b < 0) ? -(int64_t)b : b);
+
+    // Quotient must stay below 2^31 (this also keeps divl from faulting)
+    if ((n >> 31) >= d) return negative ? FP_MIN : FP_MAX;
+
+    uint32_t q = fp_udiv64_32(n, d);
+    return negative ? -(fixed_t)q : (fixed_t)q;
+}
+
+#endif /* DIT_FP_WIDE */
+
+/**
+ * fp_from_q30
+ * Q2.30 (the sine table format) to the build format, rounded.
+ */
+static inline fixed_t fp_from_q30(int32_t x) {
+#if FP_SHIFT >= 30
+    return (fixed_t)x << (FP_SHIFT - 30);
+#else
+    return (fixed_t)((x + (1 << (29 - FP_SHIFT))) >> (30 - FP_SHIFT));
+#endif
+}
+
+/**
+ * dit_sine_table_q30
+ * sin(i * PI/512) * 2^30 for i = 0..257. Entry 257 mirrors entry 255
+ * so the reflected quadrants can read table[i + 1] at i = 256.
+ */
+static const int32_t dit_sine_table_q30[DIT_SINE_TABLE_SIZE + 2] = {
+             0,    6588356,   13176464,   19764076,   26350943,   32936819,
+      39521455,   46104602,   52686014,   59265442,   65842639,   72417357,
+      78989349,   85558366,   92124163,   98686491,  105245103,  111799753,
+     118350194,  124896179,  131437462,  137973796,  144504935,  151030634,
+     157550647,  164064728,  170572633,  177074115,  183568930,  190056834,
+     196537583,  203010932,  209476638,  215934457,  222384147,  228825464,
+     235258165,  241682010,  248096755,  254502159,  260897982,  267283981,
+     273659918,  280025552,  286380643,  292724951,  299058239,  305380268,
+     311690799,  317989595,  324276419,  330551034,  336813204,  343062693,
+     349299266,  355522689,  361732726,  367929144,  374111709,  380280190,
+     386434353,  392573967,  398698801,  404808624,  410903207,  416982319,
+     423045732,  429093217,  435124548,  441139496,  447137835,  453119340,
+     459083786,  465030947,  470960600,  476872522,  482766489,  488642281,
+     494499676,  500338453,  506158392,  511959275,  517740883,  523502998,
+     529245404,  534967884,  540670223,  546352205,  552013618,  557654248,
+     563273883,  568872310,  574449320,  580004702,  585538248,  591049748,
+     596538995,  602005783,  607449906,  612871159,  618269338,  623644239,
+     628995660,  634323400,  639627258,  644907034,  650162530,  655393548,
+     660599890,  665781362,  670937767,  676068911,  681174602,  686254647,
+     691308855,  696337036,  701339000,  706314559,  711263525,  716185713,
+     721080937,  725949013,  730789757,  735602987,  740388522,  745146182,
+     749875788,  754577161,  759250125,  763894504,  768510122,  773096806,
+     777654384,  782182683,  786681534,  791150767,  795590213,  799999706,
+     804379079,  808728167,  813046808,  817334838,  821592095,  825818421,
+     830013654,  834177638,  838310216,  842411232,  846480531,  850517961,
+     854523370,  858496606,  862437520,  866345964,  870221790,  874064853,
+     877875009,  881652112,  885396022,  889106597,  892783698,  896427186,
+     900036924,  903612776,  907154608,  910662286,  914135678,  917574653,
+     920979082,  924348837,  927683790,  930983817,  934248793,  937478595,
+     940673101,  943832191,  946955747,  950043650,  953095785,  956112036,
+     959092290,  962036435,  964944360,  967815955,  970651112,  973449725,
+     976211688,  978936898,  981625251,  984276646,  986890984,  989468165,
+     992008094,  994510675,  996975812,  999403415, 1001793390, 1004145648,
+    1006460100, 1008736660, 1010975242, 1013175761, 1015338134, 1017462281,
+    1019548121, 1021595575, 1023604567, 1025575020, 1027506862, 1029400018,
+    1031254418, 1033069992, 1034846671, 1036584389, 1038283080, 1039942680,
+    1041563127, 1043144360, 1044686319, 1046188946, 1047652185, 1049075980,
+    1050460278, 1051805027, 1053110176, 1054375676, 1055601479, 1056787540,
+    1057933813, 1059040255, 1060106826, 1061133483, 1062120190, 1063066909,
+    1063973603, 1064840240, 1065666786, 1066453210, 1067199483, 1067905576,
+    1068571464, 1069197120, 1069782521, 1070327646, 1070832474, 1071296985,
+    1071721163, 1072104991, 1072448455, 1072751542, 1073014240, 1073236540,
+    1073418433, 1073559913, 1073660973, 1073721611, 1073741824, 1073721611
+};
+
+/**
+ * dit_angle_from_fixed
+ * Converts an angle in radians to BAM. Any magnitude is accepted;
+ * the result is reduced modulo 2*PI by the truncation to 32 bits.
+ */
+static inline dit_angle_t dit_angle_from_fixed(fixed_t x) {
+#ifdef DIT_FP_WIDE
+    // (x * K) >> 32 modulo 2^32, split as x = hi * 2^32 + lo
+    int32_t hi = (int32_t)(x >> 32);
+    uint32_t lo = (uint32_t)x;
+    return (dit_angle_t)hi * (uint32_t)DIT_RAD_TO_ANGLE +
+           (dit_angle_t)(((uint64_t)lo * DIT_RAD_TO_ANGLE) >> 32);
+#else
+    return (dit_angle_t)(((int64_t)x * DIT_RAD_TO_ANGLE) >> FP_SHIFT);
+#endif
+}
+
+/**
+ * dit_fixed_from_angle
+ * BAM to radians in [0, 2*PI). Exact modulo 2*PI for any phase that was
+ * accumulated in BAM, unlike a phase accumulated in fixed_t radians.
+ */
+static inline fixed_t dit_fixed_from_angle(dit_angle_t a) {
+    return (fixed_t)(((uint64_t)a * DIT_ANGLE_TO_RAD_Q29) >> (61 - FP_SHIFT));
+}
 
-    int64_t x_long = x;
-    int64_t x2 = (x_long * x_long) >> FP_SHIFT;
-    int64_t x4 = (x2 * x2) >> FP_SHIFT;
+/**
+ * dit_sin_angle_q30
+ * sin(a) in Q2.30 by quarter-wave lookup and linear interpolation
+ * (interpolation error below 5e-6). Used directly where the extra
+ * precision matters, e.g. to seed rotation recurrences.
+ */
+static inline int32_t dit_sin_angle_q30(dit_angle_t a) {
+    uint32_t offset = a & (DIT_ANGLE_QUARTER - 1);
+
+    // Quadrants 1 and 3 run the table backwards: sin(PI - x) = sin(x)
+    if (a & DIT_ANGLE_QUARTER) offset = DIT_ANGLE_QUARTER - offset;
+
+    uint32_t i = offset >> DIT_SINE_FRAC_BITS;
+    uint32_t frac = offset & ((1u << DIT_SINE_FRAC_BITS) - 1);
+
+    int32_t y0 = dit_sine_table_q30[i];
+    int32_t y1 = dit_sine_table_q30[i + 1];
+    int32_t y = y0 + (int32_t)(((int64_t)(y1 - y0) * frac) >> DIT_SINE_FRAC_BITS);
+
+    // Quadrants 2 and 3 are negative
+    return (a & (2 * DIT_ANGLE_QUARTER)) ? -y : y;
+}
+
+/**
+ * dit_sin_angle
+ * sin(a) in the build format. Maximum error in Q16.16 is 2^-17 (half an
+ * output LSB plus the interpolation error); the wider formats are
+ * limited by the 5e-6 interpolation error of the table.
+ *
+ * Constant time: straight-line code with no loops; the worst case is one
+ * 32x32->64 multiply, two table loads and two conditional negations,
+ * about 25 instructions on i686 regardless of the angle.
+ */
+static inline fixed_t dit_sin_angle(dit_angle_t a) {
+    return fp_from_q30(dit_sin_angle_q30(a));
+}
 
-    fixed_t term2 = (fixed_t)(x2 >> 1);
-    fixed_t term4 = (fixed_t)(x4 / 24);
+/**
+ * dit_cos_angle
+ * cos(a) = sin(a + PI/2), same cost as dit_sin_angle.
+ */
+static inline fixed_t dit_cos_angle(dit_angle_t a) {
+    return dit_sin_angle(a + DIT_ANGLE_QUARTER);
+}
 
-    fixed_t cos_val = FP_ONE - term2 + term4;
+/**
+ * dit_cos_fixed
+ * Cosine of an angle in radians, any magnitude, constant time.
+ */
+static inline fixed_t dit_cos_fixed(fixed_t x) {
+    return dit_cos_angle(dit_angle_from_fixed(x));
+}
 
-    return (fixed_t)(((int64_t)sign * cos_val) >> FP_SHIFT);
+/**
+ * dit_sin_fixed
+ * Sine of an angle in radians, any magnitude, constant time.
+ */
+static inline fixed_t dit_sin_fixed(fixed_t x) {
+    return dit_sin_angle(dit_angle_from_fixed(x));
 }
 
 /**
  * get_golden_operator_fixed
  * Calculates O_n = cos(pi * n) * cos(pi * phi * n + delta)
+ *
+ * The phase pi*phi*n is formed directly in BAM from a Q32.32 step, so it
+ * wraps exactly modulo 2*PI and never grows with n: the cost is the same
+ * at n = 1 and n = 2^31.
  */
 static inline fixed_t get_golden_operator_fixed(int n, fixed_t delta) {
-    // Parity: cos(pi * n) is just (-1)^n
-    fixed_t parity = (n % 2 == 0) ? FP_ONE : -FP_ONE;
-
-    // Quasiperiodic phase: pi * phi * n + delta
-    // Note: Use 64-bit for intermediate phase to avoid overflow
-    int64_t phase = (((int64_t)PI_FP * PHI_CONJUGATE_FP) >> FP_SHIFT) * n;
-    phase += delta;
+    // Quasiperiodic phase: pi * phi * n + delta (mod 2*pi)
+    dit_angle_t phase = (dit_angle_t)((DIT_GOLDEN_PHASE_STEP * (uint32_t)n) >> 32);
+    phase += dit_angle_from_fixed(delta);
 
-    // Apply cosine to the quasiperiodic part
-    fixed_t qp_cos = dit_cos_fixed((fixed_t)phase);
+    fixed_t qp_cos = dit_cos_angle(phase);
 
-    return (fixed_t)(((int64_t)parity * qp_cos) >> FP_SHIFT);
+    // Parity: cos(pi * n) is just (-1)^n
+    return (n & 1) ? -qp_cos : qp_cos;
 }
 
 #endif
@@ -21,11 +21,12 @@
 #define PHI_CONJUGATE 0.6180339887498948
 #endif
 
-// --- Fixed-Point Constants (Q16.16) ---
-// Scaling: value * 2^16
-#define PI_FP  205887        // 3.14159... * 65536
-#define PHI_FP 106044       // 1.61803... * 65536
-#define PHI_CONJUGATE_FP 40502       // 0.61803... * 65536
+// --- Fixed-Point Constants ---
+// In the build's fixed-point format (DIT_FP_FORMAT, see dit_math_fixed.h).
+// In Q16.16 these are 205887, 106039 and 40503.
+#define PI_FP            FP_FROM_DOUBLE(M_PI)
+#define PHI_FP           FP_FROM_DOUBLE(PHI)
+#define PHI_CONJUGATE_FP FP_FROM_DOUBLE(PHI_CONJUGATE)
 
 // --- Phase Offsets ---
 #define DIT_DELTA_DEFAULT 0.18
@@ -0,0 +1,616 @@
+/*
+ * DIT Math - Implementación
+ * Smopsys Q-CORE
+ *
+ * Biblioteca matemática freestanding compartida por todos los módulos
+ * físicos. Sin libm ni ayudas de libgcc: sólo sumas, productos,
+ * divisiones de doble precisión y manipulación de bits IEEE-754.
+ *
+ * Cada función reduce el argumento a un intervalo pequeño y evalúa un
+ * polinomio; los niveles "accurate" y "fast" comparten la reducción y
+ * difieren en el grado del polinomio (o en el número de pasos de Newton).
+ * La tabla de precisión y coste está en include/dit_math.h.
+ */
+
+#include "../include/dit_math.h"
+
+/* ============================================================
+ * CONSTANTES Y ACCESO A BITS
+ * ============================================================ */
+
+/* π/2 en tres partes (Cody-Waite): k·PIO2_1 es exacto para |k| < 2^20 */
+#define PIO2_1    1.57079632673412561417e+00
+#define PIO2_2    6.07710050630396597660e-11
+#define PIO2_2T   2.02226624879595063154e-21
+#define INV_PIO2  6.36619772367581382433e-01
+#define TRIG_MAX_ARG  4503599627370496.0     /* 2^52 */
+
+#define DIT_PI    3.14159265358979311600e+00
+#define DIT_PIO2  1.57079632679489655800e+00
+#define DIT_PIO4  7.85398163397448278999e-01
+#define TAN_PIO8  4.14213562373095145475e-01
+
+/* ln2 en dos partes: k·LN2_HI es exacto para |k| < 2^11 */
+#define LN2_HI    6.93147180369123816490e-01
+#define LN2_LO    1.90821492927058770002e-10
+#define INV_LN2   1.44269504088896338700e+00
+
+#define EXP_OVERFLOW   709.782712893383973096
+#define EXP_UNDERFLOW -745.133219101941108420
+
+#define SQRT_HALF 7.07106781186547572737e-01
+#define TWO54     1.80143985094819840000e+16
+
+/* Estimación inicial de 1/√x por manipulación de bits */
+#define RSQRT_MAGIC  0x5FE6EB50C7B537A9ULL
+
+typedef union {
+    double d;
+    uint64_t u;
+} dit_bits;
+
+static inline double dit_from_bits(uint64_t u) {
+    dit_bits b;
+    b.u = u;
+    return b.d;
+}
+
+static inline uint64_t dit_to_bits(double d) {
+    dit_bits b;
+    b.d = d;
+    return b.u;
+}
+
+#define DIT_NAN      dit_from_bits(0x7FF8000000000000ULL)
+#define DIT_INF      dit_from_bits(0x7FF0000000000000ULL)
+
+/* 2^k para -1022 ≤ k ≤ 1023 */
+static inline double dit_pow2(int32_t k) {
+    return dit_from_bits((uint64_t)(k + 1023) << 52);
+}
+
+/* ============================================================
+ * SENO Y COSENO
+ * ============================================================ */
+
+/* Coeficientes de Taylor: S_k = (-1)^k/(2k+1)!, C_k = (-1)^k/(2k)! */
+#define S1  -1.66666666666666657e-01
+#define S2   8.33333333333333322e-03
+#define S3  -1.98412698412698413e-04
+#define S4   2.75573192239858925e-06
+#define S5  -2.50521083854417202e-08
+#define S6   1.60590438368216133e-10
+#define S7  -7.64716373181981641e-13
+#define S8   2.81145725434552060e-15
+
+#define C1  -5.00000000000000000e-01
+#define C2   4.16666666666666644e-02
+#define C3  -1.38888888888888894e-03
+#define C4   2.48015873015873016e-05
+#define C5  -2.75573192239858883e-07
+#define C6   2.08767569878681002e-09
+#define C7  -1.14707455977297245e-11
+#define C8   4.77947733238738525e-14
+#define C9  -1.56192069685862253e-16
+
+/* sin(r), cos(r) para |r| ≤ π/4 */
+static inline double sin_kernel(double r) {
+    double s = r * r;
+    return r + r * s * (S1 + s * (S2 + s * (S3 + s * (S4 + s * (S5 +
+               s * (S6 + s * (S7 + s * S8)))))));
+}
+
+static inline double cos_kernel(double r) {
+    double s = r * r;
+    return 1.0 + s * (C1 + s * (C2 + s * (C3 + s * (C4 + s * (C5 +
+                 s * (C6 + s * (C7 + s * (C8 + s * C9))))))));
+}
+
+static inline double sin_kernel_fast(double r) {
+    double s = r * r;
+    return r + r * s * (S1 + s * (S2 + s * (S3 + s * S4)));
+}
+
+static inline double cos_kernel_fast(double r) {
+    double s = r * r;
+    return 1.0 + s * (C1 + s * (C2 + s * (C3 + s * (C4 + s * C5))));
+}
+
+/* x = k·π/2 + r, |r| ≤ π/4. Retorna k mod 4. Requiere |x| < 2^52. */
+static inline uint32_t reduce_pio2(double x, double *r) {
+    double fk = x * INV_PIO2;
+    int64_t k = (int64_t)(fk + (fk >= 0.0 ? 0.5 : -0.5));
+    double dk = (double)k;
+    *r = ((x - dk * PIO2_1) - dk * PIO2_2) - dk * PIO2_2T;
+    return (uint32_t)k & 3;
+}
+
+double dit_sin(double x) {
+    if (!(dit_fabs(x) < TRIG_MAX_ARG)) return DIT_NAN;
+
+    double r;
+    switch (reduce_pio2(x, &r)) {
+    case 0:  return sin_kernel(r);
+    case 1:  return cos_kernel(r);
+    case 2:  return -sin_kernel(r);
+    default: return -cos_kernel(r);
+    }
+}
+
+double dit_cos(double x) {
+    if (!(dit_fabs(x) < TRIG_MAX_ARG)) return DIT_NAN;
+
+    double r;
+    switch (reduce_pio2(x, &r)) {
+    case 0:  return cos_kernel(r);
+    case 1:  return -sin_kernel(r);
+    case 2:  return -cos_kernel(r);
+    default: return sin_kernel(r);
+    }
+}
+
+double dit_sin_fast(double x) {
+    if (!(dit_fabs(x) < TRIG_MAX_ARG)) return DIT_NAN;
+
+    double r;
+    switch (reduce_pio2(x, &r)) {
+    case 0:  return sin_kernel_fast(r);
+    case 1:  return cos_kernel_fast(r);
+    case 2:  return -sin_kernel_fast(r);
+    default: return -cos_kernel_fast(r);
+    }
+}
+
+double dit_cos_fast(double x) {
+    if (!(dit_fabs(x) < TRIG_MAX_ARG)) return DIT_NAN;
+
+    double r;
+    switch (reduce_pio2(x, &r)) {
+    case 0:  return cos_kernel_fast(r);
+    case 1:  return -sin_kernel_fast(r);
+    case 2:  return -cos_kernel_fast(r);
+    default: return sin_kernel_fast(r);
+    }
+}
+
+/* ============================================================
+ * EXPONENCIAL
+ *
+ * x = k·ln2 + r, |r| ≤ ln2/2;  e^x = 2^k · e^r
+ * ============================================================ */
+
+#define E2   5.00000000000000000e-01
+#define E3   1.66666666666666657e-01
+#define E4   4.16666666666666644e-02
+#define E5   8.33333333333333322e-03
+#define E6   1.38888888888888894e-03
+#define E7   1.98412698412698413e-04
+#define E8   2.48015873015873016e-05
+#define E9   2.75573192239858925e-06
+#define E10  2.75573192239858883e-07
+#define E11  2.50521083854417202e-08
+#define E12  2.08767569878681002e-09
+#define E13  1.60590438368216133e-10
+
+/* Escala p·2^k cubriendo el rango subnormal */
+static inline double exp_scale(double p, int32_t k) {
+    if (k > 1023) return p * dit_pow2(1023) * dit_pow2(k - 1023);
+    if (k < -1021) return p * dit_pow2(k + 54) * (1.0 / TWO54);
+    return p * dit_pow2(k);
+}
+
+static inline int32_t reduce_ln2(double x, double *r) {
+    double fk = x * INV_LN2;
+    int32_t k = (int32_t)(fk + (fk >= 0.0 ? 0.5 : -0.5));
+    *r = (x - k * LN2_HI) - k * LN2_LO;
+    return k;
+}
+
+double dit_exp(double x) {
+    if (x != x) return x;
+    if (x > EXP_OVERFLOW) return DIT_INF;
+    if (x < EXP_UNDERFLOW) return 0.0;
+
+    double r;
+    int32_t k = reduce_ln2(x, &r);
+    double p = 1.0 + r + r * r * (E2 + r * (E3 + r * (E4 + r * (E5 + r * (E6 +
+               r * (E7 + r * (E8 + r * (E9 + r * (E10 + r * (E11 +
+               r * (E12 + r * E13)))))))))));
+    return exp_scale(p, k);
+}
+
+double dit_exp_fast(double x) {
+    if (x != x) return x;
+    if (x > EXP_OVERFLOW) return DIT_INF;
+    if (x < EXP_UNDERFLOW) return 0.0;
+
+    double r;
+    int32_t k = reduce_ln2(x, &r);
+    double p = 1.0 + r + r * r * (E2 + r * (E3 + r * (E4 + r * (E5 + r * (E6 +
+               r * (E7 + r * E8))))));
+    return exp_scale(p, k);
+}
+
+/* ============================================================
+ * LOGARITMO
+ *
+ * x = m·2^e, m ∈ [√½, √2);  ln m = 2·atanh(f), f = (m - 1)/(m + 1)
+ * ============================================================ */
+
+/* Separa x > 0 finito en m y e. Retorna e. */
+static inline int32_t split_log(double x, double *m) {
+    int32_t bias = 0;
+    if (x < 2.2250738585072014e-308) {          /* subnormal */
+        x *= TWO54;
+        bias = -54;
+    }
+
+    uint64_t u = dit_to_bits(x);
+    int32_t e = (int32_t)((u >> 52) & 0x7FF) - 1023;
+    *m = dit_from_bits((u & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+
+    if (*m > 2.0 * SQRT_HALF) {
+        *m *= 0.5;
+        e++;
+    }
+    return e + bias;
+}
+
+/* Casos especiales comunes; retorna 1 si *out ya es el resultado */
+static inline int log_special(double x, double *out) {
+    if (x != x || x == DIT_INF) { *out = x; return 1; }
+    if (x < 0.0) { *out = DIT_NAN; return 1; }
+    if (x == 0.0) { *out = -DIT_INF; return 1; }
+    return 0;
+}
+
+double dit_log(double x) {
+    double out;
+    if (log_special(x, &out)) return out;
+
+    double m;
+    int32_t e = split_log(x, &m);
+    double f = (m - 1.0) / (m + 1.0);
+    double s = f * f;
+
+    /* 2f·(1 + s/3 + s²/5 + ... + s^10/21) */
+    double t = s * (1.0/3 + s * (1.0/5 + s * (1.0/7 + s * (1.0/9 + s * (1.0/11 +
+               s * (1.0/13 + s * (1.0/15 + s * (1.0/17 + s * (1.0/19 +
+               s * (1.0/21))))))))));
+    double log_m = 2.0 * f + 2.0 * f * t;
+
+    return e * LN2_HI + (log_m + e * LN2_LO);
+}
+
+double dit_log_fast(double x) {
+    double out;
+    if (log_special(x, &out)) return out;
+
+    double m;
+    int32_t e = split_log(x, &m);
+    double f = (m - 1.0) / (m + 1.0);
+    double s = f * f;
+
+    double t = s * (1.0/3 + s * (1.0/5 + s * (1.0/7 + s * (1.0/9 + s * (1.0/11)))));
+    return e * LN2_HI + (2.0 * f + 2.0 * f * t + e * LN2_LO);
+}
+
+/* ============================================================
+ * RAÍZ CUADRADA Y RAÍZ INVERSA
+ *
+ * y0 = bits(MAGIC - (bits(x) >> 1)) (error ≤ 3.4%), luego Newton:
+ *   y ← y·(1.5 - 0.5·x·y²)   (error relativo e → 1.5·e²)
+ * ============================================================ */
+
+/* Casos especiales; retorna 1 si *out ya es el resultado */
+static inline int sqrt_special(double x, double *out, int inverse) {
+    if (x != x) { *out = x; return 1; }
+    if (x < 0.0) { *out = DIT_NAN; return 1; }
+    if (x == 0.0) { *out = inverse ? DIT_INF : 0.0; return 1; }
+    if (x == DIT_INF) { *out = inverse ? 0.0 : x; return 1; }
+    return 0;
+}
+
+/* 1/√x con n pasos de Newton. x > 0 finito. */
+static inline double rsqrt_newton(double x, int steps) {
+    double scale = 1.0;
+    if (x < 2.2250738585072014e-308) {          /* subnormal: 1/√(x·2^54) · 2^27 */
+        x *= TWO54;
+        scale = 134217728.0;
+    }
+
+    double half = 0.5 * x;
+    double y = dit_from_bits(RSQRT_MAGIC - (dit_to_bits(x) >> 1));
+    for (int i = 0; i < steps; i++) {
+        y = y * (1.5 - half * y * y);
+    }
+    return y * scale;
+}
+
+double dit_rsqrt(double x) {
+    double out;
+    if (sqrt_special(x, &out, 1)) return out;
+    return rsqrt_newton(x, 4);
+}
+
+double dit_rsqrt_fast(double x) {
+    double out;
+    if (sqrt_special(x, &out, 1)) return out;
+    return rsqrt_newton(x, 3);
+}
+
+/* √x = x·r y una corrección de Newton en √x. x > 0 finito. */
+static inline double sqrt_newton(double x, int steps) {
+    double scale = 1.0;
+    if (x < 2.2250738585072014e-308) {          /* subnormal: y² también lo sería */
+        x *= TWO54;
+        scale = 1.0 / 134217728.0;
+    }
+
+    double r = rsqrt_newton(x, steps);
+    double y = x * r;
+    return (y + 0.5 * r * (x - y * y)) * scale;
+}
+
+double dit_sqrt(double x) {
+    double out;
+    if (sqrt_special(x, &out, 0)) return out;
+    return sqrt_newton(x, 3);                   /* r a 1e-10 antes de corregir */
+}
+
+double dit_sqrt_fast(double x) {
+    double out;
+    if (sqrt_special(x, &out, 0)) return out;
+    return sqrt_newton(x, 2);
+}
+
+/* ============================================================
+ * ARCOTANGENTE
+ *
+ * Simetrías: t = min/max ∈ [0, 1]; si t > tan(π/8),
+ * atan t = π/4 + atan((t - 1)/(t + 1)), quedando |u| ≤ tan(π/8).
+ * El nivel accurate divide además el ángulo a la mitad:
+ *   atan u = 2·atan(u / (1 + √(1 + u²))),  |v| ≤ 0.199
+ * ============================================================ */
+
+/* 1/(2k + 1) */
+static const double atan_coef[12] = {
+    1.0, 1.0/3, 1.0/5, 1.0/7, 1.0/9, 1.0/11,
+    1.0/13, 1.0/15, 1.0/17, 1.0/19, 1.0/21, 1.0/23
+};
+
+/* atan(v) = v - v³/3 + v⁵/5 - ... hasta v^(2n+1), n ≤ 11 */
+static inline double atan_series(double v, int terms) {
+    double s = v * v;
+    double p = atan_coef[terms];
+    for (int k = terms - 1; k >= 1; k--) {
+        p = atan_coef[k] - s * p;
+    }
+    return v - v * s * p;
+}
+
+static double atan2_common(double y, double x, int accurate) {
+    if (x != x || y != y) return x + y;
+
+    double ay = dit_fabs(y);
+    double ax = dit_fabs(x);
+
+    if (ay == 0.0) {
+        if (dit_to_bits(x) >> 63) return (dit_to_bits(y) >> 63) ? -DIT_PI : DIT_PI;
+        return y;
+    }
+    if (ax == 0.0) return (y > 0.0) ? DIT_PIO2 : -DIT_PIO2;
+
+    int swapped = ay > ax;
+    double t = swapped ? ax / ay : ay / ax;
+
+    double base = 0.0;
+    double u = t;
+    if (t > TAN_PIO8) {
+        u = (t - 1.0) / (t + 1.0);
+        base = DIT_PIO4;
+    }
+
+    double a;
+    if (accurate) {
+        double v = u / (1.0 + dit_sqrt(1.0 + u * u));
+        a = 2.0 * atan_series(v, 11);
+    } else {
+        a = atan_series(u, 10);
+    }
+    a += base;
+
+    if (swapped) a = DIT_PIO2 - a;
+    if (x < 0.0) a = DIT_PI - a;
+    return (y < 0.0) ? -a : a;
+}
+
+double dit_atan2(double y, double x) {
+    return atan2_common(y, x, 1);
+}
+
+double dit_atan2_fast(double y, double x) {
+    return atan2_common(y, x, 0);
+}
+
+/* ============================================================
+ * FLOAT: núcleos fast de doble precisión, redondeados
+ *
+ * El nivel fast tiene error ≤ 1e-8, por debajo de medio ulp de float
+ * en casi todo el rango: el resultado queda a ≤ 1 ulp.
+ * ============================================================ */
+
+float dit_sinf(float x)            { return (float)dit_sin_fast(x); }
+float dit_cosf(float x)            { return (float)dit_cos_fast(x); }
+float dit_expf(float x)            { return (float)dit_exp_fast(x); }
+float dit_logf(float x)            { return (float)dit_log_fast(x); }
+float dit_sqrtf(float x)           { return (float)dit_sqrt_fast(x); }
+float dit_rsqrtf(float x)          { return (float)dit_rsqrt_fast(x); }
+float dit_atan2f(float y, float x) { return (float)dit_atan2_fast(y, x); }
+
+/* ============================================================
+ * Q16.16: SÓLO ARITMÉTICA ENTERA
+ *
+ * Sin FPU: seguro desde ISRs. Internamente Q2.30 / Q3.29 con
+ * productos de 64 bits; ninguna división de 64 bits.
+ * ============================================================ */
+
+#define Q30_ONE        (1 << 30)
+#define LOG2E_Q30      1549082005LL   /* log2(e) · 2^30 */
+#define LN2_Q30        744261118LL    /* ln(2) · 2^30 */
+#define PI_Q29         1686629713     /* π · 2^29 */
+#define EXP_Q16_MAX    681391         /* ln(32768) en Q16.16 */
+#define EXP_Q16_MIN    (-772244)      /* ln(2^-17) en Q16.16 */
+#define CORDIC_STEPS   28
+
+/* 1/k! en Q2.30, k = 0..9 */
+static const int32_t exp_coef_q30[10] = {
+    1073741824, 1073741824, 536870912, 178956971, 44739243,
+    8947849, 1491308, 213044, 26631, 2959
+};
+
+/* atan(2^-i) en Q3.29 */
+static const int32_t cordic_atan_q29[CORDIC_STEPS] = {
+    421657428, 248918915, 131521918, 66762579, 33510843, 16771758,
+    8387925, 4194219, 2097141, 1048575, 524288, 262144, 131072, 65536,
+    32768, 16384, 8192, 4096, 2048, 1024, 512, 256, 128, 64, 32, 16, 8, 4
+};
+
+/* Posición del bit más significativo de x > 0 */
+static inline int32_t msb32(uint32_t x) {
+    return 31 - __builtin_clz(x);
+}
+
+q16_t dit_exp_q16(q16_t x) {
+    if (x > EXP_Q16_MAX) return INT32_MAX;
+    if (x < EXP_Q16_MIN) return 0;
+
+    /* x/ln2 = k + f, f ∈ [0, 1) en Q16 */
+    int32_t t = (int32_t)(((int64_t)x * LOG2E_Q30) >> 30);
+    int32_t k = t >> Q16_SHIFT;
+    int64_t u = ((int64_t)(t & (Q16_ONE - 1)) * LN2_Q30) >> Q16_SHIFT;   /* f·ln2 en Q30 */
+
+    /* e^u, u ∈ [0, ln2), Horner en Q30 */
+    int64_t p = exp_coef_q30[9];
+    for (int i = 8; i >= 0; i--) {
+        p = exp_coef_q30[i] + ((p * u) >> 30);
+    }
+
+    /* 2^k · p: de Q30 a Q16 desplazando 14 - k */
+    int32_t shift = 14 - k;
+    if (shift >= 31) return 0;
+    if (shift <= 0) {
+        p <<= -shift;
+        return (p > INT32_MAX) ? INT32_MAX : (q16_t)p;
+    }
+    return (q16_t)((p + (1LL << (shift - 1))) >> shift);
+}
+
+q16_t dit_log_q16(q16_t x) {
+    if (x <= 0) return INT32_MIN;
+
+    /* x = m·2^e con m ∈ [1, 2) en Q30 */
+    int32_t p = msb32((uint32_t)x);
+    int32_t e = p - Q16_SHIFT;
+    uint64_t m = (p >= 30) ? ((uint32_t)x >> (p - 30)) : ((uint64_t)x << (30 - p));
+
+    /* log2(m) bit a bit por cuadrados sucesivos (16 bits, tiempo constante) */
+    int32_t frac = 0;
+    for (int i = 0; i < Q16_SHIFT; i++) {
+        m = (m * m) >> 30;
+        frac <<= 1;
+        if (m >= (2ULL << 30)) {
+            m >>= 1;
+            frac |= 1;
+        }
+    }
+
+    int32_t log2_q16 = (e << Q16_SHIFT) + frac;
+    return (q16_t)(((int64_t)log2_q16 * LN2_Q30 + (1 << 29)) >> 30);
+}
+
+q16_t dit_sqrt_q16(q16_t x) {
+    if (x <= 0) return 0;
+
+    /* √(x·2^16) entero, bit a bit */
+    uint64_t op = (uint64_t)x << Q16_SHIFT;
+    uint64_t res = 0;
+    uint64_t one = 1ULL << 46;
+
+    while (one > op) one >>= 2;
+    while (one) {
+        if (op >= res + one) {
+            op -= res + one;
+            res = (res >> 1) + one;
+        } else {
+            res >>= 1;
+        }
+        one >>= 2;
+    }
+
+    /* Redondeo: resto > res ⇔ (res + ½)² < valor */
+    if (op > res) res++;
+    return (q16_t)res;
+}
+
+q16_t dit_rsqrt_q16(q16_t x) {
+    if (x <= 0) return INT32_MAX;
+
+    /* X = x/2^16 = m·4^j, m ∈ [1, 4) en Q28 */
+    int32_t b = msb32((uint32_t)x) - Q16_SHIFT;
+    int32_t E = b & ~1;
+    int32_t shift = 12 - E;
+    int64_t m = (shift >= 0) ? ((int64_t)x << shift) : ((int64_t)x >> -shift);
+
+    /* y ≈ 1/√m ∈ (0.5, 1]: estimación lineal y 4 pasos de Newton en Q30 */
+    int64_t y = (int64_t)(1.2 * Q30_ONE) - ((m * (int64_t)(0.175 * Q30_ONE)) >> 28);
+    for (int i = 0; i < 4; i++) {
+        int64_t y2 = (y * y) >> 30;
+        int64_t my2 = (m * y2) >> 28;
+        y = (y * (3LL * Q30_ONE - my2)) >> 31;
+    }
+
+    /* 1/√X = y / 2^(E/2): de Q30 a Q16 */
+    int32_t out_shift = 14 + E / 2;
+    return (q16_t)((y + (1LL << (out_shift - 1))) >> out_shift);
+}
+
+q16_t dit_atan2_q16(q16_t y, q16_t x) {
+    if (x == 0 && y == 0) return 0;
+
+    int64_t X = x;
+    int64_t Y = y;
+    int64_t angle = 0;      /* Q3.29 (las sumas parciales superan ±4 rad) */
+
+    /* Llevar al semiplano derecho */
+    if (X < 0) {
+        angle = (Y >= 0) ? PI_Q29 : -PI_Q29;
+        X = -X;
+        Y = -Y;
+    }
+
+    /* Normalizar el módulo a ~2^38 para no perder bits en X >> i */
+    uint32_t ax = (uint32_t)(X < 0 ? -X : X);
+    uint32_t ay = (uint32_t)(Y < 0 ? -Y : Y);
+    int32_t top = msb32(ax | ay);
+    X <<= 38 - top;
+    Y <<= 38 - top;
+
+    /* CORDIC en modo vectorización: rotar hasta Y = 0 */
+    for (int i = 0; i < CORDIC_STEPS; i++) {
+        int64_t nx;
+        if (Y > 0) {
+            nx = X + (Y >> i);
+            Y -= X >> i;
+            angle += cordic_atan_q29[i];
+        } else {
+            nx = X - (Y >> i);
+            Y += X >> i;
+            angle -= cordic_atan_q29[i];
+        }
+        X = nx;
+    }
+
+    /* Q3.29 → Q16.16 */
+    return (q16_t)((angle + (1 << 12)) >> 13);
+}
@@ -0,0 +1,47 @@
+/*
+ * Mapa de memoria E820 - Smopsys Q-CORE
+ *
+ * Stage 2 recorre INT 15h, EAX=E820h en modo real y deja las entradas
+ * en E820_MAP_ADDR (memoria convencional libre, por debajo de la pila
+ * de arranque en 0x7C00). La cabecera se escribe al final: si el magic
+ * no está, la BIOS no dio mapa y el kernel usa su megabyte por defecto.
+ *
+ * Las constantes se repiten en stage2.asm: mantenerlas sincronizadas.
+ */
+
+#ifndef E820_H
+#define E820_H
+
+#include <stdint.h>
+
+/* Los tests del host la sustituyen (tests/host_kernel.h) */
+#ifndef E820_MAP_ADDR
+#define E820_MAP_ADDR       0x5000
+#endif
+#define E820_MAGIC          0x30323845u  /* 'E820' */
+#define E820_MAX_ENTRIES    32
+
+/* Tipos de región */
+#define E820_TYPE_USABLE    1
+#define E820_TYPE_RESERVED  2
+#define E820_TYPE_ACPI      3
+#define E820_TYPE_NVS       4
+#define E820_TYPE_BAD       5
+
+/* Bit 0 de los atributos ACPI 3.0: a 0, la BIOS pide ignorar la entrada */
+#define E820_ACPI_VALID     1
+
+typedef struct __attribute__((packed)) {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t acpi;
+} E820Entry;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint32_t count;
+    E820Entry entries[E820_MAX_ENTRIES];
+} E820Map;
+
+#endif /* E820_H */
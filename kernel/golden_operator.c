@@ -10,11 +10,18 @@
 
 #include "golden_operator.h"
 
+/* Factor de relajación hacia θ_eq = π por paso (escala la viscosidad) */
+#define GOLDEN_RELAXATION_FP    (FP_ONE / 50)
+
+/* Saltos más cortos se resuelven paso a paso (exacto y más barato) */
+#define GOLDEN_ADVANCE_MIN_JUMP 32
+
 /* ============================================================
  * NOTA: FUNCIONES MATEMÁTICAS REFACTORIZADAS
  * 
  * Las funciones trigonométricas ahora usan `fixed_t` y se
- * encuentran en `include/dit_math_fixed.h`.
+ * encuentran en `include/dit_math_fixed.h`; las de doble
+ * precisión, en `include/dit_math.h`.
  * ============================================================ */
 
 /* ============================================================
@@ -37,6 +44,11 @@ void golden_operator_init(GoldenState *state) {
     state->entropy = 0;
     state->viscosity = (fixed_t)(0.1 * FP_ONE);
     state->n = 0;
+    state->generation = 0;
+    
+    /* golden_operator_step produce Ô_1 en su primera llamada */
+    golden_generator_fixed_init(&state->gen, 1,
+                                (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE));
 }
 
 /* ============================================================
@@ -54,12 +66,12 @@ void golden_operator_compute_lagrangian(
     // Aproximamos θ̇ ≈ O_n
     fixed_t theta_dot = state->O_n;
     fixed_t potential = -dit_cos_fixed(state->theta);
-    *L_symp = ((theta_dot * theta_dot) >> (FP_SHIFT + 1)) + potential;
+    *L_symp = (fp_mul(theta_dot, theta_dot) >> 1) + potential;
 
     // L_metr = ½ η (θ - θ_eq)² donde θ_eq = π
     fixed_t deviation = state->theta - PI_FP;
-    fixed_t deviation_sq = (deviation * deviation) >> FP_SHIFT;
-    *L_metr = (state->viscosity * deviation_sq) >> (FP_SHIFT + 1);
+    fixed_t deviation_sq = fp_mul(deviation, deviation);
+    *L_metr = fp_mul(state->viscosity, deviation_sq) >> 1;
 }
 
 /* ============================================================
@@ -73,9 +85,12 @@ void golden_operator_compute_lagrangian(
 void golden_operator_step(GoldenState *state) {
     state->n++;
 
-    // Calcular O_n usando el nuevo operador de punto fijo
-    fixed_t delta = (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE);
-    state->O_n = get_golden_operator_fixed(state->n, delta);
+    // Ô_n por recurrencia de rotación (resincronizada periódicamente)
+    if (state->gen.n != state->n) {
+        golden_generator_fixed_init(&state->gen, state->n,
+                                    (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE));
+    }
+    state->O_n = golden_generator_fixed_next(&state->gen);
 
     golden_operator_compute_lagrangian(state, &state->L_symp, &state->L_metr);
 
@@ -84,9 +99,9 @@ void golden_operator_step(GoldenState *state) {
 
     // Parte Disipativa: dθ_D/dt ∝ η · (θ_eq - θ)
     fixed_t theta_equilibrium = PI_FP;
-    fixed_t relaxation_factor = FP_ONE / 50;
-    fixed_t dtheta_dissipative = (state->viscosity * (theta_equilibrium - state->theta)) >> FP_SHIFT;
-    dtheta_dissipative = (dtheta_dissipative * relaxation_factor) >> FP_SHIFT;
+    fixed_t relaxation_factor = GOLDEN_RELAXATION_FP;
+    fixed_t dtheta_dissipative = fp_mul(state->viscosity, theta_equilibrium - state->theta);
+    dtheta_dissipative = fp_mul(dtheta_dissipative, relaxation_factor);
     
     state->theta += dtheta_hamiltonian + dtheta_dissipative;
     
@@ -98,6 +113,246 @@ void golden_operator_step(GoldenState *state) {
     // La viscosidad y la entropía se simplifican en el modelo de punto fijo por ahora
     state->viscosity = (fixed_t)(0.1 * FP_ONE);
     state->entropy = (FP_ONE - dit_cos_fixed(state->theta)) >> 2;
+
+    // Los observables se recalculan bajo demanda (golden_operator_get_observables)
+    state->generation++;
+}
+
+/* ============================================================
+ * GENERADOR POR RECURRENCIA DE ROTACIÓN
+ * ============================================================ */
+
+#define GOLDEN_TWO_PI   6.28318530717958647693
+
+/* Fase de z_n como fracción de vuelta: n(1+φ)/2 + δ/2π (mod 1) */
+static uint64_t golden_turn(uint32_t n, uint64_t delta_turn) {
+    uint64_t parity = (uint64_t)(n & 1) << 63;
+    return DIT_GOLDEN_PHASE_STEP * n + parity + delta_turn;
+}
+
+static dit_angle_t golden_angle(uint32_t n, dit_angle_t delta) {
+    return (dit_angle_t)(golden_turn(n, 0) >> 32) + delta;
+}
+
+/* Radianes → fracción de vuelta Q0.64 */
+static uint64_t golden_turn_from_radians(double x) {
+    double t = x * (1.0 / GOLDEN_TWO_PI);
+    t -= (double)(int64_t)t;
+    if (t < 0.0) t += 1.0;
+    if (t >= 1.0) t = 0.0;
+    return (uint64_t)(int64_t)(t * 9223372036854775808.0) << 1;
+}
+
+/*
+ * (cos, sin) de una fracción de vuelta en doble precisión.
+ * Reducción al cuadrante más cercano (|r| ≤ π/4) y Taylor de grado 19.
+ */
+static void golden_sincos_turn(uint64_t turn, double *c, double *s) {
+    uint32_t q = (uint32_t)((turn + (1ULL << 61)) >> 62);
+    int64_t r_bits = (int64_t)(turn - ((uint64_t)q << 62));
+    double r = (double)r_bits * (GOLDEN_TWO_PI / 18446744073709551616.0);
+    double sr = dit_sin(r);
+    double cr = dit_cos(r);
+    
+    switch (q & 3) {
+    case 0:  *c = cr;  *s = sr;  break;
+    case 1:  *c = -sr; *s = cr;  break;
+    case 2:  *c = -cr; *s = -sr; break;
+    default: *c = sr;  *s = -cr; break;
+    }
+}
+
+/* z ← w·z en Q2.30 con redondeo */
+static inline void golden_rotate_q30(int32_t *re, int32_t *im, int32_t w_re, int32_t w_im) {
+    int64_t r = (int64_t)*re * w_re - (int64_t)*im * w_im;
+    int64_t i = (int64_t)*re * w_im + (int64_t)*im * w_re;
+    *re = (int32_t)((r + (1 << 29)) >> 30);
+    *im = (int32_t)((i + (1 << 29)) >> 30);
+}
+
+void golden_generator_init(GoldenGenerator *gen, uint32_t n0, double delta) {
+    gen->delta_turn = golden_turn_from_radians(delta);
+    gen->n = n0;
+    gen->since_sync = 0;
+    golden_sincos_turn(golden_turn(n0, gen->delta_turn), &gen->re, &gen->im);
+}
+
+double golden_generator_next(GoldenGenerator *gen) {
+    if (gen->since_sync >= GOLDEN_RESYNC_INTERVAL) {
+        golden_sincos_turn(golden_turn(gen->n, gen->delta_turn), &gen->re, &gen->im);
+        gen->since_sync = 0;
+    }
+    
+    double O_n = gen->re;
+    double re = gen->re * GOLDEN_W_RE - gen->im * GOLDEN_W_IM;
+    gen->im = gen->re * GOLDEN_W_IM + gen->im * GOLDEN_W_RE;
+    gen->re = re;
+    
+    gen->n++;
+    gen->since_sync++;
+    return O_n;
+}
+
+void golden_generator_fixed_init(GoldenGeneratorFixed *gen, uint32_t n0, fixed_t delta) {
+    gen->delta = dit_angle_from_fixed(delta);
+    gen->n = n0;
+    gen->since_sync = 0;
+    
+    dit_angle_t a = golden_angle(n0, gen->delta);
+    gen->re = dit_sin_angle_q30(a + DIT_ANGLE_QUARTER);
+    gen->im = dit_sin_angle_q30(a);
+}
+
+fixed_t golden_generator_fixed_next(GoldenGeneratorFixed *gen) {
+    if (gen->since_sync >= GOLDEN_RESYNC_INTERVAL) {
+        dit_angle_t a = golden_angle(gen->n, gen->delta);
+        gen->re = dit_sin_angle_q30(a + DIT_ANGLE_QUARTER);
+        gen->im = dit_sin_angle_q30(a);
+        gen->since_sync = 0;
+    }
+    
+    fixed_t O_n = fp_from_q30(gen->re);
+    golden_rotate_q30(&gen->re, &gen->im, GOLDEN_W_RE_Q30, GOLDEN_W_IM_Q30);
+    
+    gen->n++;
+    gen->since_sync++;
+    return O_n;
+}
+
+void golden_operator_generate(uint32_t n0, uint32_t count, double *out) {
+    uint64_t delta_turn = golden_turn_from_radians(DIT_DELTA_DEFAULT);
+    double re[4], im[4];
+    
+    for (uint32_t i = 0; i < count; i += GOLDEN_RESYNC_INTERVAL) {
+        uint32_t block = count - i;
+        if (block > GOLDEN_RESYNC_INTERVAL) block = GOLDEN_RESYNC_INTERVAL;
+        
+        /* Resincronización exacta de las 4 vías: z_{n}, ..., z_{n+3} */
+        for (uint32_t k = 0; k < 4; k++) {
+            golden_sincos_turn(golden_turn(n0 + i + k, delta_turn), &re[k], &im[k]);
+        }
+        
+        uint32_t j = 0;
+        for (; j + 4 <= block; j += 4) {
+            for (uint32_t k = 0; k < 4; k++) {
+                out[i + j + k] = re[k];
+                double r = re[k] * GOLDEN_W4_RE - im[k] * GOLDEN_W4_IM;
+                im[k] = re[k] * GOLDEN_W4_IM + im[k] * GOLDEN_W4_RE;
+                re[k] = r;
+            }
+        }
+        for (uint32_t k = 0; j + k < block; k++) {
+            out[i + j + k] = re[k];
+        }
+    }
+}
+
+void golden_operator_generate_fixed(uint32_t n0, uint32_t count, fixed_t *out) {
+    dit_angle_t delta = dit_angle_from_fixed((fixed_t)(DIT_DELTA_DEFAULT * FP_ONE));
+    int32_t re[4], im[4];
+    
+    for (uint32_t i = 0; i < count; i += GOLDEN_RESYNC_INTERVAL) {
+        uint32_t block = count - i;
+        if (block > GOLDEN_RESYNC_INTERVAL) block = GOLDEN_RESYNC_INTERVAL;
+        
+        for (uint32_t k = 0; k < 4; k++) {
+            dit_angle_t a = golden_angle(n0 + i + k, delta);
+            re[k] = dit_sin_angle_q30(a + DIT_ANGLE_QUARTER);
+            im[k] = dit_sin_angle_q30(a);
+        }
+        
+        uint32_t j = 0;
+        for (; j + 4 <= block; j += 4) {
+            for (uint32_t k = 0; k < 4; k++) {
+                out[i + j + k] = fp_from_q30(re[k]);
+                golden_rotate_q30(&re[k], &im[k], GOLDEN_W4_RE_Q30, GOLDEN_W4_IM_Q30);
+            }
+        }
+        for (uint32_t k = 0; j + k < block; k++) {
+            out[i + j + k] = fp_from_q30(re[k]);
+        }
+    }
+}
+
+/* ============================================================
+ * SALTO ADELANTE: θ_{n+k} EN FORMA CERRADA
+ * 
+ * Con e_n = θ_n - π y q = 1 - r (r = tasa de relajación efectiva):
+ *   e_{n+1} = q·e_n + Ô_{n+1}/16
+ *   e_{n+k} = q^k e_n + (1/16) Σ_{j=1..k} q^{k-j} Ô_{n+j}
+ * y como Ô_m = Re(e^{iδ} w^m):
+ *   Σ = Re(e^{iδ} w^{n+1} (w^k - q^k) / (w - q))
+ * 
+ * Válido mientras θ no cruce 0 ni 2π (la reducción de rango no es
+ * lineal). La parte forzada está acotada por 2/(16|w - q|) ≈ 0.11, así
+ * que basta |e_n| < π - GOLDEN_ADVANCE_MARGIN; desde estados cercanos
+ * al borde se avanza paso a paso hasta entrar en esa región.
+ * ============================================================ */
+
+/* x^k por cuadrados sucesivos: O(log k) */
+static double golden_pow(double x, uint32_t k) {
+    double result = 1.0;
+    while (k) {
+        if (k & 1) result *= x;
+        x *= x;
+        k >>= 1;
+    }
+    return result;
+}
+
+static int golden_advance_safe(fixed_t theta) {
+    double e = dit_fabs((double)theta / FP_ONE - M_PI);
+    return e < M_PI - GOLDEN_ADVANCE_MARGIN;
+}
+
+void golden_operator_advance(GoldenState *state, uint32_t k) {
+    /* Prefijo paso a paso mientras θ pueda cruzar 0 o 2π */
+    while (k > 0 && !golden_advance_safe(state->theta)) {
+        golden_operator_step(state);
+        k--;
+    }
+    
+    if (k < GOLDEN_ADVANCE_MIN_JUMP) {
+        while (k--) golden_operator_step(state);
+        return;
+    }
+    
+    /* Forma cerrada para k - 1 pasos; el último es un paso normal para
+     * que Ô_n, los Lagrangianos y la entropía salgan idénticos al step. */
+    uint32_t jump = k - 1;
+    uint32_t n = state->n;
+    
+    double r = ((double)state->viscosity / FP_ONE) *
+               ((double)GOLDEN_RELAXATION_FP / FP_ONE);
+    double q = 1.0 - r;
+    double qk = golden_pow(q, jump);
+    
+    /* w^k - q^k */
+    double wk_re, wk_im;
+    golden_sincos_turn(golden_turn(jump, 0), &wk_re, &wk_im);
+    double num_re = wk_re - qk;
+    double num_im = wk_im;
+    
+    /* (w^k - q^k) / (w - q) */
+    double den_re = GOLDEN_W_RE - q;
+    double den_im = GOLDEN_W_IM;
+    double den = den_re * den_re + den_im * den_im;
+    double ratio_re = (num_re * den_re + num_im * den_im) / den;
+    double ratio_im = (num_im * den_re - num_re * den_im) / den;
+    
+    /* e^{iδ} w^{n+1} (mismo δ en BAM que el generador) */
+    double z_re, z_im;
+    golden_sincos_turn(golden_turn(n + 1, (uint64_t)state->gen.delta << 32), &z_re, &z_im);
+    double forced = z_re * ratio_re - z_im * ratio_im;
+    
+    double e0 = (double)state->theta / FP_ONE - M_PI;
+    double theta = M_PI + qk * e0 + forced / 16.0;
+    
+    state->theta = (fixed_t)(theta * FP_ONE);
+    state->n = n + jump;
+    
+    /* El generador se re-siembra en n + jump dentro del step */
+    golden_operator_step(state);
 }
 
 /* ============================================================
@@ -108,16 +363,18 @@ void golden_operator_compute_observables(
     const GoldenState *state,
     GoldenObservables *obs
 ) {
-    // Fase acumulada: π * φ * n
-    obs->phase_accumulator = (((int64_t)PI_FP * PHI_CONJUGATE_FP) >> FP_SHIFT) * state->n;
+    // Fase acumulada: π * φ' * n (mod 2π), formada en BAM para no
+    // desbordar fixed_t (DIT_GOLDEN_PHASE_STEP = φ'/2 de vuelta)
+    dit_angle_t phase = (dit_angle_t)((DIT_GOLDEN_PHASE_STEP * state->n) >> 32);
+    obs->phase_accumulator = dit_fixed_from_angle(phase);
 
     // IPR: 1 - |cos(θ/2)|²
     fixed_t cos_half = dit_cos_fixed(state->theta >> 1);
-    obs->ipr = FP_ONE - ((cos_half * cos_half) >> FP_SHIFT);
+    obs->ipr = FP_ONE - fp_mul(cos_half, cos_half);
 
-    // Reynolds informacional: Re ∝ |O_n| / η
+    // Reynolds informacional: Re ∝ |O_n| / η (división ensanchada, saturante)
     if (state->viscosity != 0) {
-        obs->reynolds_info = (state->O_n << FP_SHIFT) / state->viscosity;
+        obs->reynolds_info = fp_div(state->O_n, state->viscosity);
     } else {
         obs->reynolds_info = 0;
     }
@@ -126,15 +383,37 @@ void golden_operator_compute_observables(
     obs->centroid_z = dit_cos_fixed(state->theta);
 }
 
-double golden_fabs(double x) {
-    return x < 0 ? -x : x;
+/* ============================================================
+ * OBSERVABLES BAJO DEMANDA
+ *
+ * El latido sólo avanza el estado; los observables (dos cosenos y
+ * una división) se calculan cuando alguien los consulta.
+ * ============================================================ */
+
+void golden_observables_cache_init(GoldenObservablesCache *cache) {
+    cache->generation = 0;
+    cache->valid = 0;
 }
 
-double golden_sqrt(double x) {
-    if (x <= 0) return 0;
-    double res = x;
-    for (int i = 0; i < 10; i++) {
-        res = 0.5 * (res + x / res);
-    }
-    return res;
+const GoldenObservables *golden_operator_get_observables(
+    const GoldenState *state,
+    GoldenObservablesCache *cache
+) {
+    const volatile uint32_t *generation = &state->generation;
+    GoldenState snapshot;
+    uint32_t g;
+
+    do {
+        g = *generation;
+        if (cache->valid && cache->generation == g) return &cache->obs;
+
+        __asm__ __volatile__("" ::: "memory");
+        snapshot = *state;
+        __asm__ __volatile__("" ::: "memory");
+    } while (*generation != g);     /* Un tick interrumpió la copia */
+
+    golden_operator_compute_observables(&snapshot, &cache->obs);
+    cache->generation = g;
+    cache->valid = 1;
+    return &cache->obs;
 }
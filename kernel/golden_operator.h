@@ -24,16 +24,63 @@
 #include <stdint.h>
 #include "../include/dit_physics.h"
 #include "../include/dit_math_fixed.h"
+#include "../include/dit_math.h"
 
 /* ============================================================
  * CONSTANTES FUNDAMENTALES (ahora en dit_physics.h)
  * ============================================================ */
 
 /* Parámetros del scheduling cuasiperiódico */
-#define GOLDEN_SCHEDULING_PHI  0.18       /* Valor usado en el scheduler */
+/* Paso de Weyl del scheduler: frac(n·φ') en 32 bits, el doble del
+ * paso de fase πφ'n del operador (0.18 era racional, 9/50: periodo 50) */
+#define GOLDEN_SCHEDULING_STEP ((uint32_t)(DIT_GOLDEN_PHASE_STEP >> 31))
 #define REYNOLDS_THRESHOLD     2300.0     /* Umbral laminar/turbulento */
 #define CHAOS_THRESHOLD        0.5        /* Umbral OTOC para caos */
 
+/* ============================================================
+ * GENERADOR POR RECURRENCIA DE ROTACIÓN
+ * 
+ *   Ô_n = (-1)^n cos(πφn + δ) = Re(z_n),   z_n = e^{iδ} w^n
+ *   w = e^{iπ(1+φ)}  (la paridad (-1)^n = e^{iπn} va incluida)
+ * 
+ * z_{n+1} = w · z_n: un producto complejo por paso en lugar de un
+ * coseno. Cada GOLDEN_RESYNC_INTERVAL pasos z_n se recalcula exacto
+ * desde la fase en BAM, acotando el error acumulado.
+ * ============================================================ */
+
+#define GOLDEN_RESYNC_INTERVAL  256
+
+/* Salto adelante (golden_operator_advance) */
+#define GOLDEN_ADVANCE_MARGIN     0.15   /* Distancia mínima de θ a 0 y 2π */
+#define GOLDEN_ADVANCE_MAX_ERROR  0.01   /* Cota de |θ_salto - θ_paso| (rad) */
+
+/* w = e^{iπ(1+φ)} y w^4 (paso de las 4 vías del generador por lotes) */
+#define GOLDEN_W_RE        0.36237489008048012762
+#define GOLDEN_W_IM       -0.93203242381322759513
+#define GOLDEN_W4_RE       0.08742572471696040404
+#define GOLDEN_W4_IM       0.99617104086482777259
+
+#define GOLDEN_W_RE_Q30    389097075
+#define GOLDEN_W_IM_Q30    (-1000762195)
+#define GOLDEN_W4_RE_Q30   93872657
+#define GOLDEN_W4_IM_Q30   1069630510
+
+/* Generador en doble precisión */
+typedef struct {
+    double re, im;          /* z_n */
+    uint64_t delta_turn;    /* Desfase δ como fracción de vuelta (Q0.64) */
+    uint32_t n;             /* Índice del próximo Ô_n */
+    uint32_t since_sync;    /* Pasos desde la última resincronización */
+} GoldenGenerator;
+
+/* Generador en punto fijo (z_n en Q2.30, salida en fixed_t) */
+typedef struct {
+    int32_t re, im;         /* z_n en Q2.30 */
+    dit_angle_t delta;      /* Desfase δ en BAM */
+    uint32_t n;             /* Índice del próximo Ô_n */
+    uint32_t since_sync;    /* Pasos desde la última resincronización */
+} GoldenGeneratorFixed;
+
 /* ============================================================
  * ESTRUCTURAS DE ESTADO
  * ============================================================ */
@@ -47,16 +94,25 @@ typedef struct {
     fixed_t entropy;        /* Entropía actual S */
     fixed_t viscosity;      /* Viscosidad η del baño */
     uint32_t n;             /* Paso temporal discreto */
+    GoldenGeneratorFixed gen; /* Recurrencia para Ô_{n+1} */
+    uint32_t generation;    /* +1 en cada paso: invalida los observables */
 } GoldenState;
 
 /* Observables del sistema (punto fijo) */
 typedef struct {
-    fixed_t phase_accumulator; /* Fase acumulada Σ πφn */
+    fixed_t phase_accumulator; /* Fase acumulada πφ'n (mod 2π) */
     fixed_t ipr;               /* Inverse Participation Ratio */
     fixed_t reynolds_info;     /* Número de Reynolds informacional */
     fixed_t centroid_z;        /* Centroide z-finch */
 } GoldenObservables;
 
+/* Observables calculados bajo demanda para una generación del estado */
+typedef struct {
+    GoldenObservables obs;
+    uint32_t generation;    /* GoldenState.generation usada en el cálculo */
+    uint8_t valid;
+} GoldenObservablesCache;
+
 /* ============================================================
  * API PÚBLICA - OPERADOR ÁUREO
  * ============================================================ */
@@ -67,6 +123,16 @@ void golden_operator_init(GoldenState *state);
 /* Evolución metriplética de un paso */
 void golden_operator_step(GoldenState *state);
 
+/*
+ * Avanzar k pasos: equivalente a k llamadas a golden_operator_step,
+ * en O(log k). Fase cuasiperiódica evaluada directamente en n + k y
+ * relajación hacia θ_eq en forma cerrada. Error en θ frente a la
+ * trayectoria paso a paso ≤ GOLDEN_ADVANCE_MAX_ERROR (el step trunca
+ * ~1 LSB por paso y la relajación lo acota en 2^-16 / r).
+ * Usa la FPU: no llamar desde la ISR del latido.
+ */
+void golden_operator_advance(GoldenState *state, uint32_t k);
+
 /* Computar Lagrangianos separados (MANDATO METRIPLÉCTICO) */
 void golden_operator_compute_lagrangian(
     const GoldenState *state,
@@ -74,6 +140,26 @@ void golden_operator_compute_lagrangian(
     fixed_t *L_metr      /* OUT: Parte disipativa */
 );
 
+/* ============================================================
+ * API PÚBLICA - GENERADOR
+ * ============================================================ */
+
+/* Posicionar el generador en Ô_{n0} */
+void golden_generator_init(GoldenGenerator *gen, uint32_t n0, double delta);
+void golden_generator_fixed_init(GoldenGeneratorFixed *gen, uint32_t n0, fixed_t delta);
+
+/* Retornar Ô_n y avanzar a n + 1 */
+double golden_generator_next(GoldenGenerator *gen);
+fixed_t golden_generator_fixed_next(GoldenGeneratorFixed *gen);
+
+/*
+ * Lote: out[k] = Ô_{n0+k}, k = 0 .. count-1, con δ = DIT_DELTA_DEFAULT.
+ * Cuatro vías independientes avanzan con w^4, sin dependencia entre
+ * salidas consecutivas (vectorizable).
+ */
+void golden_operator_generate(uint32_t n0, uint32_t count, double *out);
+void golden_operator_generate_fixed(uint32_t n0, uint32_t count, fixed_t *out);
+
 /* ============================================================
  * API PÚBLICA - OBSERVABLES
  * ============================================================ */
@@ -84,8 +170,18 @@ void golden_operator_compute_observables(
     GoldenObservables *obs
 );
 
-/* Math utilities */
-double golden_fabs(double x);
-double golden_sqrt(double x);
+/* Vaciar la caché de observables */
+void golden_observables_cache_init(GoldenObservablesCache *cache);
+
+/*
+ * Observables del estado actual, calculados sólo si el estado avanzó
+ * desde la última consulta. Seguro frente al latido: si un paso
+ * interrumpe la copia del estado, se vuelve a copiar. Para
+ * consumidores fuera de la ISR (shell, diagnósticos).
+ */
+const GoldenObservables *golden_operator_get_observables(
+    const GoldenState *state,
+    GoldenObservablesCache *cache
+);
 
 #endif /* GOLDEN_OPERATOR_H */
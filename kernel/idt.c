@@ -1,8 +1,11 @@
 #include "idt.h"
 #include "panic.h"
+#include "sched.h"
+#include "paging.h"
 #include "../drivers/bayesian_serial.h"
 
 extern void metriplectic_heartbeat_handler(void);
+extern void metriplectic_heartbeat_deferred(void);
 
 /* Tabla IDT */
 static struct idt_entry idt[256];
@@ -83,7 +86,17 @@ void idt_init(void) {
 }
 
 /* Handler genérico llamado desde los stubs */
-void isr_handler(uint32_t int_no) {
+InterruptFrame *isr_handler(InterruptFrame *frame) {
+    uint32_t int_no = frame->int_no;
+
+    /* Fallo de página (#PF) en una arena: se respalda y se reintenta */
+    if (int_no == 14 && paging_handle_fault(frame)) {
+        return frame;
+    }
+    if (int_no == 14 && paging_fault_address() < PAGING_NULL_GUARD) {
+        panic("NULL pointer dereference (page 0 not mapped)");
+    }
+
     /* Excepciones de CPU (0-31) */
     if (int_no < 32) {
         char msg[64] = "CPU Exception: ";
@@ -104,4 +117,16 @@ void isr_handler(uint32_t int_no) {
         }
         outb(PIC1_COMMAND, PIC_EOI);
     }
+
+    /* Trabajo diferido del latido: barrido de memoria con presupuesto */
+    if (int_no == 32) {
+        metriplectic_heartbeat_deferred();
+    }
+
+    /* Expropiación tras el latido o cesión voluntaria (con el EOI ya enviado) */
+    if (int_no == 32 || int_no == SCHED_YIELD_VECTOR) {
+        return sched_interrupt(frame, int_no == SCHED_YIELD_VECTOR);
+    }
+
+    return frame;
 }
@@ -22,8 +22,22 @@ struct idt_ptr {
     uint32_t base;          /* Dirección base de la IDT */
 } __attribute__((packed));
 
+/*
+ * Marco que common_isr_handler deja en la pila, de la dirección más
+ * baja a la más alta. Sin cambio de privilegio la CPU no empuja SS/ESP.
+ */
+typedef struct {
+    uint32_t ds;
+    uint32_t edi, esi, ebp, esp_unused, ebx, edx, ecx, eax;  /* pushad */
+    uint32_t int_no, err_code;
+    uint32_t eip, cs, eflags;                                /* CPU */
+} InterruptFrame;
+
 /* Funciones públicas */
 void idt_init(void);
 void idt_set_gate(uint8_t num, uint32_t base, uint16_t sel, uint8_t flags);
 
+/* Despacho común; retorna el marco a restaurar (ver sched_interrupt) */
+InterruptFrame *isr_handler(InterruptFrame *frame);
+
 #endif /* IDT_H */
@@ -39,9 +39,9 @@ common_isr_handler:
     mov fs, ax
     mov gs, ax
     
-    push esp    ; Pass pointer to registers (optional, but good practice)
+    push esp    ; InterruptFrame* para isr_handler
     call isr_handler
-    add esp, 4
+    mov esp, eax ; Marco a restaurar: el mismo o el de otro hilo (sched)
     
     pop eax     ; Restore data segment
     mov ds, ax
@@ -7,7 +7,7 @@
  * Arquitectura:
  * 1. Inicialización de drivers (VGA, Serial)
  * 2. Inicialización del operador áureo
- * 3. Loop principal con evolución metriplética
+ * 3. Hilos concurrentes: simulación láser, shell y telemetría
  * 4. Visualización de diagnósticos
  */
 
@@ -15,19 +15,32 @@
 #include "../drivers/bayesian_serial.h"
 #include "golden_operator.h"
 #include "ql_bridge.h"
+#include "laser_cache.h"
+#include "slab.h"
+#include "paging.h"
 #include "shell.h"
 #include "idt.h"
+#include "sched.h"
 #include "../drivers/metriplectic_heartbeat.h"
 #include "panic.h"
 
 
 /* Global state for the Metriplectic heart */
 GoldenState current_golden_state;
-GoldenObservables current_golden_obs;
+GoldenObservablesCache current_golden_obs;
+
+/* Pesos del scheduler (fracción de CPU entre tareas listas) */
+#define TASK_WEIGHT_SHELL     2
+#define TASK_WEIGHT_LASER     4
+#define TASK_WEIGHT_TELEMETRY 1
+
+#define TELEMETRY_PERIOD_MS   1000
 
 /* Forward declarations */
 extern void memory_init(void);
 extern void memory_timestep(uint32_t global_time);
+extern void memory_zero_pool_refill(void);
+extern void memory_compact(uint32_t budget_cycles);
 
 /* ============================================================
  * BANNER DEL SISTEMA
@@ -49,16 +62,6 @@ static const char *banner[] = {
     0
 };
 
-/* ============================================================
- * FUNCIÓN DE DELAY (Sin timer, basado en ciclos)
- * ============================================================ */
-
-static void delay(uint32_t cycles) {
-    for (volatile uint32_t i = 0; i < cycles; i++) {
-        __asm__ __volatile__("nop");
-    }
-}
-
 /* ============================================================
  * MOSTRAR BANNER
  * ============================================================ */
@@ -99,33 +102,33 @@ static void display_operator_state(const GoldenState *state, const GoldenObserva
         vga_holographic_set_color(COLOR_DISSIPATIVE, VGA_COLOR_BLACK);
     }
     vga_holographic_write("O_n=");
-    vga_holographic_write_float(state->O_n, 4);
+    vga_holographic_write_float(fp_to_double(state->O_n), 4);
     vga_holographic_write("  ");
     
     /* θ (ángulo de Bloch) - color según región */
-    if (state->theta < 1.0) {
+    if (state->theta < FP_ONE) {
         vga_holographic_set_color(COLOR_COHERENT, VGA_COLOR_BLACK);
-    } else if (state->theta < 3.14159) {
+    } else if (state->theta < PI_FP) {
         vga_holographic_set_color(COLOR_TRANSITION, VGA_COLOR_BLACK);
     } else {
         vga_holographic_set_color(COLOR_DISSIPATIVE, VGA_COLOR_BLACK);
     }
     vga_holographic_write("theta=");
-    vga_holographic_write_float(state->theta, 4);
+    vga_holographic_write_float(fp_to_double(state->theta), 4);
     
     /* Serial output (más detallado) */
     bayesian_serial_write("[n=");
     bayesian_serial_write_decimal(state->n);
     bayesian_serial_write("] O_n=");
-    bayesian_serial_write_float(state->O_n, 6);
+    bayesian_serial_write_float(fp_to_double(state->O_n), 6);
     bayesian_serial_write(" theta=");
-    bayesian_serial_write_float(state->theta, 6);
+    bayesian_serial_write_float(fp_to_double(state->theta), 6);
     bayesian_serial_write(" L_symp=");
-    bayesian_serial_write_float(state->L_symp, 6);
+    bayesian_serial_write_float(fp_to_double(state->L_symp), 6);
     bayesian_serial_write(" L_metr=");
-    bayesian_serial_write_float(state->L_metr, 6);
+    bayesian_serial_write_float(fp_to_double(state->L_metr), 6);
     bayesian_serial_write(" Re_psi=");
-    bayesian_serial_write_float(obs->reynolds_info, 2);
+    bayesian_serial_write_float(fp_to_double(obs->reynolds_info), 2);
     bayesian_serial_write("\n");
 }
 
@@ -136,8 +139,8 @@ static void display_operator_state(const GoldenState *state, const GoldenObserva
 static void display_lagrangian_competition(const GoldenState *state) {
     double ratio;
     
-    if (golden_fabs(state->L_metr) > 1e-10) {
-        ratio = golden_fabs(state->L_symp) / golden_fabs(state->L_metr);
+    if (state->L_metr != 0) {
+        ratio = dit_fabs(fp_to_double(state->L_symp)) / dit_fabs(fp_to_double(state->L_metr));
     } else {
         ratio = 999.99;
     }
@@ -149,14 +152,14 @@ static void display_lagrangian_competition(const GoldenState *state) {
     /* Visualización de la competencia */
     vga_holographic_set_color(VGA_COLOR_LIGHT_GREEN, VGA_COLOR_BLACK);
     vga_holographic_write("L_symp=");
-    vga_holographic_write_float(state->L_symp, 4);
+    vga_holographic_write_float(fp_to_double(state->L_symp), 4);
     
     vga_holographic_set_color(VGA_COLOR_LIGHT_GREY, VGA_COLOR_BLACK);
     vga_holographic_write(" vs ");
     
     vga_holographic_set_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK);
     vga_holographic_write("L_metr=");
-    vga_holographic_write_float(state->L_metr, 4);
+    vga_holographic_write_float(fp_to_double(state->L_metr), 4);
     
     vga_holographic_set_color(VGA_COLOR_YELLOW, VGA_COLOR_BLACK);
     vga_holographic_write(" [ratio=");
@@ -164,6 +167,44 @@ static void display_lagrangian_competition(const GoldenState *state) {
     vga_holographic_write("]");
 }
 
+/* ============================================================
+ * HILOS DEL KERNEL
+ * ============================================================ */
+
+static void laser_task(void) {
+    vga_holographic_set_color(VGA_COLOR_LIGHT_MAGENTA, VGA_COLOR_BLACK);
+    vga_holographic_write("\n[QL] Starting Quantum Laser Program...\n");
+    quantum_program();
+    bayesian_serial_write("[QL] Quantum Program Terminated.\n");
+}
+
+/* Latido por serial cada segundo, con CPU y latencia por tarea */
+static void telemetry_task(void) {
+    while (1) {
+        sched_sleep(TELEMETRY_PERIOD_MS);
+
+        bayesian_serial_write("[HEARTBEAT] t=");
+        bayesian_serial_write_decimal(metriplectic_heartbeat_get_ticks());
+        bayesian_serial_write("ms O_n=");
+        bayesian_serial_write_float(fp_to_double(current_golden_state.O_n), 6);
+        bayesian_serial_write("\n");
+
+        SchedTaskStats st;
+        for (uint32_t id = 0; id < SCHED_MAX_TASKS; id++) {
+            if (!sched_get_stats(id, &st)) continue;
+            bayesian_serial_write("[SCHED] ");
+            bayesian_serial_write(st.name);
+            bayesian_serial_write(" cpu=");
+            bayesian_serial_write_decimal(st.cpu_ticks);
+            bayesian_serial_write("ms runs=");
+            bayesian_serial_write_decimal(st.dispatches);
+            bayesian_serial_write(" lat_max=");
+            bayesian_serial_write_decimal(st.latency_max);
+            bayesian_serial_write("ms\n");
+        }
+    }
+}
+
 /* ============================================================
  * KERNEL MAIN - Punto de entrada desde assembly
  * ============================================================ */
@@ -184,9 +225,13 @@ void kernel_main(void) {
      * ======================================== */
     
     memory_init();
+    paging_init();
+    slab_init();
+    laser_cache_init();
     
     /* Configurar estado global del operador áureo */
     golden_operator_init(&current_golden_state);
+    golden_observables_cache_init(&current_golden_obs);
     
     /* Inicializar Interrupciones (IDT + PIC) */
     idt_init();
@@ -194,6 +239,9 @@ void kernel_main(void) {
     /* Inicializar Latido Metriplético (PIT) */
     metriplectic_heartbeat_init();
     
+    /* Este flujo pasa a ser el hilo del shell */
+    sched_init("shell", TASK_WEIGHT_SHELL);
+    
     /* Habilitar interrupciones de hardware */
     __asm__ __volatile__ ("sti");
     
@@ -206,20 +254,19 @@ void kernel_main(void) {
 
 
     /* ========================================
-     * FASE QL: Ejecución de programa cuántico
+     * FASE QL: programa cuántico y telemetría en sus propios hilos
      * ======================================== */
-    vga_holographic_set_color(VGA_COLOR_LIGHT_MAGENTA, VGA_COLOR_BLACK);
-    vga_holographic_write("\n[QL] Starting Quantum Laser Program...\n");
-    quantum_program();
-    vga_holographic_write("[QL] Quantum Program Terminated.\n");
+    sched_spawn("laser", laser_task, TASK_WEIGHT_LASER);
+    sched_spawn("telemetry", telemetry_task, TASK_WEIGHT_TELEMETRY);
 
     /* Darwin shell simulation */
-    delay(2000000);
     shell_init();
     shell_start();
     
-    /* Halt infinito */
+    /* Halt infinito (rellenando la reserva de páginas a cero y compactando) */
     while (1) {
+        memory_zero_pool_refill();
+        memory_compact(SCHED_IDLE_COMPACT_CYCLES);
         __asm__ __volatile__("hlt");
     }
 }
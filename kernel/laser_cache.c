@@ -0,0 +1,233 @@
+/*
+ * Laser Pulse Cache - Implementación
+ * Smopsys Q-CORE
+ *
+ * Tabla fija de LASER_CACHE_ENTRIES huecos con reloj lógico para la
+ * política LRU (el índice es minúsculo: búsqueda lineal). Cada entrada
+ * ocupada es un objeto de la caché slab "laser-cache", así que sus
+ * muestras no pesan en el BSS del kernel mientras el hueco esté libre.
+ * La ρ empaquetada vive en páginas de 4KB del gestor de memoria; al
+ * desalojar para insertar se recicla la entrada de la víctima con su
+ * página, y sólo el reclamador devuelve páginas al gestor.
+ *
+ * El reclamador corre desde el memory_allocate de cualquier hilo y
+ * devuelve la página al buddy en el acto: buscar y copiar una entrada
+ * (o escribirla) se hace entero dentro de sched_irq_save/restore, para
+ * que ningún desalojo se cuele a mitad de la copia.
+ */
+
+#include "laser_cache.h"
+#include "slab.h"
+#include "sched.h"
+
+/* Declaración externa de funciones de MemoryManager.cpp */
+extern uint32_t memory_allocate(uint32_t size);
+extern void memory_discard(uint32_t address);
+extern void memory_register_reclaimer(uint32_t (*reclaim)(uint32_t pages_wanted));
+
+typedef struct {
+    uint64_t key;                       /* laser_params_hash */
+    uint32_t page;                      /* Dirección física de ρ empaquetada */
+    uint32_t dim;                       /* Dimensión de ρ */
+    uint32_t last_use;                  /* Reloj lógico (LRU) */
+    uint32_t num_samples;
+    LaserObservable obs[LASER_CACHE_SAMPLES];
+    uint8_t valid;
+} LaserCacheEntry;
+
+static SlabCache *entry_cache;
+static LaserCacheEntry *cache[LASER_CACHE_ENTRIES];    /* NULL: hueco libre */
+static uint32_t cache_clock = 0;
+static uint32_t cache_hits = 0;
+static uint32_t cache_misses = 0;
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+/* Estado construido de una entrada: sin página ni pulso. Una entrada
+ * vuelve a la caché slab siempre así (cache_drop) */
+static void cache_entry_ctor(void *obj) {
+    LaserCacheEntry *e = (LaserCacheEntry *)obj;
+    e->page = 0;
+    e->valid = 0;
+}
+
+static Complex *cache_page(const LaserCacheEntry *e) {
+    return (Complex *)(uintptr_t)e->page;
+}
+
+/* Hueco de la entrada válida con clave key, o -1 */
+static int cache_find(uint64_t key) {
+    for (uint32_t i = 0; i < LASER_CACHE_ENTRIES; i++) {
+        if (cache[i] && cache[i]->valid && cache[i]->key == key) return (int)i;
+    }
+    return -1;
+}
+
+/* Hueco de la entrada válida menos usada recientemente (-1 si no hay) */
+static int cache_lru(void) {
+    int victim = -1;
+    for (uint32_t i = 0; i < LASER_CACHE_ENTRIES; i++) {
+        if (!cache[i] || !cache[i]->valid) continue;
+        if (victim < 0 || cache[i]->last_use < cache[victim]->last_use) victim = (int)i;
+    }
+    return victim;
+}
+
+/* La ρ de una entrada desalojada se descarta: su página vuelve al buddy
+ * en el acto, sin evaporarse, y la entrada a su caché slab */
+static void cache_drop(uint32_t slot) {
+    LaserCacheEntry *e = cache[slot];
+    cache[slot] = 0;
+    if (e->page) memory_discard(e->page);
+    e->page = 0;
+    e->valid = 0;
+    slab_free(e);
+}
+
+/* ============================================================
+ * API PÚBLICA
+ * ============================================================ */
+
+void laser_cache_init(void) {
+    entry_cache = slab_cache_create("laser-cache", sizeof(LaserCacheEntry), cache_entry_ctor);
+    for (uint32_t i = 0; i < LASER_CACHE_ENTRIES; i++) {
+        cache[i] = 0;
+    }
+    cache_clock = 0;
+    cache_hits = 0;
+    cache_misses = 0;
+
+    memory_register_reclaimer(laser_cache_reclaim);
+}
+
+int laser_cache_lookup(
+    uint64_t key,
+    CMatrix *rho,
+    LaserObservable *obs,
+    uint32_t num_samples
+) {
+    uint32_t flags = sched_irq_save();
+    int slot = cache_find(key);
+    if (slot < 0) {
+        cache_misses++;
+        sched_irq_restore(flags);
+        return 0;
+    }
+
+    LaserCacheEntry *e = cache[slot];
+    e->last_use = ++cache_clock;
+    cache_hits++;
+
+    /* Desempaquetar ρ (fila a fila, dim² elementos contiguos) */
+    const Complex *packed = cache_page(e);
+    rho->rows = e->dim;
+    rho->cols = e->dim;
+    for (uint32_t i = 0; i < e->dim; i++) {
+        for (uint32_t j = 0; j < e->dim; j++) {
+            rho->data[i][j] = packed[i * e->dim + j];
+        }
+    }
+
+    if (num_samples > e->num_samples) num_samples = e->num_samples;
+    for (uint32_t k = 0; k < num_samples; k++) {
+        obs[k] = e->obs[k];
+    }
+
+    sched_irq_restore(flags);
+    return 1;
+}
+
+void laser_cache_store(
+    uint64_t key,
+    const CMatrix *rho,
+    const LaserObservable *obs,
+    uint32_t num_samples
+) {
+    uint32_t dim = rho->rows;
+    if (dim * dim * sizeof(Complex) > LASER_CACHE_PAGE_SIZE) return;
+    if (num_samples > LASER_CACHE_SAMPLES) num_samples = LASER_CACHE_SAMPLES;
+
+    uint32_t flags = sched_irq_save();
+
+    /* Ya presente (p.ej. dos bridges con el mismo pulso): refrescar */
+    int slot = cache_find(key);
+
+    /* Hueco libre con una entrada nueva. slab_alloc puede pedir un slab
+     * al gestor, y éste reclamar de esta misma caché: el hueco aún está
+     * libre, así que el reclamador no lo toca */
+    for (uint32_t i = 0; slot < 0 && i < LASER_CACHE_ENTRIES; i++) {
+        if (!cache[i]) {
+            cache[i] = (LaserCacheEntry *)slab_alloc(entry_cache);
+            if (cache[i]) slot = (int)i;
+            break;
+        }
+    }
+
+    /* Caché llena (o sin memoria para otra entrada): la víctima LRU
+     * cede su entrada y su página */
+    if (slot < 0) slot = cache_lru();
+    if (slot < 0) {
+        sched_irq_restore(flags);
+        return;
+    }
+
+    LaserCacheEntry *e = cache[slot];
+    e->valid = 0;
+    if (!e->page) {
+        /* memory_allocate puede reclamar de esta misma caché: la entrada
+         * ya está invalidada, así que no se desaloja a sí misma. */
+        e->page = memory_allocate(LASER_CACHE_PAGE_SIZE);
+        if (!e->page) {
+            cache_drop((uint32_t)slot);
+            sched_irq_restore(flags);
+            return;
+        }
+    }
+
+    Complex *packed = cache_page(e);
+    for (uint32_t i = 0; i < dim; i++) {
+        for (uint32_t j = 0; j < dim; j++) {
+            packed[i * dim + j] = rho->data[i][j];
+        }
+    }
+
+    for (uint32_t k = 0; k < num_samples; k++) {
+        e->obs[k] = obs[k];
+    }
+
+    e->key = key;
+    e->dim = dim;
+    e->num_samples = num_samples;
+    e->last_use = ++cache_clock;
+    e->valid = 1;
+
+    sched_irq_restore(flags);
+}
+
+uint32_t laser_cache_reclaim(uint32_t pages_wanted) {
+    uint32_t released = 0;
+    uint32_t flags = sched_irq_save();
+
+    while (released < pages_wanted) {
+        int victim = cache_lru();
+        if (victim < 0) break;
+        cache_drop((uint32_t)victim);
+        released++;
+    }
+
+    sched_irq_restore(flags);
+    return released;
+}
+
+void laser_cache_stats(uint32_t *hits, uint32_t *misses, uint32_t *entries) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < LASER_CACHE_ENTRIES; i++) {
+        if (cache[i] && cache[i]->valid) n++;
+    }
+
+    *hits = cache_hits;
+    *misses = cache_misses;
+    *entries = n;
+}
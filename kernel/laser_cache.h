@@ -0,0 +1,55 @@
+/*
+ * Laser Pulse Cache - Smopsys Q-CORE
+ *
+ * Memoización de pulsos: LRU acotada indexada por la huella de los
+ * LaserParams derivados (laser_params_hash). Cada entrada es un objeto
+ * de la caché slab "laser-cache" con las muestras de observables del
+ * pulso, y guarda la ρ final empaquetada (dim² Complex) en una página
+ * del gestor de memoria metriplético.
+ *
+ * Un PULSE repetido con la misma longitud de onda, duración y
+ * polarización copia el resultado en lugar de re-integrar Lindblad.
+ * Bajo presión de memoria el gestor de páginas desaloja entradas,
+ * empezando por la menos usada recientemente.
+ */
+
+#ifndef LASER_CACHE_H
+#define LASER_CACHE_H
+
+#include "quantum_laser.h"
+
+#define LASER_CACHE_ENTRIES   8     /* Pulsos distintos retenidos */
+#define LASER_CACHE_SAMPLES   10    /* Muestras de observables por entrada */
+#define LASER_CACHE_PAGE_SIZE 4096  /* ρ de 16×16 Complex = una página */
+
+/* Inicializar la caché y registrarla como reclamable en el gestor.
+ * Llamar tras slab_init (crea su caché de entradas) */
+void laser_cache_init(void);
+
+/*
+ * Buscar un pulso. En acierto copia ρ y hasta num_samples observables
+ * y retorna 1; en fallo retorna 0 sin tocar las salidas.
+ */
+int laser_cache_lookup(
+    uint64_t key,
+    CMatrix *rho,           /* ρ final (salida) */
+    LaserObservable *obs,   /* Observables (salida) */
+    uint32_t num_samples
+);
+
+/* Guardar el resultado de un pulso, desalojando la entrada LRU si hace falta */
+void laser_cache_store(
+    uint64_t key,
+    const CMatrix *rho,
+    const LaserObservable *obs,
+    uint32_t num_samples
+);
+
+/* Desalojar entradas LRU hasta liberar pages_wanted páginas.
+ * Retorna las páginas devueltas al gestor. */
+uint32_t laser_cache_reclaim(uint32_t pages_wanted);
+
+/* Estadísticas de la caché */
+void laser_cache_stats(uint32_t *hits, uint32_t *misses, uint32_t *entries);
+
+#endif /* LASER_CACHE_H */
@@ -6,7 +6,7 @@
  */
 
 #include "lindblad.h"
-#include "golden_operator.h"  /* Para golden_sqrt, golden_fabs */
+#include "../include/dit_math.h"
 
 /* ============================================================
  * OPERACIONES CON MATRICES
@@ -131,6 +131,142 @@ Complex cmatrix_trace(const CMatrix *A) {
     return tr;
 }
 
+/* ============================================================
+ * MATRICES DISPERSAS (COO)
+ * ============================================================ */
+
+void smatrix_init(SMatrix *m, uint32_t dim) {
+    m->nnz = 0;
+    m->dim = dim;
+    m->overflow = 0;
+}
+
+int smatrix_push(SMatrix *m, uint32_t i, uint32_t j, Complex v) {
+    if (v.re == 0.0 && v.im == 0.0) return 1;
+    if (m->nnz >= LINDBLAD_MAX_NNZ) {
+        m->overflow = 1;
+        return 0;
+    }
+    
+    m->row[m->nnz] = (uint16_t)i;
+    m->col[m->nnz] = (uint16_t)j;
+    m->val[m->nnz] = v;
+    m->nnz++;
+    return 1;
+}
+
+int smatrix_from_dense(SMatrix *dst, const CMatrix *src) {
+    smatrix_init(dst, src->rows);
+    for (uint32_t i = 0; i < src->rows; i++) {
+        for (uint32_t j = 0; j < src->cols; j++) {
+            smatrix_push(dst, i, j, src->data[i][j]);
+        }
+    }
+    return !dst->overflow;
+}
+
+void smatrix_to_dense(CMatrix *dst, const SMatrix *src) {
+    cmatrix_zero(dst, src->dim, src->dim);
+    for (uint32_t e = 0; e < src->nnz; e++) {
+        Complex *d = &dst->data[src->row[e]][src->col[e]];
+        *d = complex_add(*d, src->val[e]);
+    }
+}
+
+void smatrix_scale(SMatrix *m, Complex s) {
+    for (uint32_t e = 0; e < m->nnz; e++) {
+        m->val[e] = complex_mul(s, m->val[e]);
+    }
+}
+
+void smatrix_mul_acc(CMatrix *C, const SMatrix *A, const CMatrix *B, Complex s) {
+    uint32_t n = B->cols;
+    for (uint32_t e = 0; e < A->nnz; e++) {
+        Complex v = complex_mul(s, A->val[e]);
+        const Complex *src = B->data[A->col[e]];
+        Complex *dst = C->data[A->row[e]];
+        for (uint32_t j = 0; j < n; j++) {
+            dst[j] = complex_add(dst[j], complex_mul(v, src[j]));
+        }
+    }
+}
+
+void smatrix_rmul_acc(CMatrix *C, const CMatrix *B, const SMatrix *A, Complex s) {
+    uint32_t n = B->rows;
+    for (uint32_t e = 0; e < A->nnz; e++) {
+        Complex v = complex_mul(s, A->val[e]);
+        uint32_t k = A->row[e], j = A->col[e];
+        for (uint32_t i = 0; i < n; i++) {
+            C->data[i][j] = complex_add(C->data[i][j], complex_mul(B->data[i][k], v));
+        }
+    }
+}
+
+void smatrix_rmul_dagger_acc(CMatrix *C, const CMatrix *B, const SMatrix *A, Complex s) {
+    /* (A†)_kj = conj(A_jk): la entrada (j, k, v) de A aporta B_ik · conj(v) a C_ij */
+    uint32_t n = B->rows;
+    for (uint32_t e = 0; e < A->nnz; e++) {
+        Complex v = complex_mul(s, complex_conj(A->val[e]));
+        uint32_t j = A->row[e], k = A->col[e];
+        for (uint32_t i = 0; i < n; i++) {
+            C->data[i][j] = complex_add(C->data[i][j], complex_mul(B->data[i][k], v));
+        }
+    }
+}
+
+/* Counting sort de las entradas por clave (fila o columna), O(nnz + d):
+ * las de clave r quedan en order[start[r] .. start[r + 1]) */
+static void smatrix_group(
+    uint16_t *order,
+    uint32_t *start,
+    const uint16_t *key,
+    uint32_t nnz,
+    uint32_t dim
+) {
+    for (uint32_t r = 0; r <= dim; r++) start[r] = 0;
+    for (uint32_t e = 0; e < nnz; e++) start[key[e] + 1]++;
+    for (uint32_t r = 0; r < dim; r++) start[r + 1] += start[r];
+    for (uint32_t e = 0; e < nnz; e++) order[start[key[e]]++] = (uint16_t)e;
+    /* start[r] apunta ahora al final del grupo r; restaurar inicios */
+    for (uint32_t r = dim; r > 0; r--) start[r] = start[r - 1];
+    start[0] = 0;
+}
+
+/*
+ * L†L disperso: (L†L)_ij = Σ_k conj(L_ki) L_kj.
+ * La fila i se acumula en un vector denso de d elementos: cada L_ki
+ * recorre la fila k de L y los productos de igual columna j se suman
+ * en acc[j]. Sin duplicados, el resultado tiene a lo sumo d² entradas
+ * (un L denso daría Σ nnz_k² productos sueltos). Retorna 0 si desborda.
+ */
+static int smatrix_dagger_mul_self(SMatrix *dst, const SMatrix *L) {
+    static uint16_t by_row[LINDBLAD_MAX_NNZ], by_col[LINDBLAD_MAX_NNZ];
+    static uint32_t row_start[LINDBLAD_MAX_DIM + 1], col_start[LINDBLAD_MAX_DIM + 1];
+    static Complex acc[LINDBLAD_MAX_DIM];
+    uint32_t dim = L->dim;
+    
+    smatrix_init(dst, dim);
+    smatrix_group(by_row, row_start, L->row, L->nnz, dim);
+    smatrix_group(by_col, col_start, L->col, L->nnz, dim);
+    
+    for (uint32_t i = 0; i < dim; i++) {
+        for (uint32_t j = 0; j < dim; j++) acc[j] = complex_make(0.0, 0.0);
+        
+        for (uint32_t a = col_start[i]; a < col_start[i + 1]; a++) {
+            uint32_t ea = by_col[a];
+            uint32_t k = L->row[ea];
+            Complex ca = complex_conj(L->val[ea]);
+            for (uint32_t b = row_start[k]; b < row_start[k + 1]; b++) {
+                uint32_t eb = by_row[b];
+                acc[L->col[eb]] = complex_add(acc[L->col[eb]], complex_mul(ca, L->val[eb]));
+            }
+        }
+        
+        for (uint32_t j = 0; j < dim; j++) smatrix_push(dst, i, j, acc[j]);
+    }
+    return !dst->overflow;
+}
+
 /* ============================================================
  * SISTEMA DE LINDBLAD
  * ============================================================ */
@@ -138,131 +274,228 @@ Complex cmatrix_trace(const CMatrix *A) {
 void lindblad_init(LindbladSystem *sys, uint32_t dim) {
     sys->dim = dim;
     sys->num_ops = 0;
-    cmatrix_zero(&sys->H, dim, dim);
+    sys->num_drives = 0;
+    smatrix_init(&sys->H, dim);
+    
+    for (uint32_t k = 0; k < LINDBLAD_MAX_OPS; k++) sys->rate_env[k] = 0;
+    for (uint32_t i = 0; i < LINDBLAD_MAX_DRIVES; i++) sys->drive_env[i] = 0;
 }
 
-void lindblad_set_hamiltonian(LindbladSystem *sys, const CMatrix *H) {
-    cmatrix_copy(&sys->H, H);
+int lindblad_set_hamiltonian(LindbladSystem *sys, const CMatrix *H) {
+    return smatrix_from_dense(&sys->H, H);
 }
 
-void lindblad_add_jump_operator(LindbladSystem *sys, const CMatrix *L, double gamma) {
-    if (sys->num_ops >= LINDBLAD_MAX_OPS) return;
+int lindblad_set_hamiltonian_sparse(LindbladSystem *sys, const SMatrix *H) {
+    sys->H = *H;
+    return !H->overflow;
+}
+
+int lindblad_add_jump_operator(LindbladSystem *sys, const CMatrix *L, double gamma) {
+    static SMatrix L_sp;
+    if (!smatrix_from_dense(&L_sp, L)) return 0;
+    return lindblad_add_jump_operator_sparse(sys, &L_sp, gamma);
+}
+
+int lindblad_add_jump_operator_sparse(LindbladSystem *sys, const SMatrix *L, double gamma) {
+    if (sys->num_ops >= LINDBLAD_MAX_OPS || L->overflow) return 0;
     
     uint32_t idx = sys->num_ops;
     
     /* L_k = sqrt(gamma) * L */
-    double sqrt_gamma = golden_sqrt(gamma);
-    cmatrix_copy(&sys->L_ops[idx], L);
-    cmatrix_scale(&sys->L_ops[idx], complex_make(sqrt_gamma, 0.0));
+    double sqrt_gamma = dit_sqrt(gamma);
+    sys->L_ops[idx] = *L;
+    smatrix_scale(&sys->L_ops[idx], complex_make(sqrt_gamma, 0.0));
     
-    /* L_k† */
-    cmatrix_dagger(&sys->L_dag[idx], &sys->L_ops[idx]);
-    
-    /* L_k† L_k */
-    cmatrix_mul(&sys->L_dag_L[idx], &sys->L_dag[idx], &sys->L_ops[idx]);
+    /* L_k† L_k (si desborda, el hueco no se cuenta) */
+    if (!smatrix_dagger_mul_self(&sys->L_dag_L[idx], &sys->L_ops[idx])) return 0;
     
     sys->num_ops++;
+    return 1;
+}
+
+int lindblad_add_drive(LindbladSystem *sys, const CMatrix *H_i, const PulseEnvelope *f) {
+    static SMatrix H_sp;
+    if (!smatrix_from_dense(&H_sp, H_i)) return 0;
+    return lindblad_add_drive_sparse(sys, &H_sp, f);
+}
+
+int lindblad_add_drive_sparse(LindbladSystem *sys, const SMatrix *H_i, const PulseEnvelope *f) {
+    if (sys->num_drives >= LINDBLAD_MAX_DRIVES || H_i->overflow) return 0;
+    
+    sys->H_drive[sys->num_drives] = *H_i;
+    sys->drive_env[sys->num_drives] = f;
+    sys->num_drives++;
+    return 1;
+}
+
+void lindblad_set_rate_envelope(LindbladSystem *sys, uint32_t k, const PulseEnvelope *s) {
+    if (k >= LINDBLAD_MAX_OPS) return;
+    sys->rate_env[k] = s;
 }
 
 /* ============================================================
  * CÁLCULO DE dρ/dt (LINDBLAD RHS)
  * 
- * dρ/dt = -i[H, ρ] + Σ_k (L_k ρ L_k† - ½{L_k† L_k, ρ})
+ * dρ/dt = -i[H(t), ρ] + Σ_k s_k(t) (L_k ρ L_k† - ½{L_k† L_k, ρ})
+ * 
+ * Cada término es un producto disperso × denso: O(nnz·d).
  * ============================================================ */
 
-void lindblad_compute_terms(
+/* U += -i·f·[A, ρ] */
+static void lindblad_commutator_acc(CMatrix *U, const SMatrix *A, const CMatrix *rho, double f) {
+    smatrix_mul_acc(U, A, rho, complex_make(0.0, -f));
+    smatrix_rmul_acc(U, rho, A, complex_make(0.0, f));
+}
+
+void lindblad_compute_terms_t(
     const LindbladSystem *sys,
     const CMatrix *rho,
+    double t,
     CMatrix *unitary_term,
     CMatrix *dissipative_term
 ) {
     uint32_t dim = sys->dim;
     
-    /* Término unitario: -i[H, ρ] */
-    cmatrix_commutator(unitary_term, &sys->H, rho);
-    cmatrix_scale(unitary_term, complex_make(0.0, -1.0));  /* -i */
+    /* Término unitario: -i[H(t), ρ], H(t) = H_0 + Σ f_i(t) H_i */
+    cmatrix_zero(unitary_term, dim, dim);
+    lindblad_commutator_acc(unitary_term, &sys->H, rho, 1.0);
+    
+    for (uint32_t i = 0; i < sys->num_drives; i++) {
+        double f = sys->drive_env[i] ? envelope_eval(sys->drive_env[i], t) : 1.0;
+        if (f == 0.0) continue;
+        lindblad_commutator_acc(unitary_term, &sys->H_drive[i], rho, f);
+    }
     
     /* Término disipativo */
     cmatrix_zero(dissipative_term, dim, dim);
     
     for (uint32_t k = 0; k < sys->num_ops; k++) {
-        static CMatrix LrhoLd, anticomm, term, Lrho;
-        
-        /* L_k ρ L_k† */
-        cmatrix_mul(&Lrho, &sys->L_ops[k], rho);
-        cmatrix_mul(&LrhoLd, &Lrho, &sys->L_dag[k]);
+        static CMatrix Lrho;
         
-        /* {L_k† L_k, ρ} */
-        cmatrix_anticommutator(&anticomm, &sys->L_dag_L[k], rho);
+        /* γ_k(t) / γ_k: un canal apagado no cuesta productos */
+        double s = sys->rate_env[k] ? envelope_eval(sys->rate_env[k], t) : 1.0;
+        if (s == 0.0) continue;
         
-        /* L_k ρ L_k† - 0.5 * {L_k† L_k, ρ} */
-        cmatrix_add_scaled(&term, &LrhoLd, &anticomm, complex_make(-0.5, 0.0));
+        /* s · L_k ρ L_k† */
+        cmatrix_zero(&Lrho, dim, dim);
+        smatrix_mul_acc(&Lrho, &sys->L_ops[k], rho, complex_make(1.0, 0.0));
+        smatrix_rmul_dagger_acc(dissipative_term, &Lrho, &sys->L_ops[k], complex_make(s, 0.0));
         
-        /* Acumular */
-        cmatrix_add(dissipative_term, dissipative_term, &term);
+        /* - s/2 · {L_k† L_k, ρ} */
+        smatrix_mul_acc(dissipative_term, &sys->L_dag_L[k], rho, complex_make(-0.5 * s, 0.0));
+        smatrix_rmul_acc(dissipative_term, rho, &sys->L_dag_L[k], complex_make(-0.5 * s, 0.0));
     }
 }
 
-void lindblad_rhs(const LindbladSystem *sys, const CMatrix *rho, CMatrix *drho_dt) {
+void lindblad_compute_terms(
+    const LindbladSystem *sys,
+    const CMatrix *rho,
+    CMatrix *unitary_term,
+    CMatrix *dissipative_term
+) {
+    lindblad_compute_terms_t(sys, rho, 0.0, unitary_term, dissipative_term);
+}
+
+void lindblad_rhs_t(const LindbladSystem *sys, const CMatrix *rho, double t, CMatrix *drho_dt) {
     static CMatrix unitary, dissipative;
     
-    lindblad_compute_terms(sys, rho, &unitary, &dissipative);
+    lindblad_compute_terms_t(sys, rho, t, &unitary, &dissipative);
     
     /* dρ/dt = unitary + dissipative */
     cmatrix_add(drho_dt, &unitary, &dissipative);
 }
 
+void lindblad_rhs(const LindbladSystem *sys, const CMatrix *rho, CMatrix *drho_dt) {
+    lindblad_rhs_t(sys, rho, 0.0, drho_dt);
+}
+
 /* ============================================================
  * INTEGRACIÓN RK4
  * ============================================================ */
 
-void lindblad_step_rk4(LindbladSystem *sys, CMatrix *rho, double dt) {
+/* Declaración externa de MemoryManager.cpp */
+extern uint32_t memory_handle_alloc(uint32_t size);
+extern uint32_t memory_handle_lock(uint32_t handle);
+extern void memory_handle_unlock(uint32_t handle);
+
+/* Etapas de RK4 (~24KB): un bloque reubicable del gestor de memoria
+ * pedido en el primer paso, no BSS del kernel. Sólo se fija mientras
+ * dura un paso; entre pasos la compactación puede moverlo */
+typedef struct {
+    CMatrix k1, k2, k3, k4, temp, result;
+} LindbladRK4Workspace;
+
+static uint32_t rk4_workspace = 0;     /* Manejador (0: sin pedir) */
+
+int lindblad_step_rk4(LindbladSystem *sys, CMatrix *rho, double dt) {
+    return lindblad_step_rk4_t(sys, rho, 0.0, dt);
+}
+
+int lindblad_step_rk4_t(LindbladSystem *sys, CMatrix *rho, double t, double dt) {
     uint32_t dim = sys->dim;
-    static CMatrix k1, k2, k3, k4, temp, result;
+    
+    /* Sin memoria: ρ no avanza y el llamador debe saberlo. El manejador
+     * queda a 0 y el siguiente paso lo vuelve a pedir */
+    if (!rk4_workspace) {
+        rk4_workspace = memory_handle_alloc(sizeof(LindbladRK4Workspace));
+        if (!rk4_workspace) return 0;
+    }
+    LindbladRK4Workspace *ws = (LindbladRK4Workspace *)(uintptr_t)memory_handle_lock(rk4_workspace);
+    if (!ws) return 0;
+    CMatrix *k1 = &ws->k1;
+    CMatrix *k2 = &ws->k2;
+    CMatrix *k3 = &ws->k3;
+    CMatrix *k4 = &ws->k4;
+    CMatrix *temp = &ws->temp;
+    CMatrix *result = &ws->result;
+    
     Complex half_dt = complex_make(dt * 0.5, 0.0);
     Complex sixth_dt = complex_make(dt / 6.0, 0.0);
     Complex dt_c = complex_make(dt, 0.0);
     
-    /* k1 = f(rho) */
-    lindblad_rhs(sys, rho, &k1);
+    /* k1 = f(t, rho) */
+    lindblad_rhs_t(sys, rho, t, k1);
     
-    /* k2 = f(rho + dt/2 * k1) */
-    cmatrix_add_scaled(&temp, rho, &k1, half_dt);
-    lindblad_rhs(sys, &temp, &k2);
+    /* k2 = f(t + dt/2, rho + dt/2 * k1) */
+    cmatrix_add_scaled(temp, rho, k1, half_dt);
+    lindblad_rhs_t(sys, temp, t + 0.5 * dt, k2);
     
-    /* k3 = f(rho + dt/2 * k2) */
-    cmatrix_add_scaled(&temp, rho, &k2, half_dt);
-    lindblad_rhs(sys, &temp, &k3);
+    /* k3 = f(t + dt/2, rho + dt/2 * k2) */
+    cmatrix_add_scaled(temp, rho, k2, half_dt);
+    lindblad_rhs_t(sys, temp, t + 0.5 * dt, k3);
     
-    /* k4 = f(rho + dt * k3) */
-    cmatrix_add_scaled(&temp, rho, &k3, dt_c);
-    lindblad_rhs(sys, &temp, &k4);
+    /* k4 = f(t + dt, rho + dt * k3) */
+    cmatrix_add_scaled(temp, rho, k3, dt_c);
+    lindblad_rhs_t(sys, temp, t + dt, k4);
     
     /* rho_new = rho + dt/6 * (k1 + 2*k2 + 2*k3 + k4) */
-    cmatrix_copy(&result, rho);
+    cmatrix_copy(result, rho);
     
     for (uint32_t i = 0; i < dim; i++) {
         for (uint32_t j = 0; j < dim; j++) {
             Complex weighted_sum = complex_add(
-                complex_add(k1.data[i][j], complex_scale(k2.data[i][j], 2.0)),
-                complex_add(complex_scale(k3.data[i][j], 2.0), k4.data[i][j])
+                complex_add(k1->data[i][j], complex_scale(k2->data[i][j], 2.0)),
+                complex_add(complex_scale(k3->data[i][j], 2.0), k4->data[i][j])
             );
-            result.data[i][j] = complex_add(
-                result.data[i][j],
+            result->data[i][j] = complex_add(
+                result->data[i][j],
                 complex_mul(sixth_dt, weighted_sum)
             );
         }
     }
     
-    cmatrix_copy(rho, &result);
+    cmatrix_copy(rho, result);
+    memory_handle_unlock(rk4_workspace);
+    return 1;
 }
 
-void lindblad_evolve(LindbladSystem *sys, CMatrix *rho, double t_total, double dt) {
+int lindblad_evolve(LindbladSystem *sys, CMatrix *rho, double t_total, double dt) {
     double t = 0.0;
     while (t < t_total) {
-        lindblad_step_rk4(sys, rho, dt);
+        if (!lindblad_step_rk4_t(sys, rho, t, dt)) return 0;
         t += dt;
     }
+    return 1;
 }
 
 /* ============================================================
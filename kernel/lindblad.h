@@ -11,20 +11,40 @@
  * Mandato Metripléctico:
  * - L_symp: Evolución unitaria -i[H, ρ]
  * - L_metr: Términos de Lindblad (disipación)
+ * 
+ * Representación: H, L_k y L_k†L_k se almacenan dispersos (SMatrix,
+ * COO). El RHS usa productos disperso × denso, O(nnz·d) por término
+ * en lugar de O(d³); ρ permanece densa.
+ * 
+ * Dependencia temporal (opcional):
+ *   H(t)   = H_0 + Σ_i f_i(t) H_i      (lindblad_add_drive)
+ *   γ_k(t) = γ_k · s_k(t)              (lindblad_set_rate_envelope)
+ * Las envolventes están pre-tabuladas (pulse_envelope.h); el
+ * integrador sólo las interpola, nunca reconstruye matrices.
  */
 
 #ifndef LINDBLAD_H
 #define LINDBLAD_H
 
 #include <stdint.h>
+#include "pulse_envelope.h"
 
 /* ============================================================
  * CONFIGURACIÓN DEL SISTEMA
  * ============================================================ */
 
-/* Dimensiones máximas (para bare-metal sin malloc) */
+/* Dimensiones máximas (para bare-metal sin malloc). El coste de
+ * memoria crece con MAX_DIM²: cada CMatrix ocupa 16·MAX_DIM² bytes */
+#ifndef LINDBLAD_MAX_DIM
 #define LINDBLAD_MAX_DIM      16    /* Dimensión máxima del espacio de Hilbert */
+#endif
 #define LINDBLAD_MAX_OPS      8     /* Número máximo de operadores de salto */
+#define LINDBLAD_MAX_DRIVES   4     /* Términos H_i dependientes del tiempo */
+
+/* No-ceros por operador disperso (por defecto: matriz llena) */
+#ifndef LINDBLAD_MAX_NNZ
+#define LINDBLAD_MAX_NNZ      (LINDBLAD_MAX_DIM * LINDBLAD_MAX_DIM)
+#endif
 
 /* ============================================================
  * ESTRUCTURAS DE DATOS
@@ -49,14 +69,30 @@ typedef struct {
     uint32_t size;
 } CVector;
 
+/* Matriz dispersa en formato de coordenadas (COO).
+ * Las entradas no necesitan orden; los duplicados se suman. */
+typedef struct {
+    uint16_t row[LINDBLAD_MAX_NNZ];
+    uint16_t col[LINDBLAD_MAX_NNZ];
+    Complex val[LINDBLAD_MAX_NNZ];
+    uint32_t nnz;
+    uint32_t dim;
+    uint32_t overflow;      /* 1 si se perdió alguna entrada (matriz llena) */
+} SMatrix;
+
 /* Sistema de Lindblad completo */
 typedef struct {
-    CMatrix H;                          /* Hamiltoniano */
-    CMatrix L_ops[LINDBLAD_MAX_OPS];    /* Operadores de salto L_k */
-    CMatrix L_dag[LINDBLAD_MAX_OPS];    /* L_k† (adjuntos) */
-    CMatrix L_dag_L[LINDBLAD_MAX_OPS];  /* L_k† L_k (precalculado) */
+    SMatrix H;                          /* Hamiltoniano */
+    SMatrix L_ops[LINDBLAD_MAX_OPS];    /* Operadores de salto L_k */
+    SMatrix L_dag_L[LINDBLAD_MAX_OPS];  /* L_k† L_k (precalculado) */
     uint32_t num_ops;                   /* Número de operadores activos */
     uint32_t dim;                       /* Dimensión del sistema */
+    
+    /* Dependencia temporal (NULL = constante) */
+    SMatrix H_drive[LINDBLAD_MAX_DRIVES];                /* H_i */
+    const PulseEnvelope *drive_env[LINDBLAD_MAX_DRIVES]; /* f_i(t) */
+    const PulseEnvelope *rate_env[LINDBLAD_MAX_OPS];     /* s_k(t) */
+    uint32_t num_drives;
 } LindbladSystem;
 
 /* Estado del sistema (matriz densidad) */
@@ -143,6 +179,33 @@ void cmatrix_scale(CMatrix *A, Complex s);
 /* Traza */
 Complex cmatrix_trace(const CMatrix *A);
 
+/* ============================================================
+ * API PÚBLICA - MATRICES DISPERSAS
+ * ============================================================ */
+
+/* Inicializar matriz dispersa vacía de dimensión dim */
+void smatrix_init(SMatrix *m, uint32_t dim);
+
+/* Agregar elemento A_ij += v (ignora ceros). Si está llena retorna 0
+ * y marca m->overflow: la matriz ya no representa al operador */
+int smatrix_push(SMatrix *m, uint32_t i, uint32_t j, Complex v);
+
+/* Conversión densa ↔ dispersa (from_dense retorna 0 si desborda) */
+int smatrix_from_dense(SMatrix *dst, const CMatrix *src);
+void smatrix_to_dense(CMatrix *dst, const SMatrix *src);
+
+/* Escalar: A = s * A */
+void smatrix_scale(SMatrix *m, Complex s);
+
+/* C += s · A · B   (A dispersa, B densa) */
+void smatrix_mul_acc(CMatrix *C, const SMatrix *A, const CMatrix *B, Complex s);
+
+/* C += s · B · A   (A dispersa, B densa) */
+void smatrix_rmul_acc(CMatrix *C, const CMatrix *B, const SMatrix *A, Complex s);
+
+/* C += s · B · A†  (A dispersa, B densa) */
+void smatrix_rmul_dagger_acc(CMatrix *C, const CMatrix *B, const SMatrix *A, Complex s);
+
 /* ============================================================
  * API PÚBLICA - LINDBLAD
  * ============================================================ */
@@ -150,15 +213,33 @@ Complex cmatrix_trace(const CMatrix *A);
 /* Inicializar sistema de Lindblad */
 void lindblad_init(LindbladSystem *sys, uint32_t dim);
 
+/*
+ * Las funciones de construcción retornan 0 si el operador desbordó
+ * LINDBLAD_MAX_NNZ o no quedan huecos; en ese caso no se añade y el
+ * sistema no debe evolucionarse.
+ */
+
 /* Establecer Hamiltoniano */
-void lindblad_set_hamiltonian(LindbladSystem *sys, const CMatrix *H);
+int lindblad_set_hamiltonian(LindbladSystem *sys, const CMatrix *H);
+int lindblad_set_hamiltonian_sparse(LindbladSystem *sys, const SMatrix *H);
 
 /* Agregar operador de salto con tasa gamma */
-void lindblad_add_jump_operator(LindbladSystem *sys, const CMatrix *L, double gamma);
+int lindblad_add_jump_operator(LindbladSystem *sys, const CMatrix *L, double gamma);
+int lindblad_add_jump_operator_sparse(LindbladSystem *sys, const SMatrix *L, double gamma);
+
+/* Agregar término H_i modulado por la envolvente f_i(t) */
+int lindblad_add_drive(LindbladSystem *sys, const CMatrix *H_i, const PulseEnvelope *f);
+int lindblad_add_drive_sparse(LindbladSystem *sys, const SMatrix *H_i, const PulseEnvelope *f);
+
+/* Modular la tasa del operador de salto k: γ_k(t) = γ_k · s_k(t) */
+void lindblad_set_rate_envelope(LindbladSystem *sys, uint32_t k, const PulseEnvelope *s);
 
-/* Calcular dρ/dt dado ρ actual */
+/* Calcular dρ/dt dado ρ actual (t = 0 para sistemas con envolventes) */
 void lindblad_rhs(const LindbladSystem *sys, const CMatrix *rho, CMatrix *drho_dt);
 
+/* Calcular dρ/dt en el instante t */
+void lindblad_rhs_t(const LindbladSystem *sys, const CMatrix *rho, double t, CMatrix *drho_dt);
+
 /* Calcular términos separados (Mandato Metripléctico) */
 void lindblad_compute_terms(
     const LindbladSystem *sys,
@@ -167,15 +248,27 @@ void lindblad_compute_terms(
     CMatrix *dissipative_term   /* Σ L_k ρ L_k† - ½{L_k† L_k, ρ} */
 );
 
+/* Términos separados en el instante t */
+void lindblad_compute_terms_t(
+    const LindbladSystem *sys,
+    const CMatrix *rho,
+    double t,
+    CMatrix *unitary_term,      /* -i[H(t), ρ] */
+    CMatrix *dissipative_term   /* Σ s_k(t) (L_k ρ L_k† - ½{L_k† L_k, ρ}) */
+);
+
 /* ============================================================
  * API PÚBLICA - INTEGRACIÓN TEMPORAL
  * ============================================================ */
 
-/* Paso RK4 */
-void lindblad_step_rk4(LindbladSystem *sys, CMatrix *rho, double dt);
+/* Paso RK4. Devuelve 0 (ρ sin tocar) si no hay espacio de trabajo */
+int lindblad_step_rk4(LindbladSystem *sys, CMatrix *rho, double dt);
+
+/* Paso RK4 desde el instante t (muestrea H(t), γ_k(t) en t, t+dt/2, t+dt) */
+int lindblad_step_rk4_t(LindbladSystem *sys, CMatrix *rho, double t, double dt);
 
-/* Evolucionar por tiempo total */
-void lindblad_evolve(LindbladSystem *sys, CMatrix *rho, double t_total, double dt);
+/* Evolucionar por tiempo total (0 si algún paso falla) */
+int lindblad_evolve(LindbladSystem *sys, CMatrix *rho, double t_total, double dt);
 
 /* ============================================================
  * API PÚBLICA - OBSERVABLES
@@ -0,0 +1,253 @@
+/*
+ * Paginación x86 - Implementación
+ * Smopsys Q-CORE
+ *
+ * Un único directorio de páginas estático (el kernel no cambia de
+ * espacio de direcciones). El primer tramo de 4MB usa una tabla de 4KB
+ * estática para dejar la página 0 sin mapear: desreferenciar NULL (o
+ * un campo de una estructura en NULL) provoca un fallo de página en
+ * lugar de leer la IVT. Las entradas de la ventana de arenas apuntan
+ * a tablas de 4KB pedidas al gestor metriplético cuando hace falta la
+ * primera página del tramo; la RAM del gestor está en el mapa
+ * identidad, así que la dirección de una tabla es también la física.
+ * Las arenas ocupan tramos de 4MB contiguos de la ventana, marcados en
+ * slot_bitmap. Todo el estado se toca con IF=0.
+ */
+
+#include "paging.h"
+#include "sched.h"
+#include "../drivers/bayesian_serial.h"
+
+/* Declaración externa de funciones de MemoryManager.cpp */
+extern uint32_t memory_allocate_zeroed(uint32_t size);
+extern void memory_free(uint32_t address);
+extern uint32_t memory_get_top_address(void);
+
+#define PAGE_SIZE          4096
+#define PDE_SHIFT          22           /* Un PDE cubre 4MB */
+#define PTE_SHIFT          12
+#define PTE_ENTRIES        1024
+
+/* Bits de PDE/PTE */
+#define PG_PRESENT         0x001
+#define PG_WRITE           0x002
+#define PG_LARGE           0x080        /* PDE de 4MB (PSE) */
+#define PG_FRAME           0xFFFFF000u
+
+/* Código de error del fallo de página */
+#define PF_ERR_PRESENT     0x1          /* 1: violación de permisos, no ausencia */
+
+#define CR0_PG             0x80000000u
+#define CR4_PSE            0x00000010u
+#define CPUID_EDX_PSE      (1u << 3)
+
+#define ARENA_SLOTS        (PAGING_ARENA_SIZE / PAGING_LARGE_PAGE)
+#define ARENA_FIRST_PDE    (PAGING_ARENA_BASE >> PDE_SHIFT)
+
+typedef struct {
+    uint32_t base;
+    uint32_t size;              /* Múltiplo de PAGING_LARGE_PAGE */
+    uint32_t committed;         /* Páginas respaldadas */
+    uint8_t used;
+} PagingArena;
+
+static uint32_t page_directory[PTE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+static uint32_t low_table[PTE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+static uint32_t slot_bitmap[ARENA_SLOTS / 32];
+static PagingArena arenas[PAGING_MAX_ARENAS];
+static PagingStats paging;
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+static inline uint32_t read_cr2(void) {
+    uint32_t value;
+    __asm__ __volatile__("mov %%cr2, %0" : "=r"(value));
+    return value;
+}
+
+static inline void reload_cr3(void) {
+    __asm__ __volatile__("mov %0, %%cr3" : : "r"((uint32_t)page_directory) : "memory");
+}
+
+static int cpu_has_pse(void) {
+    uint32_t eax, ebx, ecx, edx;
+    __asm__ __volatile__("cpuid" : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx) : "a"(1));
+    return (edx & CPUID_EDX_PSE) != 0;
+}
+
+static inline int slot_test(uint32_t s) {
+    return (slot_bitmap[s >> 5] >> (s & 31)) & 1;
+}
+
+static void slots_mark(uint32_t first, uint32_t count, int used) {
+    for (uint32_t s = first; s < first + count; s++) {
+        if (used) slot_bitmap[s >> 5] |= 1u << (s & 31);
+        else slot_bitmap[s >> 5] &= ~(1u << (s & 31));
+    }
+}
+
+static PagingArena *arena_containing(uint32_t addr) {
+    for (uint32_t i = 0; i < PAGING_MAX_ARENAS; i++) {
+        PagingArena *a = &arenas[i];
+        if (a->used && addr >= a->base && addr - a->base < a->size) return a;
+    }
+    return 0;
+}
+
+/* Respaldar la página de addr con una página nueva a cero (de la
+ * reserva del gestor: el fallo no limpia si el bucle ocioso llegó antes) */
+static int arena_commit(PagingArena *a, uint32_t addr) {
+    uint32_t *pde = &page_directory[addr >> PDE_SHIFT];
+
+    if (!(*pde & PG_PRESENT)) {
+        uint32_t table = memory_allocate_zeroed(PAGE_SIZE);
+        if (!table) return 0;
+        *pde = table | PG_PRESENT | PG_WRITE;
+    }
+
+    uint32_t frame = memory_allocate_zeroed(PAGE_SIZE);
+    if (!frame) return 0;
+
+    uint32_t *table = (uint32_t *)(*pde & PG_FRAME);
+    table[(addr >> PTE_SHIFT) & (PTE_ENTRIES - 1)] = frame | PG_PRESENT | PG_WRITE;
+    a->committed++;
+    paging.committed_pages++;
+    return 1;
+}
+
+/* ============================================================
+ * API PÚBLICA
+ * ============================================================ */
+
+void paging_init(void) {
+    if (!cpu_has_pse()) {
+        bayesian_serial_write("[INIT] Paging disabled (no PSE)\n");
+        return;
+    }
+
+    /* Identidad: el primer tramo en páginas de 4KB sin la página 0 (el
+     * kernel, la BIOS y la VGA empiezan más arriba) y la RAM del gestor
+     * en páginas de 4MB */
+    uint32_t top = memory_get_top_address();
+    if (top > PAGING_IDENTITY_LIMIT) top = PAGING_IDENTITY_LIMIT;
+    uint32_t pdes = (top + PAGING_LARGE_PAGE - 1) >> PDE_SHIFT;
+    if (pdes == 0) pdes = 1;
+
+    for (uint32_t i = 0; i < PTE_ENTRIES; i++) {
+        low_table[i] = (i == 0) ? 0 : (i << PTE_SHIFT) | PG_PRESENT | PG_WRITE;
+    }
+    page_directory[0] = (uint32_t)low_table | PG_PRESENT | PG_WRITE;
+    for (uint32_t i = 1; i < PTE_ENTRIES; i++) {
+        page_directory[i] = (i < pdes) ? (i << PDE_SHIFT) | PG_PRESENT | PG_WRITE | PG_LARGE : 0;
+    }
+
+    uint32_t cr0, cr4;
+    __asm__ __volatile__("mov %%cr4, %0" : "=r"(cr4));
+    __asm__ __volatile__("mov %0, %%cr4" : : "r"(cr4 | CR4_PSE));
+    reload_cr3();
+    __asm__ __volatile__("mov %%cr0, %0" : "=r"(cr0));
+    __asm__ __volatile__("mov %0, %%cr0" : : "r"(cr0 | CR0_PG) : "memory");
+
+    paging.enabled = 1;
+    paging.identity_top = pdes << PDE_SHIFT;
+    bayesian_serial_write("[INIT] Paging enabled (identity without page 0 + lazy arenas)\n");
+}
+
+uint32_t paging_arena_reserve(uint32_t size) {
+    if (!paging.enabled || size == 0 || size > PAGING_ARENA_SIZE) return 0;
+    uint32_t slots = (size + PAGING_LARGE_PAGE - 1) / PAGING_LARGE_PAGE;
+
+    uint32_t flags = sched_irq_save();
+
+    PagingArena *a = 0;
+    for (uint32_t i = 0; i < PAGING_MAX_ARENAS; i++) {
+        if (!arenas[i].used) {
+            a = &arenas[i];
+            break;
+        }
+    }
+
+    /* Primer hueco de slots tramos libres en la ventana */
+    uint32_t first = ARENA_SLOTS;
+    for (uint32_t s = 0, run = 0; a && s < ARENA_SLOTS; s++) {
+        run = slot_test(s) ? 0 : run + 1;
+        if (run == slots) {
+            first = s + 1 - slots;
+            break;
+        }
+    }
+    if (first == ARENA_SLOTS) {
+        sched_irq_restore(flags);
+        return 0;
+    }
+
+    slots_mark(first, slots, 1);
+    a->base = PAGING_ARENA_BASE + first * PAGING_LARGE_PAGE;
+    a->size = slots * PAGING_LARGE_PAGE;
+    a->committed = 0;
+    a->used = 1;
+    paging.arenas++;
+    paging.reserved_bytes += a->size;
+
+    sched_irq_restore(flags);
+    return a->base;
+}
+
+void paging_arena_release(uint32_t base) {
+    uint32_t flags = sched_irq_save();
+    PagingArena *a = arena_containing(base);
+    if (!a || a->base != base) {
+        sched_irq_restore(flags);
+        return;
+    }
+
+    uint32_t first_pde = base >> PDE_SHIFT;
+    uint32_t slots = a->size / PAGING_LARGE_PAGE;
+    for (uint32_t d = first_pde; d < first_pde + slots; d++) {
+        if (!(page_directory[d] & PG_PRESENT)) continue;
+        uint32_t *table = (uint32_t *)(page_directory[d] & PG_FRAME);
+        for (uint32_t e = 0; e < PTE_ENTRIES; e++) {
+            if (table[e] & PG_PRESENT) memory_free(table[e] & PG_FRAME);
+        }
+        page_directory[d] = 0;
+        memory_free((uint32_t)table);
+    }
+    reload_cr3();   /* Descarta las traducciones de toda la arena */
+
+    slots_mark(first_pde - ARENA_FIRST_PDE, slots, 0);
+    paging.committed_pages -= a->committed;
+    paging.reserved_bytes -= a->size;
+    paging.arenas--;
+    a->used = 0;
+
+    sched_irq_restore(flags);
+}
+
+int paging_handle_fault(InterruptFrame *frame) {
+    uint32_t addr = read_cr2();
+    if (!paging.enabled || (frame->err_code & PF_ERR_PRESENT)) return 0;
+
+    PagingArena *a = arena_containing(addr);
+    if (!a) return 0;
+
+    /* El gestor usa x87: preservar el de la tarea que falló */
+    uint8_t fpu[SCHED_FPU_STATE_SIZE];
+    __asm__ __volatile__("fnsave %0" : "=m"(fpu));
+    int ok = arena_commit(a, addr);
+    __asm__ __volatile__("frstor %0" : : "m"(fpu));
+
+    if (ok) paging.faults++;
+    return ok;
+}
+
+uint32_t paging_fault_address(void) {
+    return read_cr2();
+}
+
+void paging_get_stats(PagingStats *out) {
+    uint32_t flags = sched_irq_save();
+    *out = paging;
+    sched_irq_restore(flags);
+}
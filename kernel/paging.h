@@ -0,0 +1,59 @@
+/*
+ * Paginación x86 - Smopsys Q-CORE
+ *
+ * Mapa identidad de los primeros 4MB (kernel, BIOS, VGA) en páginas de
+ * 4KB, con la página 0 ausente para que desreferenciar NULL falle, y
+ * de toda la RAM del gestor metriplético en páginas de 4MB (PSE): una
+ * entrada de TLB cubre 1024 páginas de simulación. Por encima queda la
+ * ventana de arenas, de PAGING_ARENA_SIZE bytes en tramos de 4MB con
+ * tablas de páginas de 4KB: una arena reserva direcciones sin RAM y
+ * cada página se respalda en el primer acceso (fallo de página →
+ * paging_handle_fault, desde isr_handler), ya puesta a cero.
+ *
+ * Sin PSE en la CPU la paginación queda desactivada y
+ * paging_arena_reserve retorna 0.
+ */
+
+#ifndef PAGING_H
+#define PAGING_H
+
+#include <stdint.h>
+#include "idt.h"
+
+#define PAGING_LARGE_PAGE     0x400000      /* 4MB (PSE) */
+#define PAGING_IDENTITY_LIMIT 0xD0000000u   /* RAM identidad por debajo */
+#define PAGING_ARENA_BASE     PAGING_IDENTITY_LIMIT
+#define PAGING_ARENA_SIZE     0x20000000u   /* 512MB de direcciones */
+#define PAGING_MAX_ARENAS     16
+#define PAGING_NULL_GUARD     0x1000        /* Página 0: sin mapear */
+
+/* Estado de la paginación y de las arenas */
+typedef struct {
+    uint8_t enabled;
+    uint32_t identity_top;      /* Fin del mapa identidad (bytes) */
+    uint32_t arenas;            /* Arenas reservadas */
+    uint32_t reserved_bytes;    /* Direcciones reservadas en la ventana */
+    uint32_t committed_pages;   /* Páginas de 4KB respaldadas */
+    uint32_t faults;            /* Fallos resueltos respaldando una página */
+} PagingStats;
+
+/* Construir el directorio y activar la paginación. Llamar tras
+ * memory_init (el mapa identidad cubre la RAM del gestor) */
+void paging_init(void);
+
+/* Reservar size bytes de arena (en tramos de 4MB); retorna la
+ * dirección virtual o 0 si no hay paginación o sitio */
+uint32_t paging_arena_reserve(uint32_t size);
+
+/* Devolver una arena entera: sus páginas respaldadas vuelven al gestor */
+void paging_arena_release(uint32_t base);
+
+/* Resolver un fallo de página; retorna 0 si no es de una arena */
+int paging_handle_fault(InterruptFrame *frame);
+
+/* Dirección del último fallo de página (CR2) */
+uint32_t paging_fault_address(void);
+
+void paging_get_stats(PagingStats *out);
+
+#endif /* PAGING_H */
@@ -0,0 +1,117 @@
+/*
+ * Pulse Envelopes - Implementación
+ * Smopsys Q-CORE
+ *
+ * Toda la aritmética trascendente vive aquí, en la construcción de
+ * la tabla. envelope_eval() sólo interpola.
+ */
+
+#include "pulse_envelope.h"
+#include "../include/dit_math.h"
+
+#define LN2              0.69314718055994530942
+#define SECH_FWHM_SCALE  1.76274717403908605046   /* 2·acosh(√2) */
+
+static double envelope_shape_value(EnvelopeShape shape, double t,
+                                   double t_center, double fwhm) {
+    double u = t - t_center;
+
+    switch (shape) {
+    case ENVELOPE_GAUSSIAN:
+        return dit_exp(-4.0 * LN2 * u * u / (fwhm * fwhm));
+
+    case ENVELOPE_SECH: {
+        double a = dit_fabs(SECH_FWHM_SCALE * u / fwhm);
+        double e = dit_exp(-a);
+        return 2.0 * e / (1.0 + e * e);
+    }
+
+    case ENVELOPE_SQUARE:
+        return (u >= -0.5 * fwhm && u <= 0.5 * fwhm) ? 1.0 : 0.0;
+
+    default:
+        return 1.0;
+    }
+}
+
+static void envelope_set_window(PulseEnvelope *env, double t_start, double t_end) {
+    env->t_start = t_start;
+    env->t_end = t_end;
+    env->inv_step = (t_end > t_start) ?
+                    (double)ENVELOPE_TABLE_SIZE / (t_end - t_start) : 0.0;
+}
+
+void envelope_describe(
+    PulseEnvelope *env,
+    EnvelopeShape shape,
+    double t_start,
+    double t_end,
+    double t_center,
+    double fwhm,
+    double amplitude
+) {
+    envelope_set_window(env, t_start, t_end);
+    env->shape = shape;
+
+    /* FWHM nula: un intervalo de la tabla */
+    if (fwhm <= 0.0) fwhm = (t_end - t_start) / ENVELOPE_TABLE_SIZE;
+    env->t_center = t_center;
+    env->fwhm = fwhm;
+    env->amplitude = amplitude;
+}
+
+void envelope_tabulate(PulseEnvelope *env) {
+    double step = (env->t_end - env->t_start) / ENVELOPE_TABLE_SIZE;
+
+    for (uint32_t i = 0; i <= ENVELOPE_TABLE_SIZE; i++) {
+        double t = env->t_start + i * step;
+        env->samples[i] = env->amplitude *
+                          envelope_shape_value(env->shape, t, env->t_center, env->fwhm);
+    }
+}
+
+void envelope_build(
+    PulseEnvelope *env,
+    EnvelopeShape shape,
+    double t_start,
+    double t_end,
+    double t_center,
+    double fwhm,
+    double amplitude
+) {
+    envelope_describe(env, shape, t_start, t_end, t_center, fwhm, amplitude);
+    envelope_tabulate(env);
+}
+
+void envelope_build_table(
+    PulseEnvelope *env,
+    double t_start,
+    double t_end,
+    const double *values,
+    uint32_t count
+) {
+    envelope_set_window(env, t_start, t_end);
+    env->shape = ENVELOPE_TABLE;
+    env->t_center = env->fwhm = env->amplitude = 0.0;
+
+    if (count == 0) {
+        for (uint32_t i = 0; i <= ENVELOPE_TABLE_SIZE; i++) env->samples[i] = 0.0;
+        return;
+    }
+    if (count == 1) {
+        for (uint32_t i = 0; i <= ENVELOPE_TABLE_SIZE; i++) env->samples[i] = values[0];
+        return;
+    }
+
+    /* Re-muestreo lineal de count puntos a ENVELOPE_TABLE_SIZE + 1 */
+    for (uint32_t i = 0; i <= ENVELOPE_TABLE_SIZE; i++) {
+        double x = (double)i * (count - 1) / ENVELOPE_TABLE_SIZE;
+        uint32_t j = (uint32_t)x;
+        if (j >= count - 1) {
+            env->samples[i] = values[count - 1];
+        } else {
+            double frac = x - (double)j;
+            env->samples[i] = values[j] + frac * (values[j + 1] - values[j]);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * Pulse Envelopes - Smopsys Q-CORE
+ *
+ * Envolventes temporales pre-tabuladas para Hamiltonianos y tasas
+ * dependientes del tiempo:
+ *
+ *   H(t)   = H_0 + Σ_i f_i(t) H_i
+ *   γ_k(t) = γ_k · s_k(t)
+ *
+ * Las formas (Gaussiana, sech, cuadrada, tabla de usuario) se evalúan
+ * UNA vez al construir la envolvente. Durante la integración sólo se
+ * interpola linealmente la tabla: sin exp(), sin reconstruir matrices.
+ */
+
+#ifndef PULSE_ENVELOPE_H
+#define PULSE_ENVELOPE_H
+
+#include <stdint.h>
+
+/* Número de intervalos de la tabla (ENVELOPE_TABLE_SIZE + 1 muestras) */
+#define ENVELOPE_TABLE_SIZE   256
+
+typedef enum {
+    ENVELOPE_GAUSSIAN = 0,  /* A · exp(-4 ln2 (t - t_c)² / FWHM²) */
+    ENVELOPE_SECH     = 1,  /* A · sech(1.7627 (t - t_c) / FWHM) */
+    ENVELOPE_SQUARE   = 2,  /* A en [t_c - FWHM/2, t_c + FWHM/2], 0 fuera */
+    ENVELOPE_TABLE    = 3   /* Tabla de usuario re-muestreada */
+} EnvelopeShape;
+
+typedef struct {
+    double samples[ENVELOPE_TABLE_SIZE + 1];
+    double t_start;         /* Inicio de la ventana tabulada */
+    double t_end;           /* Fin de la ventana tabulada */
+    double inv_step;        /* ENVELOPE_TABLE_SIZE / (t_end - t_start) */
+    EnvelopeShape shape;
+    double t_center;        /* Forma analítica (no ENVELOPE_TABLE) */
+    double fwhm;
+    double amplitude;
+} PulseEnvelope;
+
+/* ============================================================
+ * CONSTRUCCIÓN (fuera del bucle de integración)
+ * ============================================================ */
+
+/* Envolvente analítica centrada en t_center con anchura FWHM
+ * (envelope_describe + envelope_tabulate) */
+void envelope_build(
+    PulseEnvelope *env,
+    EnvelopeShape shape,
+    double t_start,
+    double t_end,
+    double t_center,
+    double fwhm,
+    double amplitude
+);
+
+/*
+ * Sólo los parámetros de una forma analítica, sin tabular: bastan para
+ * su huella (laser_params_hash) y su máximo. envelope_tabulate evalúa
+ * la tabla antes del primer envelope_eval.
+ */
+void envelope_describe(
+    PulseEnvelope *env,
+    EnvelopeShape shape,
+    double t_start,
+    double t_end,
+    double t_center,
+    double fwhm,
+    double amplitude
+);
+
+void envelope_tabulate(PulseEnvelope *env);
+
+/* Envolvente desde una tabla de usuario equiespaciada en [t_start, t_end] */
+void envelope_build_table(
+    PulseEnvelope *env,
+    double t_start,
+    double t_end,
+    const double *values,
+    uint32_t count
+);
+
+/* ============================================================
+ * EVALUACIÓN (llamada por los integradores)
+ *
+ * Interpolación lineal; fuera de la ventana se mantiene el valor
+ * del extremo correspondiente.
+ * ============================================================ */
+
+static inline double envelope_eval(const PulseEnvelope *env, double t) {
+    double x = (t - env->t_start) * env->inv_step;
+    if (x <= 0.0) return env->samples[0];
+    if (x >= (double)ENVELOPE_TABLE_SIZE) return env->samples[ENVELOPE_TABLE_SIZE];
+
+    uint32_t i = (uint32_t)x;
+    double frac = x - (double)i;
+    return env->samples[i] + frac * (env->samples[i + 1] - env->samples[i]);
+}
+
+#endif /* PULSE_ENVELOPE_H */
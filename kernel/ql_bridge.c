@@ -3,6 +3,9 @@
  */
 #include "ql_bridge.h"
 #include "quantum_laser.h"
+#include "laser_cache.h"
+#include "paging.h"
+#include "sched.h"
 #include "../drivers/bayesian_serial.h"
 #include "golden_operator.h"
 #include <string.h>
@@ -24,12 +27,59 @@ char *strstr(const char *haystack, const char *needle) {
     return NULL;
 }
 
+/* Declaración externa de funciones de MemoryManager.cpp */
+extern uint32_t memory_allocate(uint32_t size);
+
 /* Calibración aproximada para delay (ajustar según QEMU) */
 #define CYCLES_PER_NS 10
 
-void laser_pulse_emit(const char* wavelength, const char* duration, char polarization) {
-    static LindbladSystem sys;
+/* "100ns", "1.5us", "2ms", "1s" → nanosegundos (0 si no se reconoce) */
+static double parse_duration_ns(const char *duration) {
+    double value = 0.0;
+    double frac_scale = 0.0;
+    
+    for (; *duration; duration++) {
+        char c = *duration;
+        if (c >= '0' && c <= '9') {
+            if (frac_scale > 0.0) {
+                value += (c - '0') * frac_scale;
+                frac_scale *= 0.1;
+            } else {
+                value = value * 10.0 + (c - '0');
+            }
+        } else if (c == '.') {
+            frac_scale = 0.1;
+        } else {
+            break;
+        }
+    }
+    
+    if (duration[0] == 'n' && duration[1] == 's') return value;
+    if (duration[0] == 'u' && duration[1] == 's') return value * 1e3;
+    if (duration[0] == 'm' && duration[1] == 's') return value * 1e6;
+    if (duration[0] == 's') return value * 1e9;
+    return 0.0;
+}
+
+/* Sistema de Lindblad del bridge (~100KB): fuera del BSS, en una arena
+ * que sólo respalda las páginas que laser_build_system llega a tocar.
+ * Sin paginación, un bloque del gestor. Se pide una vez y se conserva */
+static LindbladSystem *bridge_system(void) {
+    static LindbladSystem *sys;
+    
+    uint32_t flags = sched_irq_save();
+    if (!sys) {
+        uint32_t addr = paging_arena_reserve(sizeof(LindbladSystem));
+        if (!addr) addr = memory_allocate(sizeof(LindbladSystem));
+        sys = (LindbladSystem *)(uintptr_t)addr;
+    }
+    sched_irq_restore(flags);
+    return sys;
+}
+
+int laser_pulse_emit(const char* wavelength, const char* duration, char polarization) {
     static CMatrix rho;
+    static PulseEnvelope pump_env;
     
     bayesian_serial_write("[LASER] Emitting pulse: ");
     bayesian_serial_write(wavelength);
@@ -47,16 +97,57 @@ void laser_pulse_emit(const char* wavelength, const char* duration, char polariz
     if (strstr(wavelength, "1550")) p.omega_atom = 0.8;
     else if (strstr(wavelength, "405")) p.omega_atom = 2.5;
     
-    p.dt = 0.5;      /* Mucho más rápido para QEMU */
-    p.t_end = 5.0;    /* Pocos pasos para demostración */
+    /* Truncar Fock para que átomo ⊗ cavidad quepa en LINDBLAD_MAX_DIM */
+    p.dim_cavity = LINDBLAD_MAX_DIM / laser_atom_dim(&p);
+    
+    /* Envolvente del pulso: bombeo Gaussiano con FWHM = duración,
+     * centrado en una ventana de dos anchuras. Sus parámetros bastan
+     * para la huella; la tabla sólo se evalúa si hay que integrar. */
+    double width = parse_duration_ns(duration) / QL_NS_PER_TIME_UNIT;
+    if (width <= 0.0) width = 1.0;
+    
+    envelope_describe(&pump_env, ENVELOPE_GAUSSIAN, 0.0, 2.0 * width,
+                      width, width, 1.0);
+    p.pump_envelope = &pump_env;
+    
+    /* El número de pasos crece con la duración que escribe el usuario:
+     * por encima del tope el hilo láser quedaría ocupado minutos u horas */
+    if (laser_set_time_window(&p, 0.0, 2.0 * width, QL_PULSE_STEPS) > QL_MAX_PULSE_STEPS) {
+        bayesian_serial_write("[LASER] Pulse rejected: duration needs more than QL_MAX_PULSE_STEPS RK4 steps.\n");
+        return 0;
+    }
+    
+    /* Pulso repetido: recuperar ρ y observables de la caché */
+    LaserObservable obs[LASER_CACHE_SAMPLES];
+    uint64_t key = laser_params_hash(&p);
     
-    laser_build_system(&p, &sys, &rho);
+    if (laser_cache_lookup(key, &rho, obs, LASER_CACHE_SAMPLES)) {
+        bayesian_serial_write("[LASER] Pulse evolution cached.\n");
+        return 1;
+    }
+    
+    LindbladSystem *sys = bridge_system();
+    if (!sys) {
+        bayesian_serial_write("[LASER] Pulse aborted: no memory for the Lindblad system.\n");
+        return 0;
+    }
     
-    /* Evolución corta para simular el pulso */
-    LaserObservable obs[10];
-    laser_evolve(&p, &sys, &rho, obs, 10);
+    envelope_tabulate(&pump_env);
+    if (!laser_build_system(&p, sys, &rho)) {
+        bayesian_serial_write("[LASER] Pulse rejected: system exceeds LINDBLAD_MAX_DIM.\n");
+        return 0;
+    }
+    
+    /* Evolución corta para simular el pulso. Un ρ a medio integrar
+     * no se guarda: la caché lo serviría como resultado */
+    if (!laser_evolve(&p, sys, &rho, obs, LASER_CACHE_SAMPLES)) {
+        bayesian_serial_write("[LASER] Pulse aborted: no memory for the RK4 workspace.\n");
+        return 0;
+    }
+    laser_cache_store(key, &rho, obs, LASER_CACHE_SAMPLES);
     
     bayesian_serial_write("[LASER] Pulse evolution stabilized.\n");
+    return 1;
 }
 
 void busy_wait_ns(uint32_t ns) {
@@ -8,8 +8,20 @@
 
 #include <stdint.h>
 
-/* Emitir un pulso láser configurado */
-void laser_pulse_emit(const char* wavelength, const char* duration, char polarization);
+/* Escala temporal de la simulación: 1 unidad adimensional = 10 ns */
+#define QL_NS_PER_TIME_UNIT  10.0
+
+/* Pasos RK4 por pulso: al menos QL_PULSE_STEPS; los largos usan más
+ * (dt ≤ laser_max_stable_dt, ~0.27 con los parámetros por defecto) hasta
+ * QL_MAX_PULSE_STEPS, unos 20 µs de pulso */
+#define QL_PULSE_STEPS       40
+#define QL_MAX_PULSE_STEPS   16384
+
+/* Emitir un pulso láser configurado; retorna 0 si el sistema no cabe
+ * en LINDBLAD_MAX_DIM, la duración pide más de QL_MAX_PULSE_STEPS pasos
+ * o falta memoria para integrarlo (en todos los casos no se guarda nada
+ * en la caché) */
+int laser_pulse_emit(const char* wavelength, const char* duration, char polarization);
 
 /* Delay preciso en nanosegundos (emulación ciclos) */
 void busy_wait_ns(uint32_t ns);
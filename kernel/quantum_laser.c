@@ -13,10 +13,15 @@
  *   L_32 = √γ_32 σ_23             (decay 3 → 2)
  *   L_21 = √γ_21 σ_12             (decay 2 → 1)
  *   L_10 = √γ_10 σ_01             (decay 1 → 0)
+ * 
+ * Ensamble de N emisores (base simétrica |n_0 n_1 n_2 n_3⟩ ⊗ |n⟩):
+ *   H = ω_c a†a + ω_a S_22 + g(a† S_12 + a S_21)
+ *   L_κ, L_p, L_32, L_21, L_10 locales + L_col = √γ_col S_12
+ *   (los locales, proyectados a la base simétrica: ver quantum_laser.h)
  */
 
 #include "quantum_laser.h"
-#include "golden_operator.h"
+#include "../include/dit_math.h"
 
 /* ============================================================
  * PARÁMETROS POR DEFECTO
@@ -37,11 +42,76 @@ void laser_params_default(LaserParams *p) {
     p->gamma_21 = 0.01;          /* Emisión espontánea lenta */
     p->gamma_10 = 1.0;           /* Relajación rápida 1 → 0 */
     
+    p->pump_envelope = 0;        /* Bombeo continuo */
+    p->drive_envelope = 0;       /* Sin drive coherente */
+    
+    p->num_atoms = 1;            /* Un único emisor */
+    p->gamma_collective = 0.0;   /* Sin superradiancia */
+    
     p->t_start = 0.0;
     p->t_end = 50.0 / p->kappa;  /* 50 tiempos de vida de cavidad */
     p->dt = 0.01;
 }
 
+/* ============================================================
+ * HUELLA DE PARÁMETROS
+ * ============================================================ */
+
+#define FNV64_OFFSET  0xcbf29ce484222325ULL
+#define FNV64_PRIME   0x00000100000001b3ULL
+
+static uint64_t fnv1a_bytes(uint64_t h, const void *data, uint32_t len) {
+    const uint8_t *b = (const uint8_t *)data;
+    for (uint32_t i = 0; i < len; i++) {
+        h ^= b[i];
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+static uint64_t fnv1a_envelope(uint64_t h, const PulseEnvelope *env) {
+    /* Se hashea el contenido, no el puntero: el bridge reutiliza
+     * la misma envolvente estática para pulsos distintos. Las formas
+     * analíticas quedan fijadas por sus parámetros (no hace falta
+     * tabularlas para buscar en la caché); las de usuario, por la tabla. */
+    uint8_t present = env ? 1 : 0;
+    h = fnv1a_bytes(h, &present, sizeof(present));
+    if (!env) return h;
+    uint32_t shape = (uint32_t)env->shape;
+    h = fnv1a_bytes(h, &shape, sizeof(shape));
+    h = fnv1a_bytes(h, &env->t_start, sizeof(env->t_start));
+    h = fnv1a_bytes(h, &env->t_end, sizeof(env->t_end));
+    if (env->shape == ENVELOPE_TABLE) {
+        return fnv1a_bytes(h, env->samples, sizeof(env->samples));
+    }
+    h = fnv1a_bytes(h, &env->t_center, sizeof(env->t_center));
+    h = fnv1a_bytes(h, &env->fwhm, sizeof(env->fwhm));
+    return fnv1a_bytes(h, &env->amplitude, sizeof(env->amplitude));
+}
+
+uint64_t laser_params_hash(const LaserParams *p) {
+    uint64_t h = FNV64_OFFSET;
+    
+    h = fnv1a_bytes(h, &p->dim_atom, sizeof(p->dim_atom));
+    h = fnv1a_bytes(h, &p->dim_cavity, sizeof(p->dim_cavity));
+    h = fnv1a_bytes(h, &p->omega_atom, sizeof(p->omega_atom));
+    h = fnv1a_bytes(h, &p->omega_cavity, sizeof(p->omega_cavity));
+    h = fnv1a_bytes(h, &p->g, sizeof(p->g));
+    h = fnv1a_bytes(h, &p->kappa, sizeof(p->kappa));
+    h = fnv1a_bytes(h, &p->pump_rate, sizeof(p->pump_rate));
+    h = fnv1a_bytes(h, &p->gamma_32, sizeof(p->gamma_32));
+    h = fnv1a_bytes(h, &p->gamma_21, sizeof(p->gamma_21));
+    h = fnv1a_bytes(h, &p->gamma_10, sizeof(p->gamma_10));
+    h = fnv1a_bytes(h, &p->num_atoms, sizeof(p->num_atoms));
+    h = fnv1a_bytes(h, &p->gamma_collective, sizeof(p->gamma_collective));
+    h = fnv1a_bytes(h, &p->t_start, sizeof(p->t_start));
+    h = fnv1a_bytes(h, &p->t_end, sizeof(p->t_end));
+    h = fnv1a_bytes(h, &p->dt, sizeof(p->dt));
+    
+    h = fnv1a_envelope(h, p->pump_envelope);
+    return fnv1a_envelope(h, p->drive_envelope);
+}
+
 /* ============================================================
  * OPERADORES DEL SISTEMA
  * ============================================================ */
@@ -70,7 +140,7 @@ static void kronecker(CMatrix *C, const CMatrix *A, const CMatrix *B) {
 static void create_annihilation_cavity(CMatrix *a, uint32_t dim_cavity) {
     cmatrix_zero(a, dim_cavity, dim_cavity);
     for (uint32_t n = 1; n < dim_cavity; n++) {
-        a->data[n-1][n] = complex_make(golden_sqrt((double)n), 0.0);
+        a->data[n-1][n] = complex_make(dit_sqrt((double)n), 0.0);
     }
 }
 
@@ -121,17 +191,60 @@ void laser_create_number(CMatrix *N, uint32_t dim_atom, uint32_t dim_cavity) {
 
 /* ============================================================
  * CONSTRUCCIÓN DEL SISTEMA
+ * 
+ * H y los L_k se emiten directamente en forma dispersa a partir de
+ * sus elementos de matriz analíticos en la base |i⟩ ⊗ |n⟩ (índice
+ * i·dim_c + n). Sin temporales densos: el coste es O(nnz).
  * ============================================================ */
 
-void laser_build_system(
+/* a = Σ_i |i⟩⟨i| ⊗ Σ_n √n |n-1⟩⟨n| */
+static void laser_sparse_annihilation(SMatrix *a, uint32_t dim_a, uint32_t dim_c) {
+    smatrix_init(a, dim_a * dim_c);
+    for (uint32_t i = 0; i < dim_a; i++) {
+        for (uint32_t n = 1; n < dim_c; n++) {
+            smatrix_push(a, i * dim_c + n - 1, i * dim_c + n,
+                         complex_make(dit_sqrt((double)n), 0.0));
+        }
+    }
+}
+
+/* a + a† (drive coherente) */
+static void laser_sparse_quadrature(SMatrix *x, uint32_t dim_a, uint32_t dim_c) {
+    smatrix_init(x, dim_a * dim_c);
+    for (uint32_t i = 0; i < dim_a; i++) {
+        for (uint32_t n = 1; n < dim_c; n++) {
+            Complex v = complex_make(dit_sqrt((double)n), 0.0);
+            smatrix_push(x, i * dim_c + n - 1, i * dim_c + n, v);
+            smatrix_push(x, i * dim_c + n, i * dim_c + n - 1, v);
+        }
+    }
+}
+
+/* σ_ij ⊗ I = Σ_n |i,n⟩⟨j,n| */
+static void laser_sparse_sigma(SMatrix *sigma, uint32_t i, uint32_t j,
+                               uint32_t dim_a, uint32_t dim_c) {
+    smatrix_init(sigma, dim_a * dim_c);
+    if (i >= dim_a || j >= dim_a) return;
+    for (uint32_t n = 0; n < dim_c; n++) {
+        smatrix_push(sigma, i * dim_c + n, j * dim_c + n, complex_make(1.0, 0.0));
+    }
+}
+
+uint32_t laser_build_system(
     const LaserParams *p,
     LindbladSystem *sys,
     CMatrix *rho0
 ) {
+    if (p->num_atoms > 1) {
+        return laser_build_ensemble(p, sys, rho0);
+    }
+    
     uint32_t dim_a = p->dim_atom;
     uint32_t dim_c = p->dim_cavity;
     uint32_t dim = dim_a * dim_c;
     
+    if (dim == 0 || dim_a > LINDBLAD_MAX_DIM || dim > LINDBLAD_MAX_DIM) return 0;
+    
     lindblad_init(sys, dim);
     
     /* ========================================
@@ -139,65 +252,62 @@ void laser_build_system(
      * H = ω_c a†a + ω_a |2⟩⟨2| + g(a†σ_12 + a σ_21)
      * ======================================== */
     
-    static CMatrix H, a, a_dag, N, sigma_22, sigma_12, sigma_21;
-    static CMatrix term1, term2, term3, temp;
-    
-    /* a†a (número de fotones) */
-    laser_create_number(&N, dim_a, dim_c);
-    cmatrix_copy(&term1, &N);
-    cmatrix_scale(&term1, complex_make(p->omega_cavity, 0.0));
-    
-    /* |2⟩⟨2| (energía del nivel láser superior) */
-    laser_create_sigma(&sigma_22, 2, 2, dim_a, dim_c);
-    cmatrix_copy(&term2, &sigma_22);
-    cmatrix_scale(&term2, complex_make(p->omega_atom, 0.0));
+    static SMatrix H, L;
+    smatrix_init(&H, dim);
     
-    /* Interacción Jaynes-Cummings: g(a†σ_12 + a σ_21) */
-    laser_create_annihilation(&a, dim_a, dim_c);
-    laser_create_creation(&a_dag, dim_a, dim_c);
-    laser_create_sigma(&sigma_12, 1, 2, dim_a, dim_c);
-    laser_create_sigma(&sigma_21, 2, 1, dim_a, dim_c);
-    
-    /* a† σ_12 */
-    cmatrix_mul(&temp, &a_dag, &sigma_12);
-    cmatrix_copy(&term3, &temp);
+    /* Diagonal: ω_c n + ω_a δ_i2 */
+    for (uint32_t i = 0; i < dim_a; i++) {
+        double e_atom = (i == 2) ? p->omega_atom : 0.0;
+        for (uint32_t n = 0; n < dim_c; n++) {
+            smatrix_push(&H, i * dim_c + n, i * dim_c + n,
+                         complex_make(p->omega_cavity * n + e_atom, 0.0));
+        }
+    }
     
-    /* a σ_21 */
-    cmatrix_mul(&temp, &a, &sigma_21);
-    cmatrix_add(&term3, &term3, &temp);
-    cmatrix_scale(&term3, complex_make(p->g, 0.0));
+    /* Jaynes-Cummings: |2, n⟩ ↔ |1, n+1⟩ con amplitud g√(n+1) */
+    if (dim_a > 2) {
+        for (uint32_t n = 0; n + 1 < dim_c; n++) {
+            Complex v = complex_make(p->g * dit_sqrt((double)(n + 1)), 0.0);
+            smatrix_push(&H, 1 * dim_c + n + 1, 2 * dim_c + n, v);
+            smatrix_push(&H, 2 * dim_c + n, 1 * dim_c + n + 1, v);
+        }
+    }
     
-    /* H total */
-    cmatrix_zero(&H, dim, dim);
-    cmatrix_add(&H, &term1, &term2);
-    cmatrix_add(&H, &H, &term3);
+    int ok = lindblad_set_hamiltonian_sparse(sys, &H);
     
-    lindblad_set_hamiltonian(sys, &H);
+    /* Drive coherente ε(t)(a + a†) */
+    if (p->drive_envelope) {
+        laser_sparse_quadrature(&L, dim_a, dim_c);
+        ok &= lindblad_add_drive_sparse(sys, &L, p->drive_envelope);
+    }
     
     /* ========================================
      * OPERADORES DE SALTO (LINDBLAD)
      * ======================================== */
     
     /* L_κ = a (pérdida de cavidad) */
-    lindblad_add_jump_operator(sys, &a, p->kappa);
+    laser_sparse_annihilation(&L, dim_a, dim_c);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->kappa);
     
     /* L_p = σ_30 (bombeo 0 → 3) */
-    static CMatrix sigma_30;
-    laser_create_sigma(&sigma_30, 3, 0, dim_a, dim_c);
-    lindblad_add_jump_operator(sys, &sigma_30, p->pump_rate);
+    laser_sparse_sigma(&L, 3, 0, dim_a, dim_c);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->pump_rate);
+    lindblad_set_rate_envelope(sys, sys->num_ops - 1, p->pump_envelope);
     
     /* L_32 = σ_23 (decay 3 → 2) */
-    static CMatrix sigma_23;
-    laser_create_sigma(&sigma_23, 2, 3, dim_a, dim_c);
-    lindblad_add_jump_operator(sys, &sigma_23, p->gamma_32);
+    laser_sparse_sigma(&L, 2, 3, dim_a, dim_c);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_32);
     
     /* L_21 = σ_12 (decay 2 → 1) */
-    lindblad_add_jump_operator(sys, &sigma_12, p->gamma_21);
+    laser_sparse_sigma(&L, 1, 2, dim_a, dim_c);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_21);
     
     /* L_10 = σ_01 (decay 1 → 0) */
-    static CMatrix sigma_01;
-    laser_create_sigma(&sigma_01, 0, 1, dim_a, dim_c);
-    lindblad_add_jump_operator(sys, &sigma_01, p->gamma_10);
+    laser_sparse_sigma(&L, 0, 1, dim_a, dim_c);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_10);
+    
+    /* Un operador que no cupo en LINDBLAD_MAX_NNZ invalida el sistema */
+    if (!ok) return 0;
     
     /* ========================================
      * ESTADO INICIAL: |0⟩_atom ⊗ |0⟩_cavity
@@ -205,48 +315,313 @@ void laser_build_system(
     
     cmatrix_zero(rho0, dim, dim);
     rho0->data[0][0] = complex_make(1.0, 0.0);  /* |0,0⟩⟨0,0| */
+    
+    return dim;
+}
+
+/* ============================================================
+ * ENSAMBLE DE N EMISORES (BASE SIMÉTRICA)
+ * 
+ * Los estados atómicos simétricos se enumeran por ocupaciones
+ * (n_0, n_1, n_2, n_3) en el orden:
+ *   for n_3 in 0..N: for n_2 in 0..N-n_3: for n_1 in 0..N-n_3-n_2
+ * Con N = 1 el orden coincide con |0⟩, |1⟩, |2⟩, |3⟩ del modelo simple.
+ * ============================================================ */
+
+uint32_t laser_atom_dim(const LaserParams *p) {
+    if (p->num_atoms <= 1) return p->dim_atom;
+    uint32_t N = p->num_atoms;
+    return (N + 1) * (N + 2) * (N + 3) / 6;
+}
+
+/* Primer estado de la enumeración: todos los emisores en |0⟩ */
+static void ensemble_first(uint32_t N, uint32_t occ[4]) {
+    occ[0] = N;
+    occ[1] = occ[2] = occ[3] = 0;
+}
+
+/* Avanzar al siguiente estado simétrico en el orden de la enumeración */
+static void ensemble_next(uint32_t N, uint32_t occ[4]) {
+    if (occ[0] > 0) {
+        occ[0]--;
+        occ[1]++;
+    } else if (occ[2] + occ[3] < N) {
+        occ[2]++;
+        occ[1] = 0;
+        occ[0] = N - occ[2] - occ[3];
+    } else {
+        occ[3]++;
+        occ[2] = 0;
+        occ[1] = 0;
+        occ[0] = N - occ[3];
+    }
+}
+
+/* Índice de un estado de ocupación en la enumeración (O(N)) */
+static uint32_t ensemble_index(uint32_t N, const uint32_t occ[4]) {
+    uint32_t idx = 0;
+    for (uint32_t k = 0; k < occ[3]; k++) {
+        uint32_t m = N - k;
+        idx += (m + 1) * (m + 2) / 2;
+    }
+    for (uint32_t k = 0; k < occ[2]; k++) {
+        idx += N - occ[3] - k + 1;
+    }
+    return idx + occ[1];
+}
+
+/*
+ * Operador de transición j → i en el espacio total (ocupaciones ⊗ cavidad).
+ *   collective = 1: S_ij, amplitud √(n_j (n_i + 1))
+ *   collective = 0: decaimiento local, amplitud √n_j. Aproximado: da la
+ *                   tasa γ·n_j, no las coherencias de la disipación local
+ *                   (ver quantum_laser.h)
+ */
+static void ensemble_transition(SMatrix *L, uint32_t N, uint32_t dim_c,
+                                uint32_t i, uint32_t j, int collective) {
+    uint32_t dim_s = (N + 1) * (N + 2) * (N + 3) / 6;
+    uint32_t occ[4], dst[4];
+    
+    smatrix_init(L, dim_s * dim_c);
+    ensemble_first(N, occ);
+    
+    for (uint32_t s = 0; s < dim_s; s++, ensemble_next(N, occ)) {
+        if (occ[j] == 0) continue;
+        
+        double w = (double)occ[j];
+        if (collective) w *= (double)(occ[i] + 1);
+        Complex amp = complex_make(dit_sqrt(w), 0.0);
+        
+        dst[0] = occ[0]; dst[1] = occ[1]; dst[2] = occ[2]; dst[3] = occ[3];
+        dst[j]--;
+        dst[i]++;
+        uint32_t t = ensemble_index(N, dst);
+        
+        for (uint32_t n = 0; n < dim_c; n++) {
+            smatrix_push(L, t * dim_c + n, s * dim_c + n, amp);
+        }
+    }
+}
+
+uint32_t laser_build_ensemble(
+    const LaserParams *p,
+    LindbladSystem *sys,
+    CMatrix *rho0
+) {
+    uint32_t N = p->num_atoms;
+    uint32_t dim_c = p->dim_cavity;
+    
+    /* C(N+3, 3) ≥ N: descartar antes de que el producto desborde */
+    if (N == 0 || N > LINDBLAD_MAX_DIM || dim_c == 0 || dim_c > LINDBLAD_MAX_DIM) return 0;
+    uint32_t dim_s = laser_atom_dim(p);
+    uint32_t dim = dim_s * dim_c;
+    if (dim > LINDBLAD_MAX_DIM) return 0;
+    
+    lindblad_init(sys, dim);
+    
+    /* ========================================
+     * HAMILTONIANO (elementos analíticos)
+     * H = ω_c a†a + ω_a S_22 + g(a† S_12 + a S_21)
+     * ======================================== */
+    
+    static SMatrix H, L;
+    uint32_t occ[4], dst[4];
+    
+    smatrix_init(&H, dim);
+    ensemble_first(N, occ);
+    
+    for (uint32_t s = 0; s < dim_s; s++, ensemble_next(N, occ)) {
+        for (uint32_t n = 0; n < dim_c; n++) {
+            smatrix_push(&H, s * dim_c + n, s * dim_c + n, complex_make(
+                p->omega_cavity * n + p->omega_atom * occ[2], 0.0));
+        }
+        
+        /* a† S_12: |n_2, n_1, n⟩ → |n_2 - 1, n_1 + 1, n + 1⟩ y su adjunto */
+        if (occ[2] == 0) continue;
+        dst[0] = occ[0]; dst[1] = occ[1] + 1; dst[2] = occ[2] - 1; dst[3] = occ[3];
+        uint32_t t = ensemble_index(N, dst);
+        double s12 = dit_sqrt((double)occ[2] * (occ[1] + 1));
+        
+        for (uint32_t n = 0; n + 1 < dim_c; n++) {
+            Complex v = complex_make(p->g * s12 * dit_sqrt((double)(n + 1)), 0.0);
+            smatrix_push(&H, t * dim_c + n + 1, s * dim_c + n, v);
+            smatrix_push(&H, s * dim_c + n, t * dim_c + n + 1, v);
+        }
+    }
+    
+    int ok = lindblad_set_hamiltonian_sparse(sys, &H);
+    
+    /* Drive coherente ε(t)(a + a†) */
+    if (p->drive_envelope) {
+        laser_sparse_quadrature(&L, dim_s, dim_c);
+        ok &= lindblad_add_drive_sparse(sys, &L, p->drive_envelope);
+    }
+    
+    /* ========================================
+     * OPERADORES DE SALTO
+     * ======================================== */
+    
+    /* L_κ = a (pérdida de cavidad) */
+    laser_sparse_annihilation(&L, dim_s, dim_c);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->kappa);
+    
+    /* Procesos locales: bombeo 0 → 3 y decaimientos 3 → 2, 2 → 1, 1 → 0 */
+    ensemble_transition(&L, N, dim_c, 3, 0, 0);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->pump_rate);
+    lindblad_set_rate_envelope(sys, sys->num_ops - 1, p->pump_envelope);
+    
+    ensemble_transition(&L, N, dim_c, 2, 3, 0);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_32);
+    
+    ensemble_transition(&L, N, dim_c, 1, 2, 0);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_21);
+    
+    ensemble_transition(&L, N, dim_c, 0, 1, 0);
+    ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_10);
+    
+    /* Decaimiento colectivo 2 → 1 (superradiancia) */
+    if (p->gamma_collective > 0.0) {
+        ensemble_transition(&L, N, dim_c, 1, 2, 1);
+        ok &= lindblad_add_jump_operator_sparse(sys, &L, p->gamma_collective);
+    }
+    
+    /* Un operador que no cupo en LINDBLAD_MAX_NNZ invalida el sistema */
+    if (!ok) return 0;
+    
+    /* ========================================
+     * ESTADO INICIAL: |N, 0, 0, 0⟩ ⊗ |0⟩
+     * ======================================== */
+    
+    cmatrix_zero(rho0, dim, dim);
+    rho0->data[0][0] = complex_make(1.0, 0.0);
+    
+    return dim;
 }
 
 /* ============================================================
  * CÁLCULO DE OBSERVABLES
+ * 
+ * La base producto es |i⟩_atom ⊗ |n⟩_cavity con índice i·dim_c + n,
+ * por lo que todos los observables diagonales (a†a, a†a†aa, σ_ii)
+ * se leen directamente de la diagonal de ρ sin productos densos.
  * ============================================================ */
 
+/* Un único recorrido de la diagonal: P(n) y poblaciones atómicas */
+static void laser_diagonal_pass(
+    const LaserParams *p,
+    const CMatrix *rho,
+    double *P_n,
+    double *population
+) {
+    uint32_t dim_a = laser_atom_dim(p);
+    uint32_t dim_c = p->dim_cavity;
+    uint32_t N = (p->num_atoms > 1) ? p->num_atoms : 1;
+    uint32_t occ[4];
+    
+    for (uint32_t n = 0; n < dim_c; n++) P_n[n] = 0.0;
+    
+    /* Con N = 1 la enumeración simétrica es |0⟩..|3⟩: occ[k] = δ_ik */
+    ensemble_first(N, occ);
+    
+    for (uint32_t i = 0; i < dim_a; i++, ensemble_next(N, occ)) {
+        const uint32_t base = i * dim_c;
+        double pop = 0.0;
+        for (uint32_t n = 0; n < dim_c; n++) {
+            double rho_nn = rho->data[base + n][base + n].re;
+            P_n[n] += rho_nn;
+            pop += rho_nn;
+        }
+        if (population) {
+            for (uint32_t k = 0; k < 4; k++) population[k] += pop * occ[k] / N;
+        }
+    }
+}
+
+/* <a†a> y g²(0) a partir de P(n) */
+static void laser_moments_from_distribution(
+    const double *P_n,
+    uint32_t dim_c,
+    double *n_mean,
+    double *g2
+) {
+    double n1 = 0.0;    /* Σ n P(n)       = <a†a>     */
+    double n2 = 0.0;    /* Σ n(n-1) P(n)  = <a†a†aa>  */
+    
+    for (uint32_t n = 1; n < dim_c; n++) {
+        double dn = (double)n;
+        n1 += dn * P_n[n];
+        n2 += dn * (dn - 1.0) * P_n[n];
+    }
+    
+    *n_mean = n1;
+    /* Vacío: g²(0) indefinido (0/0), se reporta 0 */
+    *g2 = (n1 > 1e-12) ? n2 / (n1 * n1) : 0.0;
+}
+
+void laser_photon_statistics(
+    const LaserParams *p,
+    const CMatrix *rho,
+    double *P_n,
+    double *n_mean,
+    double *g2
+) {
+    double local[LASER_MAX_FOCK];
+    double *dist = P_n ? P_n : local;
+    
+    laser_diagonal_pass(p, rho, dist, 0);
+    laser_moments_from_distribution(dist, p->dim_cavity, n_mean, g2);
+}
+
 void laser_compute_observables(
     const LaserParams *p,
     const CMatrix *rho,
     LaserState *state
 ) {
-    uint32_t dim_a = p->dim_atom;
     uint32_t dim_c = p->dim_cavity;
+    uint32_t dim = laser_atom_dim(p) * dim_c;
     
-    /* Número medio de fotones <a†a> */
-    static CMatrix N;
-    laser_create_number(&N, dim_a, dim_c);
-    Complex n_exp = lindblad_expect(rho, &N);
-    state->n_photons = n_exp.re;
-    
-    /* Poblaciones P_i = Tr(ρ |i⟩⟨i|) */
-    for (uint32_t i = 0; i < 4; i++) {
-        static CMatrix sigma_ii;
-        laser_create_sigma(&sigma_ii, i, i, dim_a, dim_c);
-        Complex pop = lindblad_expect(rho, &sigma_ii);
-        state->population[i] = pop.re;
-    }
+    /* P(n), <a†a>, g²(0) y poblaciones P_i = Tr(ρ |i⟩⟨i|) */
+    for (uint32_t i = 0; i < 4; i++) state->population[i] = 0.0;
+    laser_diagonal_pass(p, rho, state->photon_dist, state->population);
+    laser_moments_from_distribution(state->photon_dist, dim_c,
+                                    &state->n_photons, &state->g2);
     
     /* Inversión de población */
     state->inversion = state->population[2] - state->population[1];
     
-    /* Coherencia |⟨σ_21⟩| */
-    static CMatrix sigma_21;
-    laser_create_sigma(&sigma_21, 2, 1, dim_a, dim_c);
-    Complex coh = lindblad_expect(rho, &sigma_21);
-    state->coherence = golden_sqrt(coh.re * coh.re + coh.im * coh.im);
+    /* Coherencia |⟨σ_21⟩| = |Σ_n ρ_(1,n),(2,n)| (bloque fuera de diagonal).
+     * En el ensamble: |⟨S_21⟩| / N con los elementos √(n_1 (n_2 + 1)). */
+    Complex coh = complex_make(0.0, 0.0);
+    if (p->num_atoms > 1) {
+        uint32_t N = p->num_atoms;
+        uint32_t occ[4], dst[4];
+        ensemble_first(N, occ);
+        for (uint32_t s = 0; s < laser_atom_dim(p); s++, ensemble_next(N, occ)) {
+            if (occ[1] == 0) continue;
+            dst[0] = occ[0]; dst[1] = occ[1] - 1; dst[2] = occ[2] + 1; dst[3] = occ[3];
+            uint32_t t = ensemble_index(N, dst);
+            double amp = dit_sqrt((double)occ[1] * (occ[2] + 1)) / N;
+            for (uint32_t n = 0; n < dim_c; n++) {
+                coh = complex_add(coh, complex_scale(
+                    rho->data[s * dim_c + n][t * dim_c + n], amp));
+            }
+        }
+    } else if (p->dim_atom > 2) {
+        for (uint32_t n = 0; n < dim_c; n++) {
+            coh = complex_add(coh, rho->data[1 * dim_c + n][2 * dim_c + n]);
+        }
+    }
+    state->coherence = dit_sqrt(complex_abs2(coh));
     
-    /* Estado del sistema */
-    LindbladState lstate;
-    lindblad_compute_state(&lstate, rho);
-    state->purity = lstate.purity;
-    state->entropy = lstate.entropy;
+    /* Pureza Tr(ρ²) = Σ_ij |ρ_ij|² (ρ hermítica), sin producto denso */
+    double purity = 0.0;
+    for (uint32_t i = 0; i < dim; i++) {
+        for (uint32_t j = 0; j < dim; j++) {
+            purity += complex_abs2(rho->data[i][j]);
+        }
+    }
+    state->purity = purity;
+    state->entropy = 1.0 - purity;
     
     /* Parámetro de umbral */
     double threshold = laser_threshold(p);
@@ -270,44 +645,121 @@ double laser_threshold(const LaserParams *p) {
     return (p->kappa * p->gamma_21) / (4.0 * g2);
 }
 
+/* ============================================================
+ * PASO ESTABLE
+ * 
+ * RK4 es estable mientras |λ|·dt ≤ 2.6 para todo autovalor λ del
+ * Liouvilliano (todos con Re λ ≤ 0). Cota de |λ| con normas de
+ * operador, envolventes en su máximo:
+ *   -i[H, ρ]:  rango de la diagonal ω_c n + ω_a n_2, más 2‖V‖ con
+ *              V = g(a†S_12 + a S_21) + ε(a + a†)
+ *   D_k:       2 γ_k ‖L_k‖²
+ * con ‖a‖² = n_max, ‖S_12‖ ≤ N y ‖L_local‖² = N.
+ * ============================================================ */
+
+#define LASER_RK4_STABILITY  2.5    /* |λ|·dt máximo (frontera RK4: ~2.6) */
+
+/* Cota de max |s(t)| (1 si la tasa es constante). Las formas
+ * analíticas valen a lo sumo |A|, tabuladas o no */
+static double envelope_peak(const PulseEnvelope *env) {
+    if (!env) return 1.0;
+    if (env->shape != ENVELOPE_TABLE) return dit_fabs(env->amplitude);
+    double peak = 0.0;
+    for (uint32_t i = 0; i <= ENVELOPE_TABLE_SIZE; i++) {
+        double v = dit_fabs(env->samples[i]);
+        if (v > peak) peak = v;
+    }
+    return peak;
+}
+
+double laser_max_stable_dt(const LaserParams *p) {
+    double N = (p->num_atoms > 1) ? (double)p->num_atoms : 1.0;
+    double n_max = (p->dim_cavity > 1) ? (double)(p->dim_cavity - 1) : 0.0;
+    double a_norm = dit_sqrt(n_max);
+    
+    /* Parte unitaria */
+    double bound = dit_fabs(p->omega_cavity) * n_max + dit_fabs(p->omega_atom) * N
+                 + 4.0 * dit_fabs(p->g) * a_norm * N;
+    if (p->drive_envelope) bound += 4.0 * envelope_peak(p->drive_envelope) * a_norm;
+    
+    /* Parte disipativa */
+    bound += 2.0 * (p->kappa * n_max
+                    + (p->pump_rate * envelope_peak(p->pump_envelope)
+                       + p->gamma_32 + p->gamma_21 + p->gamma_10) * N
+                    + p->gamma_collective * N * (N + 1.0));
+    
+    return (bound > 0.0) ? LASER_RK4_STABILITY / bound : p->t_end - p->t_start;
+}
+
+/* Pasos enteros de la ventana (saturado a 32 bits; 0 si está vacía) */
+static uint32_t laser_step_count(const LaserParams *p) {
+    double span = p->t_end - p->t_start;
+    if (!(span > 0.0) || !(p->dt > 0.0)) return 0;
+    double steps = span / p->dt + 0.5;
+    return (steps >= 4294967295.0) ? 0xFFFFFFFFu : (uint32_t)steps;
+}
+
+uint32_t laser_set_time_window(LaserParams *p, double t_start, double t_end, uint32_t min_steps) {
+    p->t_start = t_start;
+    p->t_end = t_end;
+    
+    double span = t_end - t_start;
+    double steps = (double)(min_steps ? min_steps : 1);
+    double stable = span / laser_max_stable_dt(p);
+    if (stable > steps) {
+        steps = (stable >= 4294967295.0) ? 4294967295.0 : (double)(uint32_t)stable;
+        if (steps < stable && steps < 4294967295.0) steps += 1.0;
+    }
+    p->dt = span / steps;
+    return laser_step_count(p);
+}
+
 /* ============================================================
  * EVOLUCIÓN TEMPORAL
  * ============================================================ */
 
-void laser_evolve(
+/* Muestra de observables de ρ en el instante t */
+static void laser_sample(const LaserParams *p, const CMatrix *rho, double t, LaserObservable *o) {
+    double population[4] = {0.0, 0.0, 0.0, 0.0};
+    
+    /* Un recorrido O(d) de la diagonal: P(n), <a†a>, g²(0), inversión */
+    laser_diagonal_pass(p, rho, o->photon_dist, population);
+    laser_moments_from_distribution(o->photon_dist, p->dim_cavity,
+                                    &o->n_photons, &o->g2);
+    
+    o->time = t;
+    o->inversion = population[2] - population[1];
+}
+
+int laser_evolve(
     const LaserParams *p,
     LindbladSystem *sys,
     CMatrix *rho,
     LaserObservable *obs,
     uint32_t num_samples
 ) {
-    double t = p->t_start;
-    double t_total = p->t_end - p->t_start;
-    double dt_sample = t_total / (num_samples - 1);
-    
+    /*
+     * Bucle de pasos enteros: t = t_start + s·dt, sin acumular dt. La
+     * muestra k se toma en el primer paso s con s·(M-1) ≥ k·pasos, de
+     * modo que la primera cae en t_start y la última (M-1) en t_end,
+     * después del último paso. Se rellenan siempre las M muestras.
+     */
+    uint32_t steps = laser_step_count(p);
+    uint32_t last = num_samples ? num_samples - 1 : 0;
     uint32_t sample_idx = 0;
-    double next_sample = t;
-    
-    while (t < p->t_end && sample_idx < num_samples) {
-        /* Tomar muestra */
-        if (t >= next_sample) {
-            LaserState state;
-            laser_compute_observables(p, rho, &state);
-            
-            obs[sample_idx].time = t;
-            obs[sample_idx].n_photons = state.n_photons;
-            obs[sample_idx].inversion = state.inversion;
-            
-            /* g²(0) ≈ 1 para luz coherente, 2 para luz térmica */
-            /* Aproximación: g² = 1 + (1 - purity) */
-            obs[sample_idx].g2 = 1.0 + (1.0 - state.purity);
-            
-            sample_idx++;
-            next_sample += dt_sample;
+    
+    for (uint32_t s = 0; ; s++) {
+        double t = (s == steps) ? p->t_end : p->t_start + (double)s * p->dt;
+        
+        while (sample_idx < num_samples &&
+               (uint64_t)s * last >= (uint64_t)sample_idx * steps) {
+            laser_sample(p, rho, t, &obs[sample_idx++]);
         }
         
+        if (s == steps) break;
+        
         /* Paso de integración */
-        lindblad_step_rk4(sys, rho, p->dt);
-        t += p->dt;
+        if (!lindblad_step_rk4_t(sys, rho, t, p->dt)) return 0;
     }
+    return 1;
 }
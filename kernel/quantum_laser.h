@@ -17,6 +17,32 @@
  *   γ_10: |1⟩ → |0⟩  (relajación rápida)
  *   κ:    Pérdidas de la cavidad
  *   g:    Acoplamiento Jaynes-Cummings
+ * 
+ * Pulsos: el bombeo Γ_p(t) y un drive coherente ε(t)(a + a†) pueden
+ * seguir envolventes pre-tabuladas (pulse_envelope.h).
+ * 
+ * Ensamble de N emisores (num_atoms > 1):
+ *   Base simétrica bajo permutaciones |n_0, n_1, n_2, n_3⟩ ⊗ |n⟩,
+ *   con Σ n_i = N. Dimensión atómica C(N+3, 3) en lugar de 4^N.
+ *   - Operadores colectivos S_ij = Σ_k |i⟩⟨j|_k:
+ *       S_ij |.., n_j, .., n_i, ..⟩ = √(n_j (n_i + 1)) |.., n_j - 1, .., n_i + 1, ..⟩
+ *   - Decaimiento local (independiente) proyectado a la base simétrica:
+ *       amplitud √n_j, tasa total γ·n_j, sin realce de Bose.
+ *       APROXIMACIÓN: un salto local σ_ij^(k) saca al ensamble del
+ *       subespacio simétrico. El operador proyectado da las tasas (y,
+ *       sin dinámica coherente, las poblaciones de ocupación) correctas,
+ *       pero no el decaimiento de las coherencias entre estados
+ *       simétricos. El Liouvilliano invariante bajo permutaciones (base
+ *       de irreps de SU(4)) no está implementado.
+ *   - Decaimiento colectivo 2 → 1 (superradiancia) con gamma_collective.
+ * 
+ *   Límites: C(N+3, 3) · dim_cavity ≤ LINDBLAD_MAX_DIM (16), así que
+ *   sólo cabe N = 2 sin cavidad (dim_cavity = 1: 10 estados); N = 3 ya
+ *   necesita 20 y N = 2 con un solo fotón, 20. No es un modelo de
+ *   10–50 emisores. Subir LINDBLAD_MAX_DIM no es una salida: cada
+ *   CMatrix estática crece con MAX_DIM² y el kernel deja de caber por
+ *   debajo de la pila (linker.ld lo rechaza). laser_build_system
+ *   devuelve 0 para lo que no cabe.
  */
 
 #ifndef QUANTUM_LASER_H
@@ -24,6 +50,10 @@
 
 #include "lindblad.h"
 
+/* Máximo número de estados de Fock en la distribución P(n).
+ * dim_cavity nunca supera la dimensión total del sistema. */
+#define LASER_MAX_FOCK  LINDBLAD_MAX_DIM
+
 /* ============================================================
  * PARÁMETROS DEL LÁSER
  * ============================================================ */
@@ -47,6 +77,14 @@ typedef struct {
     double gamma_21;        /* Decaimiento 2 → 1 (emisión espontánea) */
     double gamma_10;        /* Decaimiento 1 → 0 */
     
+    /* Dependencia temporal (NULL = constante) */
+    const PulseEnvelope *pump_envelope;  /* Γ_p(t) = pump_rate · s(t) */
+    const PulseEnvelope *drive_envelope; /* H_1 = ε(t)(a + a†), ε(t) de la tabla */
+    
+    /* Ensamble de emisores idénticos */
+    uint32_t num_atoms;     /* N emisores (1 = modelo de un átomo) */
+    double gamma_collective;/* Decaimiento colectivo 2 → 1 (superradiante) */
+    
     /* Integración temporal */
     double t_start;
     double t_end;
@@ -56,12 +94,14 @@ typedef struct {
 /* Estado del láser */
 typedef struct {
     double n_photons;       /* Número medio de fotones <a†a> */
-    double population[4];   /* Poblaciones P_0, P_1, P_2, P_3 */
+    double population[4];   /* Poblaciones P_0..P_3 (fracción por emisor) */
     double inversion;       /* Inversión de población (P_2 - P_1) */
     double coherence;       /* |⟨σ_21⟩| (coherencia láser) */
     double purity;          /* Tr(ρ²) */
     double entropy;         /* Entropía del sistema */
     double threshold_param; /* Parámetro de umbral (pump_rate / pump_threshold) */
+    double g2;              /* g²(0) = <a†a†aa> / <a†a>² */
+    double photon_dist[LASER_MAX_FOCK]; /* P(n), n = 0 .. dim_cavity-1 */
 } LaserState;
 
 /* Observables para evolución temporal */
@@ -70,6 +110,7 @@ typedef struct {
     double n_photons;
     double inversion;
     double g2;              /* Función de correlación g²(0) */
+    double photon_dist[LASER_MAX_FOCK]; /* Histograma P(n) de la muestra */
 } LaserObservable;
 
 /* ============================================================
@@ -79,8 +120,31 @@ typedef struct {
 /* Inicializar parámetros por defecto */
 void laser_params_default(LaserParams *p);
 
-/* Construir el sistema de Lindblad para el láser */
-void laser_build_system(
+/*
+ * Huella de 64 bits (FNV-1a) de todos los parámetros que determinan
+ * la evolución, incluido el contenido de las envolventes. Dos juegos
+ * de parámetros con la misma huella producen la misma ρ(t).
+ */
+uint64_t laser_params_hash(const LaserParams *p);
+
+/* Dimensión del espacio atómico: 4 para un átomo, C(N+3, 3) para N emisores */
+uint32_t laser_atom_dim(const LaserParams *p);
+
+/* Construir el sistema de Lindblad para el láser
+ * (delegado a laser_build_ensemble si num_atoms > 1).
+ * Retorna la dimensión total, o 0 si excede LINDBLAD_MAX_DIM: en ese
+ * caso sys y rho0 no se tocan y no deben evolucionarse. También 0 si
+ * algún operador desborda LINDBLAD_MAX_NNZ (sys queda a medias). */
+uint32_t laser_build_system(
+    const LaserParams *p,
+    LindbladSystem *sys,
+    CMatrix *rho0           /* Estado inicial (salida) */
+);
+
+/* Construir el láser de N emisores en la base simétrica.
+ * Retorna la dimensión total, o 0 si C(N+3, 3) · dim_cavity excede
+ * LINDBLAD_MAX_DIM. */
+uint32_t laser_build_ensemble(
     const LaserParams *p,
     LindbladSystem *sys,
     CMatrix *rho0           /* Estado inicial (salida) */
@@ -93,8 +157,24 @@ void laser_compute_observables(
     LaserState *state
 );
 
-/* Evolucionar y obtener observables */
-void laser_evolve(
+/*
+ * Estadística de fotones desde los bloques diagonales de ρ (O(d)):
+ *   P(n) = Σ_i ρ_(i,n),(i,n)
+ *   <a†a> = Σ n P(n),  <a†a†aa> = Σ n(n-1) P(n)
+ * P_n puede ser NULL si sólo interesan <a†a> y g²(0).
+ */
+void laser_photon_statistics(
+    const LaserParams *p,
+    const CMatrix *rho,
+    double *P_n,            /* Array de dim_cavity elementos (salida) */
+    double *n_mean,         /* <a†a> (salida) */
+    double *g2              /* g²(0) (salida) */
+);
+
+/* Evolucionar y obtener observables: num_samples muestras equiespaciadas
+ * en pasos, la primera en t_start y la última en t_end. Devuelve 0 si un
+ * paso RK4 no pudo darse: ρ y obs quedan a medias y no deben usarse */
+int laser_evolve(
     const LaserParams *p,
     LindbladSystem *sys,
     CMatrix *rho,
@@ -105,6 +185,17 @@ void laser_evolve(
 /* Calcular umbral de láser teórico */
 double laser_threshold(const LaserParams *p);
 
+/* Mayor dt estable de RK4 para estos parámetros: 2.5 / Λ, con Λ una
+ * cota del radio espectral del Liouvilliano (frecuencias, acoplamientos
+ * y tasas; envolventes en su máximo). Fijar las envolventes antes. */
+double laser_max_stable_dt(const LaserParams *p);
+
+/* Ventana [t_start, t_end] en pasos iguales: al menos min_steps y tantos
+ * como haga falta para que dt ≤ laser_max_stable_dt. Retorna el número
+ * de pasos RK4 (saturado a 32 bits): el coste crece con la duración y
+ * quien acepte ventanas de usuario debe acotarlo */
+uint32_t laser_set_time_window(LaserParams *p, double t_start, double t_end, uint32_t min_steps);
+
 /* ============================================================
  * OPERADORES AUXILIARES
  * ============================================================ */
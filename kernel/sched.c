@@ -0,0 +1,263 @@
+/*
+ * Scheduler Cuasiperiódico - Implementación
+ * Smopsys Q-CORE
+ *
+ * Tabla fija de SCHED_MAX_TASKS tareas (búsqueda lineal). La tarea 0
+ * es el flujo de arranque y usa la pila de kernel_entry; el resto
+ * tiene pila estática. Todo el estado se toca con IF=0: desde la ISR
+ * o dentro de sched_irq_save/restore.
+ */
+
+#include "sched.h"
+#include "golden_operator.h"
+#include "../drivers/metriplectic_heartbeat.h"
+
+#define SCHED_IDLE_ID 1     /* Creada por sched_init, sólo corre si nada más puede */
+
+/* Declaración externa de MemoryManager.cpp */
+extern void memory_zero_pool_refill(void);
+extern void memory_compact(uint32_t budget_cycles);
+
+typedef struct {
+    InterruptFrame *frame;      /* Contexto guardado mientras no está en CPU */
+    uint8_t fpu[SCHED_FPU_STATE_SIZE];
+    uint8_t fpu_valid;          /* 0: aún no usó la CPU, arranca con fninit */
+    uint8_t state;
+    const char *name;
+    void (*entry)(void);
+    uint32_t weight;
+    uint32_t wake_tick;
+    uint32_t ready_since;       /* Tick en el que pasó a lista */
+    uint32_t cpu_ticks;
+    uint32_t dispatches;
+    uint32_t latency_sum;
+    uint32_t latency_max;
+} SchedTask;
+
+static SchedTask tasks[SCHED_MAX_TASKS];
+static uint8_t task_stacks[SCHED_MAX_TASKS - 1][SCHED_STACK_SIZE] __attribute__((aligned(16)));
+static SchedTask *current = 0;
+static uint32_t sched_weyl = 0;         /* u_k = frac(k·φ') en 32 bits */
+static uint32_t slice_left = SCHED_SLICE_TICKS;
+static volatile uint8_t need_resched = 0;
+static volatile uint8_t sched_running = 0;
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+static void sched_trampoline(void) {
+    current->entry();
+    sched_exit();
+}
+
+/* El tiempo ocioso rellena la reserva de páginas a cero y compacta */
+static void sched_idle(void) {
+    while (1) {
+        memory_zero_pool_refill();
+        memory_compact(SCHED_IDLE_COMPACT_CYCLES);
+        __asm__ __volatile__("hlt");
+    }
+}
+
+static void sched_make_ready(SchedTask *t, uint32_t now) {
+    t->state = SCHED_TASK_READY;
+    t->ready_since = now;
+}
+
+/*
+ * Siguiente tarea: el punto u_k de la secuencia de Weyl, escalado al
+ * peso total de las tareas listas, cae en el intervalo de una de ellas.
+ */
+static SchedTask *sched_pick(void) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        if (tasks[i].state == SCHED_TASK_READY) total += tasks[i].weight;
+    }
+    if (total == 0) return &tasks[SCHED_IDLE_ID];
+
+    sched_weyl += GOLDEN_SCHEDULING_STEP;
+    uint32_t target = (uint32_t)(((uint64_t)sched_weyl * total) >> 32);
+
+    for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        if (tasks[i].state != SCHED_TASK_READY) continue;
+        if (target < tasks[i].weight) return &tasks[i];
+        target -= tasks[i].weight;
+    }
+    return &tasks[SCHED_IDLE_ID];
+}
+
+/* ============================================================
+ * API PÚBLICA
+ * ============================================================ */
+
+void sched_init(const char *name, uint32_t weight) {
+    for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        tasks[i].state = SCHED_TASK_FREE;
+    }
+
+    /* El flujo actual: su marco se guarda en el primer cambio */
+    current = &tasks[0];
+    current->name = name;
+    current->weight = weight;
+    current->state = SCHED_TASK_RUNNING;
+    current->fpu_valid = 1;
+    current->cpu_ticks = 0;
+    current->dispatches = 1;
+    current->latency_sum = 0;
+    current->latency_max = 0;
+
+    sched_weyl = 0;
+    slice_left = SCHED_SLICE_TICKS;
+    need_resched = 0;
+
+    sched_spawn("idle", sched_idle, 0);
+    sched_running = 1;
+}
+
+int sched_spawn(const char *name, void (*entry)(void), uint32_t weight) {
+    uint32_t flags = sched_irq_save();
+
+    /* Hueco 0: la pila de arranque, nunca se reutiliza */
+    uint32_t id = 1;
+    while (id < SCHED_MAX_TASKS &&
+           tasks[id].state != SCHED_TASK_FREE && tasks[id].state != SCHED_TASK_DEAD) {
+        id++;
+    }
+    if (id == SCHED_MAX_TASKS) {
+        sched_irq_restore(flags);
+        return -1;
+    }
+
+    SchedTask *t = &tasks[id];
+
+    /* Marco inicial: iret salta al trampolín con IF=1 y la pila
+     * alineada a 16 como tras un call (hueco de retorno ficticio) */
+    uint8_t *top = task_stacks[id - 1] + SCHED_STACK_SIZE - 16;
+    InterruptFrame *f = (InterruptFrame *)(top - sizeof(InterruptFrame));
+    uint32_t *words = (uint32_t *)f;
+    for (uint32_t i = 0; i < sizeof(InterruptFrame) / 4; i++) words[i] = 0;
+    f->ds = 0x10;
+    f->eip = (uint32_t)sched_trampoline;
+    f->cs = 0x08;
+    f->eflags = 0x202;
+
+    t->frame = f;
+    t->fpu_valid = 0;
+    t->name = name;
+    t->entry = entry;
+    t->weight = weight;
+    t->cpu_ticks = 0;
+    t->dispatches = 0;
+    t->latency_sum = 0;
+    t->latency_max = 0;
+    sched_make_ready(t, metriplectic_heartbeat_get_ticks());
+
+    sched_irq_restore(flags);
+    return (int)id;
+}
+
+void sched_yield(void) {
+    if (!sched_running) return;
+    __asm__ __volatile__("int %0" : : "i"(SCHED_YIELD_VECTOR) : "memory");
+}
+
+void sched_sleep(uint32_t ticks) {
+    if (!sched_running) {
+        uint32_t start = metriplectic_heartbeat_get_ticks();
+        while (metriplectic_heartbeat_get_ticks() - start < ticks) {
+            __asm__ __volatile__("pause");
+        }
+        return;
+    }
+
+    /* Con IF=0 ningún tick puede despertarla antes de ceder */
+    uint32_t flags = sched_irq_save();
+    current->wake_tick = metriplectic_heartbeat_get_ticks() + ticks;
+    current->state = SCHED_TASK_SLEEPING;
+    __asm__ __volatile__("int %0" : : "i"(SCHED_YIELD_VECTOR) : "memory");
+    sched_irq_restore(flags);
+}
+
+void sched_exit(void) {
+    __asm__ __volatile__("cli");
+    current->state = SCHED_TASK_DEAD;
+    __asm__ __volatile__("int %0" : : "i"(SCHED_YIELD_VECTOR) : "memory");
+
+    /* No se vuelve a elegir una tarea muerta */
+    while (1) {
+        __asm__ __volatile__("hlt");
+    }
+}
+
+void sched_tick(void) {
+    if (!sched_running) return;
+
+    uint32_t now = metriplectic_heartbeat_get_ticks();
+    current->cpu_ticks++;
+
+    for (uint32_t i = 0; i < SCHED_MAX_TASKS; i++) {
+        SchedTask *t = &tasks[i];
+        if (t->state == SCHED_TASK_SLEEPING && (int32_t)(now - t->wake_tick) >= 0) {
+            sched_make_ready(t, now);
+            /* Despertar no espera al fin de la rodaja de la tarea ociosa */
+            if (current == &tasks[SCHED_IDLE_ID]) need_resched = 1;
+        }
+    }
+
+    if (--slice_left == 0) need_resched = 1;
+}
+
+InterruptFrame *sched_interrupt(InterruptFrame *frame, int yield) {
+    if (!sched_running || (!yield && !need_resched)) return frame;
+
+    uint32_t now = metriplectic_heartbeat_get_ticks();
+    SchedTask *prev = current;
+
+    /* Expropiada o cedida: vuelve a la cola; dormida o muerta no */
+    if (prev->state == SCHED_TASK_RUNNING) sched_make_ready(prev, now);
+
+    SchedTask *next = sched_pick();
+    need_resched = 0;
+    slice_left = SCHED_SLICE_TICKS;
+
+    if (next == prev) {
+        prev->state = SCHED_TASK_RUNNING;
+        return frame;
+    }
+
+    prev->frame = frame;
+    __asm__ __volatile__("fnsave %0" : "=m"(prev->fpu));
+    prev->fpu_valid = 1;
+
+    if (next->fpu_valid) {
+        __asm__ __volatile__("frstor %0" : : "m"(next->fpu));
+    } else {
+        __asm__ __volatile__("fninit");
+    }
+
+    uint32_t latency = now - next->ready_since;
+    next->latency_sum += latency;
+    if (latency > next->latency_max) next->latency_max = latency;
+    next->dispatches++;
+    next->state = SCHED_TASK_RUNNING;
+    current = next;
+
+    return next->frame;
+}
+
+int sched_get_stats(uint32_t id, SchedTaskStats *out) {
+    if (id >= SCHED_MAX_TASKS || tasks[id].state == SCHED_TASK_FREE) return 0;
+
+    uint32_t flags = sched_irq_save();
+    const SchedTask *t = &tasks[id];
+    out->name = t->name;
+    out->state = t->state;
+    out->weight = t->weight;
+    out->cpu_ticks = t->cpu_ticks;
+    out->dispatches = t->dispatches;
+    out->latency_sum = t->latency_sum;
+    out->latency_max = t->latency_max;
+    sched_irq_restore(flags);
+    return 1;
+}
@@ -0,0 +1,89 @@
+/*
+ * Scheduler Cuasiperiódico - Smopsys Q-CORE
+ *
+ * Hilos de kernel con expropiación desde el latido (IRQ0). Cada
+ * SCHED_SLICE_TICKS ms se elige la siguiente tarea con la secuencia
+ * de Weyl del operador áureo: u_k = frac(k·φ') cae en el intervalo
+ * de pesos de una tarea lista. La secuencia es de baja discrepancia,
+ * así que cada tarea recibe CPU en proporción a su peso sin patrón
+ * periódico: dos tareas periódicas no pueden quedar en fase.
+ *
+ * El contexto de una tarea es el marco de interrupción que quedó en
+ * su propia pila más su estado x87 (fnsave/frstor): el shell y la
+ * simulación láser usan FPU; el latido sólo en su trabajo diferido,
+ * que guarda y restaura el x87 por su cuenta.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include "idt.h"
+
+#define SCHED_MAX_TASKS      6
+#define SCHED_STACK_SIZE     16384  /* Pila por hilo (bytes) */
+#define SCHED_SLICE_TICKS    4      /* Rodaja de tiempo (ms) */
+#define SCHED_YIELD_VECTOR   0x30   /* int 0x30: ceder la CPU */
+#define SCHED_FPU_STATE_SIZE 108    /* Imagen de fnsave */
+#define SCHED_IDLE_COMPACT_CYCLES 200000  /* Presupuesto de compactación por vuelta ociosa */
+
+/* Estados de una tarea */
+#define SCHED_TASK_FREE      0
+#define SCHED_TASK_READY     1
+#define SCHED_TASK_RUNNING   2
+#define SCHED_TASK_SLEEPING  3
+#define SCHED_TASK_DEAD      4
+
+/* Estadísticas por tarea (ticks = ms de latido) */
+typedef struct {
+    const char *name;
+    uint8_t state;
+    uint32_t weight;
+    uint32_t cpu_ticks;         /* Ticks en los que la tarea estaba en CPU */
+    uint32_t dispatches;        /* Veces que recibió la CPU */
+    uint32_t latency_sum;       /* Espera total lista → en CPU */
+    uint32_t latency_max;       /* Peor espera lista → en CPU */
+} SchedTaskStats;
+
+/* Sección crítica corta frente al latido (guarda y restaura IF) */
+static inline uint32_t sched_irq_save(void) {
+    uint32_t flags;
+    __asm__ __volatile__("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void sched_irq_restore(uint32_t flags) {
+    __asm__ __volatile__("pushl %0; popfl" : : "r"(flags) : "memory", "cc");
+}
+
+/*
+ * Convertir el flujo actual (kernel_main) en la tarea 0 y crear la
+ * tarea ociosa. Llamar con interrupciones deshabilitadas.
+ */
+void sched_init(const char *name, uint32_t weight);
+
+/* Crear un hilo de kernel; retorna su id o -1 si no hay hueco */
+int sched_spawn(const char *name, void (*entry)(void), uint32_t weight);
+
+/* Ceder el resto de la rodaja */
+void sched_yield(void);
+
+/* Dormir al menos ticks ms (espera activa si el scheduler no arrancó) */
+void sched_sleep(uint32_t ticks);
+
+/* Terminar el hilo actual (también al retornar de su entry) */
+void sched_exit(void);
+
+/* Contabilidad por tick; la llama el latido desde la ISR */
+void sched_tick(void);
+
+/*
+ * Punto de cambio de contexto, llamado por isr_handler tras el EOI.
+ * Retorna el marco a restaurar: el mismo u otro hilo.
+ */
+InterruptFrame *sched_interrupt(InterruptFrame *frame, int yield);
+
+/* Estadísticas de la tarea id; retorna 0 si el hueco está libre */
+int sched_get_stats(uint32_t id, SchedTaskStats *out);
+
+#endif /* SCHED_H */
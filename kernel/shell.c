@@ -6,19 +6,31 @@
 #include "../drivers/vga_holographic.h"
 #include "../drivers/metriplectic_kbd.h"
 #include "golden_operator.h"
+#include "sched.h"
+#include "slab.h"
+#include "paging.h"
 #include "../drivers/metriplectic_heartbeat.h"
 #include <stdint.h>
 
 extern GoldenState current_golden_state;
-extern GoldenObservables current_golden_obs;
+extern GoldenObservablesCache current_golden_obs;
 
 /* Memory Manager Bridge */
 uint32_t memory_get_used_pages(void);
 uint32_t memory_get_total_pages(void);
+uint32_t memory_get_e820_entries(void);
 double memory_get_centroid_z(void);
 double memory_get_total_entropy(void);
 
 int memory_get_page_stats(uint32_t idx, uint32_t *addr, double *theta, int *state);
+void memory_get_sweep_stats(uint32_t *cursor, uint32_t *laps, uint32_t *last_pages,
+                            uint32_t *max_cycles, uint32_t *overruns);
+void memory_get_zero_pool_stats(uint32_t *count, uint32_t *hits, uint32_t *misses);
+void memory_get_fragmentation(uint32_t *free_pages, uint32_t *largest_run, uint32_t *largest_block,
+                              uint32_t *histogram, uint32_t buckets);
+void memory_get_compact_stats(uint32_t *passes, uint32_t *moves, uint32_t *pages, uint32_t *handles);
+
+#define FRAG_BUCKETS 12     /* Tramos libres de 1 a ≥2048 páginas */
 
 
 
@@ -49,7 +61,7 @@ static void shell_prompt(void) {
 
 static void exec_command(const char *cmd) {
     if (strcmp(cmd, "help") == 0) {
-        vga_holographic_write("Commands: status, ticks, memory, pages, laser, clear, help\n");
+        vga_holographic_write("Commands: status, ticks, tasks, memory, pages, slabs, frag, laser, clear, help\n");
 
     } else if (strcmp(cmd, "clear") == 0) {
         vga_holographic_clear();
@@ -62,9 +74,42 @@ static void exec_command(const char *cmd) {
         vga_holographic_write("\n--- METRIPLECTIC ENGINE STATE ---\n");
         vga_holographic_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
         vga_holographic_write("  Ticks: "); vga_holographic_write_decimal(metriplectic_heartbeat_get_ticks());
-        vga_holographic_write("\n  O_n:   "); vga_holographic_write_float(current_golden_state.O_n, 6);
-        vga_holographic_write("\n  Theta: "); vga_holographic_write_float(current_golden_state.theta, 6);
+        vga_holographic_write("\n  O_n:   "); vga_holographic_write_float(fp_to_double(current_golden_state.O_n), 6);
+        vga_holographic_write("\n  Theta: "); vga_holographic_write_float(fp_to_double(current_golden_state.theta), 6);
+
+        const GoldenObservables *obs = golden_operator_get_observables(&current_golden_state, &current_golden_obs);
+        vga_holographic_write("\n  Re:    "); vga_holographic_write_float(fp_to_double(obs->reynolds_info), 4);
+        vga_holographic_write("\n  IPR:   "); vga_holographic_write_float(fp_to_double(obs->ipr), 6);
         vga_holographic_write("\n  Flow:  LAMINAR\n");
+    } else if (strcmp(cmd, "tasks") == 0) {
+        static const char *state_names[] = { "FREE", "READY", "RUN", "SLEEP", "DEAD" };
+
+        vga_holographic_set_color(VGA_COLOR_CYAN, VGA_COLOR_BLACK);
+        vga_holographic_write("\n--- GOLDEN SCHEDULER ---\n");
+        vga_holographic_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+        vga_holographic_write(" ID NAME       STATE  W  CPU(ms)  RUNS  LAT avg/max (ms)\n");
+
+        SchedTaskStats st;
+        for (uint32_t id = 0; id < SCHED_MAX_TASKS; id++) {
+            if (!sched_get_stats(id, &st)) continue;
+            vga_holographic_write(" ");
+            vga_holographic_write_decimal(id);
+            vga_holographic_write("  ");
+            vga_holographic_write(st.name);
+            for (uint32_t pad = strlen(st.name); pad < 11; pad++) vga_holographic_write_char(' ');
+            vga_holographic_write(state_names[st.state]);
+            for (uint32_t pad = strlen(state_names[st.state]); pad < 7; pad++) vga_holographic_write_char(' ');
+            vga_holographic_write_decimal(st.weight);
+            vga_holographic_write("  ");
+            vga_holographic_write_decimal(st.cpu_ticks);
+            vga_holographic_write("  ");
+            vga_holographic_write_decimal(st.dispatches);
+            vga_holographic_write("  ");
+            vga_holographic_write_float(st.dispatches ? (double)st.latency_sum / st.dispatches : 0.0, 2);
+            vga_holographic_write("/");
+            vga_holographic_write_decimal(st.latency_max);
+            vga_holographic_write_char('\n');
+        }
     } else if (strcmp(cmd, "laser") == 0) {
         vga_holographic_write("Laser: Active (Metriplectic feedback loop)\n");
     } else if (strcmp(cmd, "memory") == 0) {
@@ -82,6 +127,18 @@ static void exec_command(const char *cmd) {
         vga_holographic_write("/");
         vga_holographic_write_decimal(total);
         
+        /* RAM gestionada y su origen: mapa E820 o megabyte por defecto */
+        uint32_t e820 = memory_get_e820_entries();
+        vga_holographic_write("\n  RAM:      ");
+        vga_holographic_write_decimal(total >> 8);
+        if (e820) {
+            vga_holographic_write(" MB (E820, ");
+            vga_holographic_write_decimal(e820);
+            vga_holographic_write(" entries)");
+        } else {
+            vga_holographic_write(" MB (default, no E820 map)");
+        }
+        
         vga_holographic_write("\n  Centroid: ");
         if (z_finch < 0.5) vga_holographic_set_color(COLOR_COHERENT, VGA_COLOR_BLACK);
         else vga_holographic_set_color(COLOR_DISSIPATIVE, VGA_COLOR_BLACK);
@@ -91,7 +148,119 @@ static void exec_command(const char *cmd) {
         vga_holographic_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
         vga_holographic_write("\n  Entropy:  ");
         vga_holographic_write_float(entropy, 4);
+
+        /* Barrido incremental del latido: posición, vueltas y presupuesto */
+        uint32_t cursor, laps, last_pages, max_cycles, overruns;
+        memory_get_sweep_stats(&cursor, &laps, &last_pages, &max_cycles, &overruns);
+        vga_holographic_write("\n  Sweep:    ");
+        vga_holographic_write_decimal(cursor);
+        vga_holographic_write("/");
+        vga_holographic_write_decimal(total);
+        vga_holographic_write(" lap ");
+        vga_holographic_write_decimal(laps);
+        vga_holographic_write(" (");
+        vga_holographic_write_decimal(last_pages);
+        vga_holographic_write(" pages/tick)");
+        vga_holographic_write("\n  Budget:   max ");
+        vga_holographic_write_decimal(max_cycles);
+        vga_holographic_write("/");
+        vga_holographic_write_decimal(HEARTBEAT_MEMORY_BUDGET_CYCLES);
+        vga_holographic_write(" cycles, overruns ");
+        if (overruns) vga_holographic_set_color(VGA_COLOR_LIGHT_RED, VGA_COLOR_BLACK);
+        vga_holographic_write_decimal(overruns);
+        vga_holographic_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+
+        /* Reserva de páginas a cero que rellena el tiempo ocioso */
+        uint32_t zero_count, zero_hits, zero_misses;
+        memory_get_zero_pool_stats(&zero_count, &zero_hits, &zero_misses);
+        vga_holographic_write("\n  Zeroed:   ");
+        vga_holographic_write_decimal(zero_count);
+        vga_holographic_write(" pages ready, hits ");
+        vga_holographic_write_decimal(zero_hits);
+        vga_holographic_write(", misses ");
+        vga_holographic_write_decimal(zero_misses);
+
+        /* Paginación: mapa identidad y arenas respaldadas bajo demanda */
+        PagingStats pst;
+        paging_get_stats(&pst);
+        vga_holographic_write("\n  Paging:   ");
+        if (pst.enabled) {
+            vga_holographic_write_decimal(pst.identity_top >> 22);
+            vga_holographic_write(" x 4MB identity, ");
+            vga_holographic_write_decimal(pst.arenas);
+            vga_holographic_write(" arenas ");
+            vga_holographic_write_decimal(pst.committed_pages);
+            vga_holographic_write("/");
+            vga_holographic_write_decimal(pst.reserved_bytes >> 12);
+            vga_holographic_write(" pages, ");
+            vga_holographic_write_decimal(pst.faults);
+            vga_holographic_write(" faults");
+        } else {
+            vga_holographic_write("off (no PSE)");
+        }
         vga_holographic_write("\n");
+    } else if (strcmp(cmd, "slabs") == 0) {
+        vga_holographic_set_color(VGA_COLOR_CYAN, VGA_COLOR_BLACK);
+        vga_holographic_write("\n--- SLAB CACHES ---\n");
+        vga_holographic_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+        vga_holographic_write(" NAME          SIZE  OBJS/SLAB  IN USE  P/F/E\n");
+
+        for (uint32_t id = 0; id < SLAB_MAX_CACHES; id++) {
+            SlabCacheStats st;
+            if (!slab_get_stats(id, &st)) continue;
+            vga_holographic_write(" ");
+            vga_holographic_write(st.name);
+            for (uint32_t pad = strlen(st.name); pad < 14; pad++) vga_holographic_write_char(' ');
+            vga_holographic_write_decimal(st.obj_size);
+            vga_holographic_write("  ");
+            vga_holographic_write_decimal(st.objs_per_slab);
+            vga_holographic_write("  ");
+            vga_holographic_write_decimal(st.objs_in_use);
+            vga_holographic_write("  ");
+            vga_holographic_write_decimal(st.slabs_partial);
+            vga_holographic_write("/");
+            vga_holographic_write_decimal(st.slabs_full);
+            vga_holographic_write("/");
+            vga_holographic_write_decimal(st.slabs_empty);
+            vga_holographic_write_char('\n');
+        }
+    } else if (strcmp(cmd, "frag") == 0) {
+        uint32_t free_pages, largest_run, largest_block;
+        uint32_t histogram[FRAG_BUCKETS];
+        memory_get_fragmentation(&free_pages, &largest_run, &largest_block, histogram, FRAG_BUCKETS);
+
+        vga_holographic_set_color(VGA_COLOR_CYAN, VGA_COLOR_BLACK);
+        vga_holographic_write("\n--- FRAGMENTATION ---\n");
+        vga_holographic_set_color(VGA_COLOR_WHITE, VGA_COLOR_BLACK);
+        vga_holographic_write("  Free:     ");
+        vga_holographic_write_decimal(free_pages);
+        vga_holographic_write(" pages, largest run ");
+        vga_holographic_write_decimal(largest_run);
+        vga_holographic_write(", largest block ");
+        vga_holographic_write_decimal(largest_block);
+
+        /* Histograma de tramos libres: sólo las cubetas con tramos */
+        vga_holographic_write("\n  Runs:    ");
+        for (uint32_t b = 0; b < FRAG_BUCKETS; b++) {
+            if (!histogram[b]) continue;
+            vga_holographic_write(" ");
+            vga_holographic_write_decimal(1u << b);
+            vga_holographic_write((b == FRAG_BUCKETS - 1) ? "+:" : ":");
+            vga_holographic_write_decimal(histogram[b]);
+        }
+
+        /* Compactación ociosa de los bloques reubicables */
+        uint32_t passes, moves, moved_pages, handles;
+        memory_get_compact_stats(&passes, &moves, &moved_pages, &handles);
+        vga_holographic_write("\n  Compact:  ");
+        vga_holographic_write_decimal(passes);
+        vga_holographic_write(" passes, ");
+        vga_holographic_write_decimal(moves);
+        vga_holographic_write(" moves (");
+        vga_holographic_write_decimal(moved_pages);
+        vga_holographic_write(" pages), ");
+        vga_holographic_write_decimal(handles);
+        vga_holographic_write(" handles\n");
     } else if (strcmp(cmd, "pages") == 0) {
         vga_holographic_set_color(VGA_COLOR_CYAN, VGA_COLOR_BLACK);
         vga_holographic_write("\n--- METRIPLECTIC PAGES (First 15) ---\n");
@@ -0,0 +1,288 @@
+/*
+ * Slab Allocator - Implementación
+ * Smopsys Q-CORE
+ *
+ * Tabla fija de SLAB_MAX_CACHES cachés. El slab lleva su cabecera al
+ * principio y los objetos detrás, con paso alineado a SLAB_ALIGN. Los
+ * objetos libres forman una lista enlazada dentro del slab: el enlace
+ * ocupa la primera palabra del objeto o, si la caché tiene
+ * constructor, una palabra propia tras él para no pisar el estado
+ * construido. Todo el estado se toca dentro de sched_irq_save/restore.
+ */
+
+#include "slab.h"
+#include "sched.h"
+
+/* Declaración externa de funciones de MemoryManager.cpp */
+extern uint32_t memory_allocate(uint32_t size);
+extern void memory_free(uint32_t address);
+extern void memory_discard(uint32_t address);
+extern void memory_register_reclaimer(uint32_t (*reclaim)(uint32_t pages_wanted));
+
+#define SLAB_ALIGN        16
+#define SLAB_MAGIC        0x51AB51ABu
+#define SLAB_NUM_CLASSES  8             /* 16 ... 2048 */
+
+/* Listas de slabs de una caché */
+#define SLAB_LIST_PARTIAL 0
+#define SLAB_LIST_FULL    1
+#define SLAB_LIST_EMPTY   2
+#define SLAB_LISTS        3
+
+typedef struct Slab {
+    uint32_t magic;
+    struct Slab *next;
+    struct Slab *prev;
+    SlabCache *cache;
+    void *free_objs;            /* Primer objeto libre */
+    uint16_t in_use;
+    uint8_t list;
+} Slab;
+
+struct SlabCache {
+    const char *name;
+    uint32_t obj_size;
+    uint32_t stride;            /* Distancia entre objetos */
+    uint32_t link_offset;       /* Posición del enlace de la lista libre */
+    uint32_t capacity;          /* Objetos por slab */
+    void (*ctor)(void *obj);
+    Slab *lists[SLAB_LISTS];
+    uint32_t counts[SLAB_LISTS];
+    uint32_t objs_in_use;
+    uint8_t used;
+};
+
+#define SLAB_OBJ_OFFSET ((sizeof(Slab) + SLAB_ALIGN - 1) & ~(uint32_t)(SLAB_ALIGN - 1))
+
+static SlabCache caches[SLAB_MAX_CACHES];
+static SlabCache *kmalloc_classes[SLAB_NUM_CLASSES];
+static const char *const class_names[SLAB_NUM_CLASSES] = {
+    "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128",
+    "kmalloc-256", "kmalloc-512", "kmalloc-1024", "kmalloc-2048"
+};
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+static inline void **obj_link(const SlabCache *c, void *obj) {
+    return (void **)((uint8_t *)obj + c->link_offset);
+}
+
+static void slab_list_push(SlabCache *c, Slab *s, uint8_t list) {
+    s->list = list;
+    s->prev = 0;
+    s->next = c->lists[list];
+    if (s->next) s->next->prev = s;
+    c->lists[list] = s;
+    c->counts[list]++;
+}
+
+static void slab_list_remove(SlabCache *c, Slab *s) {
+    if (s->prev) s->prev->next = s->next;
+    else c->lists[s->list] = s->next;
+    if (s->next) s->next->prev = s->prev;
+    c->counts[s->list]--;
+}
+
+static void slab_list_move(SlabCache *c, Slab *s, uint8_t list) {
+    if (s->list == list) return;
+    slab_list_remove(c, s);
+    slab_list_push(c, s, list);
+}
+
+/* Slab nuevo en la lista de vacíos, con sus objetos construidos */
+static Slab *slab_grow(SlabCache *c) {
+    uint32_t addr = memory_allocate(SLAB_SIZE);
+    if (!addr) return 0;
+
+    /* El enmascarado de slab_free exige alineación a SLAB_SIZE */
+    if (addr & (SLAB_SIZE - 1)) {
+        memory_free(addr);
+        return 0;
+    }
+
+    Slab *s = (Slab *)(uintptr_t)addr;
+    s->magic = SLAB_MAGIC;
+    s->cache = c;
+    s->in_use = 0;
+    s->free_objs = 0;
+
+    /* Enlazar de atrás hacia delante: el primer objeto sale primero */
+    uint8_t *base = (uint8_t *)s + SLAB_OBJ_OFFSET;
+    for (uint32_t i = c->capacity; i-- > 0; ) {
+        void *obj = base + i * c->stride;
+        if (c->ctor) c->ctor(obj);
+        *obj_link(c, obj) = s->free_objs;
+        s->free_objs = obj;
+    }
+
+    slab_list_push(c, s, SLAB_LIST_EMPTY);
+    return s;
+}
+
+/* Devolver un slab vacío al gestor. Al reclamar (discard) sus páginas
+ * vuelven al buddy en el acto; si no, se evaporan como cualquier bloque */
+static void slab_release(SlabCache *c, Slab *s, int discard) {
+    slab_list_remove(c, s);
+    s->magic = 0;
+    if (discard) memory_discard((uint32_t)(uintptr_t)s);
+    else memory_free((uint32_t)(uintptr_t)s);
+}
+
+/* Clase de kmalloc para size (size ≤ SLAB_MAX_OBJECT) */
+static uint32_t kmalloc_class(uint32_t size) {
+    uint32_t cls = 0;
+    while (((uint32_t)SLAB_MIN_OBJECT << cls) < size) cls++;
+    return cls;
+}
+
+/* ============================================================
+ * API PÚBLICA
+ * ============================================================ */
+
+void slab_init(void) {
+    for (uint32_t i = 0; i < SLAB_MAX_CACHES; i++) {
+        caches[i].used = 0;
+    }
+    for (uint32_t k = 0; k < SLAB_NUM_CLASSES; k++) {
+        kmalloc_classes[k] = slab_cache_create(class_names[k], SLAB_MIN_OBJECT << k, 0);
+    }
+
+    memory_register_reclaimer(slab_reclaim);
+}
+
+SlabCache *slab_cache_create(const char *name, uint32_t size, void (*ctor)(void *obj)) {
+    if (size == 0) return 0;
+
+    /* Con constructor el enlace va tras el objeto, sin pisarlo */
+    uint32_t link_offset = ctor ? (size + sizeof(void *) - 1) & ~(uint32_t)(sizeof(void *) - 1) : 0;
+    uint32_t span = ctor ? link_offset + sizeof(void *) : size;
+    if (span < sizeof(void *)) span = sizeof(void *);
+    uint32_t stride = (span + SLAB_ALIGN - 1) & ~(uint32_t)(SLAB_ALIGN - 1);
+    if (stride > SLAB_SIZE - SLAB_OBJ_OFFSET) return 0;
+
+    uint32_t flags = sched_irq_save();
+    SlabCache *c = 0;
+    for (uint32_t i = 0; i < SLAB_MAX_CACHES; i++) {
+        if (!caches[i].used) {
+            c = &caches[i];
+            break;
+        }
+    }
+    if (!c) {
+        sched_irq_restore(flags);
+        return 0;
+    }
+
+    c->name = name;
+    c->obj_size = size;
+    c->stride = stride;
+    c->link_offset = link_offset;
+    c->capacity = (SLAB_SIZE - SLAB_OBJ_OFFSET) / stride;
+    c->ctor = ctor;
+    for (uint32_t l = 0; l < SLAB_LISTS; l++) {
+        c->lists[l] = 0;
+        c->counts[l] = 0;
+    }
+    c->objs_in_use = 0;
+    c->used = 1;
+
+    sched_irq_restore(flags);
+    return c;
+}
+
+void *slab_alloc(SlabCache *c) {
+    if (!c) return 0;
+
+    uint32_t flags = sched_irq_save();
+
+    /* Parciales primero: los vacíos quedan para devolverlos al gestor */
+    Slab *s = c->lists[SLAB_LIST_PARTIAL];
+    if (!s) s = c->lists[SLAB_LIST_EMPTY];
+    if (!s) s = slab_grow(c);
+    if (!s) {
+        sched_irq_restore(flags);
+        return 0;
+    }
+
+    void *obj = s->free_objs;
+    s->free_objs = *obj_link(c, obj);
+    s->in_use++;
+    c->objs_in_use++;
+    slab_list_move(c, s, (s->in_use == c->capacity) ? SLAB_LIST_FULL : SLAB_LIST_PARTIAL);
+
+    sched_irq_restore(flags);
+    return obj;
+}
+
+void slab_free(void *obj) {
+    if (!obj) return;
+
+    Slab *s = (Slab *)((uintptr_t)obj & ~(uintptr_t)(SLAB_SIZE - 1));
+    if ((uint8_t *)obj < (uint8_t *)s + SLAB_OBJ_OFFSET) return;
+
+    uint32_t flags = sched_irq_save();
+    if (s->magic != SLAB_MAGIC || s->in_use == 0) {
+        sched_irq_restore(flags);
+        return;
+    }
+
+    SlabCache *c = s->cache;
+    *obj_link(c, obj) = s->free_objs;
+    s->free_objs = obj;
+    s->in_use--;
+    c->objs_in_use--;
+
+    if (s->in_use > 0) {
+        slab_list_move(c, s, SLAB_LIST_PARTIAL);
+    } else if (c->counts[SLAB_LIST_EMPTY] >= SLAB_EMPTY_KEEP) {
+        slab_release(c, s, 0);
+    } else {
+        slab_list_move(c, s, SLAB_LIST_EMPTY);
+    }
+
+    sched_irq_restore(flags);
+}
+
+void *kmalloc(uint32_t size) {
+    if (size == 0 || size > SLAB_MAX_OBJECT) return 0;
+    return slab_alloc(kmalloc_classes[kmalloc_class(size)]);
+}
+
+void kfree(void *ptr) {
+    slab_free(ptr);
+}
+
+uint32_t slab_reclaim(uint32_t pages_wanted) {
+    uint32_t flags = sched_irq_save();
+    uint32_t freed = 0;
+
+    for (uint32_t i = 0; i < SLAB_MAX_CACHES && freed < pages_wanted; i++) {
+        SlabCache *c = &caches[i];
+        if (!c->used) continue;
+        while (c->lists[SLAB_LIST_EMPTY] && freed < pages_wanted) {
+            slab_release(c, c->lists[SLAB_LIST_EMPTY], 1);
+            freed += SLAB_PAGES;
+        }
+    }
+
+    sched_irq_restore(flags);
+    return freed;
+}
+
+int slab_get_stats(uint32_t id, SlabCacheStats *out) {
+    if (id >= SLAB_MAX_CACHES || !caches[id].used) return 0;
+
+    uint32_t flags = sched_irq_save();
+    const SlabCache *c = &caches[id];
+    out->name = c->name;
+    out->obj_size = c->obj_size;
+    out->objs_per_slab = c->capacity;
+    out->objs_in_use = c->objs_in_use;
+    out->slabs_partial = c->counts[SLAB_LIST_PARTIAL];
+    out->slabs_full = c->counts[SLAB_LIST_FULL];
+    out->slabs_empty = c->counts[SLAB_LIST_EMPTY];
+    sched_irq_restore(flags);
+    return 1;
+}
@@ -0,0 +1,69 @@
+/*
+ * Slab Allocator - Smopsys Q-CORE
+ *
+ * Objetos pequeños sobre bloques del gestor de memoria metriplético.
+ * Cada caché reparte objetos de un tamaño fijo desde slabs de
+ * SLAB_SIZE bytes (un bloque buddy alineado a su tamaño, así que la
+ * cabecera de un objeto se halla enmascarando su dirección). Los slabs
+ * de una caché viven en tres listas: parciales, llenos y vacíos; pedir
+ * y devolver un objeto es O(1).
+ *
+ * kmalloc/kfree usan las clases 16, 32, ... SLAB_MAX_OBJECT bytes.
+ * Las cachés con constructor lo llaman una vez por objeto al crear el
+ * slab: quien devuelve un objeto debe dejarlo en estado construido.
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stdint.h>
+
+#define SLAB_PAGES        4             /* Páginas por slab (orden buddy 2) */
+#define SLAB_SIZE         (SLAB_PAGES * 4096)
+#define SLAB_MAX_CACHES   16            /* Clases de kmalloc + cachés con nombre */
+#define SLAB_MIN_OBJECT   16            /* Clase menor de kmalloc */
+#define SLAB_MAX_OBJECT   2048          /* Clase mayor de kmalloc */
+#define SLAB_EMPTY_KEEP   1             /* Slabs vacíos retenidos por caché */
+
+typedef struct SlabCache SlabCache;
+
+/* Estadísticas de una caché */
+typedef struct {
+    const char *name;
+    uint32_t obj_size;
+    uint32_t objs_per_slab;
+    uint32_t objs_in_use;
+    uint32_t slabs_partial;
+    uint32_t slabs_full;
+    uint32_t slabs_empty;
+} SlabCacheStats;
+
+/* Crear las clases de kmalloc y registrarse como reclamable en el
+ * gestor. Llamar tras memory_init. */
+void slab_init(void);
+
+/*
+ * Caché de objetos de size bytes; ctor (opcional) se aplica a cada
+ * objeto al crear su slab. Retorna NULL si no hay hueco o el objeto
+ * no cabe en un slab.
+ */
+SlabCache *slab_cache_create(const char *name, uint32_t size, void (*ctor)(void *obj));
+
+/* Objeto de la caché (NULL sin memoria) */
+void *slab_alloc(SlabCache *cache);
+
+/* Devolver un objeto a su caché (ignora NULL y punteros ajenos) */
+void slab_free(void *obj);
+
+/* Bloque de hasta SLAB_MAX_OBJECT bytes; NULL si size es 0 o mayor
+ * (los bloques mayores se piden a memory_allocate) */
+void *kmalloc(uint32_t size);
+void kfree(void *ptr);
+
+/* Liberar slabs vacíos hasta pages_wanted páginas; retorna las devueltas */
+uint32_t slab_reclaim(uint32_t pages_wanted);
+
+/* Estadísticas de la caché id; retorna 0 si el hueco está libre */
+int slab_get_stats(uint32_t id, SlabCacheStats *out);
+
+#endif /* SLAB_H */
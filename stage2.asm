@@ -16,8 +16,25 @@
 
 ; Constantes
 KERNEL_LOAD_ADDR    equ 0x10000     ; 64KB
-KERNEL_SECTORS      equ 64          ; 32KB máximo
-KERNEL_START_SECTOR equ 6           ; Después de Stage1 + Stage2
+KERNEL_START_LBA    equ 5           ; Después de Stage1 + Stage2 (sector CHS 6)
+KERNEL_MAX_SECTORS  equ 1024        ; Ventana 0x10000-0x8FFFF (la pila empieza en 0x90000)
+KERNEL_CHUNK        equ 64          ; 32KB por lectura: nunca cruza un límite de 64KB
+
+; El Makefile pasa -DKERNEL_SECTORS con el tamaño de kernel.bin
+%ifndef KERNEL_SECTORS
+%define KERNEL_SECTORS 64
+%endif
+%if KERNEL_SECTORS > KERNEL_MAX_SECTORS
+%error "kernel.bin no cabe en la ventana de carga"
+%endif
+
+; Mapa E820 para el kernel (kernel/e820.h)
+E820_MAP_ADDR       equ 0x5000
+E820_MAGIC          equ 0x30323845  ; 'E820'
+E820_MAX_ENTRIES    equ 32
+E820_HEADER_SIZE    equ 8           ; magic + número de entradas
+E820_ENTRY_SIZE     equ 24
+E820_ACPI_VALID     equ 1
 
 stage2_start:
     ; Guardar unidad de boot
@@ -155,29 +172,60 @@ print_string:
     ret
 
 ; Detectar memoria usando INT 15h, E820
+; Las entradas quedan en E820_MAP_ADDR para el kernel (ver kernel/e820.h);
+; la cabecera (magic + número de entradas) se escribe sólo si hubo mapa
 detect_memory:
-    pusha
-    mov di, memory_map
+    pushad
+    push es
+    xor ax, ax
+    mov es, ax
+    mov dword [E820_MAP_ADDR], 0    ; Sin magic hasta terminar
+    mov di, E820_MAP_ADDR + E820_HEADER_SIZE
     xor ebx, ebx
-    mov edx, 0x534D4150     ; 'SMAP'
+    xor bp, bp                      ; Entradas guardadas
     
 .loop:
+    mov dword [es:di + 20], E820_ACPI_VALID ; Por si la BIOS devuelve 20 bytes
     mov eax, 0xE820
-    mov ecx, 24
+    mov ecx, E820_ENTRY_SIZE
+    mov edx, 0x534D4150     ; 'SMAP' (algunas BIOS lo pisan)
     int 0x15
     
     jc .done                ; Error o fin
     cmp eax, 0x534D4150
     jne .done
     
-    add di, 24
-    inc word [memory_entries]
+    ; Descartar regiones de longitud cero
+    mov eax, [es:di + 8]
+    or eax, [es:di + 12]
+    jz .next
+    
+    add di, E820_ENTRY_SIZE
+    inc bp
+    cmp bp, E820_MAX_ENTRIES
+    je .done
     
+.next:
     test ebx, ebx
     jnz .loop
     
 .done:
-    popa
+    test bp, bp
+    jz .no_map
+    movzx eax, bp
+    mov [E820_MAP_ADDR + 4], eax
+    mov dword [E820_MAP_ADDR], E820_MAGIC
+    mov si, msg_ok
+    call print_string
+    jmp .exit
+    
+.no_map:
+    mov si, msg_no_e820
+    call print_string
+    
+.exit:
+    pop es
+    popad
     ret
 
 ; Habilitar línea A20 (método rápido + teclado)
@@ -237,24 +285,46 @@ enable_a20:
     ret
 
 ; Cargar kernel desde disco
+; Lecturas LBA (INT 13h, AH=42h) de KERNEL_CHUNK sectores: cada una
+; empieza en un múltiplo de 32KB, así que ninguna cruza un límite de 64KB
 load_kernel:
     pusha
     
-    ; Cargar kernel en segmentos de 64 sectores
-    mov ax, KERNEL_LOAD_ADDR >> 4   ; Segmento
-    mov es, ax
-    xor bx, bx                      ; Offset 0
-    
-    mov ah, 0x02
-    mov al, KERNEL_SECTORS
-    mov ch, 0
-    mov cl, KERNEL_START_SECTOR
-    mov dh, 0
+    ; Comprobar las extensiones de INT 13h
+    mov ah, 0x41
+    mov bx, 0x55AA
     mov dl, [boot_drive]
+    int 0x13
+    jc .error
+    cmp bx, 0xAA55
+    jne .error
+    
+    mov cx, KERNEL_SECTORS          ; Sectores pendientes
+    
+.chunk:
+    mov ax, KERNEL_CHUNK
+    cmp cx, ax
+    jae .read
+    mov ax, cx
     
+.read:
+    mov [dap_count], ax
+    mov si, dap
+    mov dl, [boot_drive]
+    push ax
+    mov ah, 0x42
     int 0x13
+    pop ax
     jc .error
     
+    ; Avanzar destino (512 bytes = 32 párrafos) y sector
+    add [dap_lba], ax
+    mov bx, ax
+    shl bx, 5
+    add [dap_segment], bx
+    sub cx, ax
+    jnz .chunk
+    
     popa
     ret
 
@@ -301,8 +371,16 @@ gdt_descriptor:
 ; ============================================================
 
 boot_drive      db 0
-memory_entries  dw 0
-memory_map      times 24*20 db 0    ; Espacio para 20 entradas E820
+
+; Paquete de dirección de disco de INT 13h, AH=42h
+dap:
+                db 0x10                 ; Tamaño del paquete
+                db 0
+dap_count       dw 0                    ; Sectores de esta lectura
+dap_offset      dw 0                    ; Destino segmento:offset
+dap_segment     dw KERNEL_LOAD_ADDR >> 4
+dap_lba         dd KERNEL_START_LBA     ; LBA inicial (64 bits)
+                dd 0
 
 msg_stage2          db 'SMOPSYS Stage 2 Loader', 13, 10, 0
 msg_memory          db 'Detecting memory (E820)...', 0
@@ -311,6 +389,7 @@ msg_kernel          db 'Loading kernel...', 0
 msg_pm              db 'Entering protected mode...', 13, 10, 0
 msg_ok              db 'OK', 13, 10, 0
 msg_error           db 'ERROR!', 13, 10, 0
+msg_no_e820         db 'none (1MB default)', 13, 10, 0
 msg_entering_kernel db 'SMOPSYS Q-CORE Kernel Entry', 0
 
 ; ============================================================
@@ -0,0 +1,133 @@
+/*
+ * Benchmark - DIT Math
+ * Smopsys Q-CORE
+ *
+ * Ciclos por llamada de cada función de dit_math (mínimo sobre
+ * BENCH_REPS rondas de BENCH_N llamadas, rdtsc) frente a los
+ * presupuestos de include/dit_math.h. Son cotas del host a -O2, no
+ * garantías: viven aquí y no en make test. Si alguna se supera el
+ * benchmark sale con código 1.
+ *
+ * Compilar con: make bench
+ * Ejecutar con: ./bench_dit_math
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "../include/dit_math.h"
+
+#define BENCH_N    1024
+#define BENCH_REPS 50
+
+#define BENCH_UNARY_MAX_CYCLES  150.0
+#define BENCH_ATAN2_MAX_CYCLES  300.0
+
+static double bench_inputs[BENCH_N];
+
+/* Evita que el compilador descarte los bucles cronometrados */
+static volatile double sink;
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+/* xorshift64: entradas reproducibles en [lo, hi) */
+static uint64_t rng_state = 88172645463325252ULL;
+
+static double rng_uniform(double lo, double hi) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return lo + (hi - lo) * ((rng_state >> 11) * (1.0 / 9007199254740992.0));
+}
+
+#if defined(__i386__) || defined(__x86_64__)
+static inline uint64_t read_tsc(void) {
+    uint32_t lo, hi;
+    __asm__ __volatile__("lfence; rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* Ciclos por llamada (mínimo de BENCH_REPS repeticiones) */
+static double bench_unary(double (*fn)(double)) {
+    double acc = 0.0;
+    uint64_t best = ~0ULL;
+    for (int rep = 0; rep < BENCH_REPS; rep++) {
+        uint64_t t0 = read_tsc();
+        for (int i = 0; i < BENCH_N; i++) acc += fn(bench_inputs[i]);
+        uint64_t dt = read_tsc() - t0;
+        if (dt < best) best = dt;
+    }
+    sink = acc;
+    return (double)best / BENCH_N;
+}
+
+static double bench_atan2(double (*fn)(double, double)) {
+    double acc = 0.0;
+    uint64_t best = ~0ULL;
+    for (int rep = 0; rep < BENCH_REPS; rep++) {
+        uint64_t t0 = read_tsc();
+        for (int i = 0; i < BENCH_N; i++) acc += fn(bench_inputs[i], bench_inputs[BENCH_N - 1 - i]);
+        uint64_t dt = read_tsc() - t0;
+        if (dt < best) best = dt;
+    }
+    sink = acc;
+    return (double)best / BENCH_N;
+}
+#endif
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void) {
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: DIT Math Benchmark\n");
+    printf("============================================\n\n");
+
+#if defined(__i386__) || defined(__x86_64__)
+    static const struct {
+        const char *name;
+        double (*fn)(double);
+    } unary[] = {
+        { "sin", dit_sin },   { "sin_fast", dit_sin_fast },
+        { "exp", dit_exp },   { "exp_fast", dit_exp_fast },
+        { "log", dit_log },   { "log_fast", dit_log_fast },
+        { "sqrt", dit_sqrt }, { "sqrt_fast", dit_sqrt_fast },
+        { "rsqrt", dit_rsqrt }, { "rsqrt_fast", dit_rsqrt_fast },
+    };
+    static const struct {
+        const char *name;
+        double (*fn)(double, double);
+    } binary[] = {
+        { "atan2", dit_atan2 }, { "atan2_fast", dit_atan2_fast },
+    };
+    int failed = 0;
+
+    for (int i = 0; i < BENCH_N; i++) bench_inputs[i] = rng_uniform(0.1, 2.1);
+
+    printf("  %-12s %9s %9s\n", "function", "cy/call", "limit");
+    for (uint32_t k = 0; k < sizeof(unary) / sizeof(unary[0]); k++) {
+        double cy = bench_unary(unary[k].fn);
+        int ok = cy < BENCH_UNARY_MAX_CYCLES;
+        printf("  %-12s %9.1f %9.0f%s\n", unary[k].name, cy, BENCH_UNARY_MAX_CYCLES,
+               ok ? "" : "  FAILED");
+        failed |= !ok;
+    }
+    for (uint32_t k = 0; k < sizeof(binary) / sizeof(binary[0]); k++) {
+        double cy = bench_atan2(binary[k].fn);
+        int ok = cy < BENCH_ATAN2_MAX_CYCLES;
+        printf("  %-12s %9.1f %9.0f%s\n", binary[k].name, cy, BENCH_ATAN2_MAX_CYCLES,
+               ok ? "" : "  FAILED");
+        failed |= !ok;
+    }
+
+    return failed ? 1 : 0;
+#else
+    printf("  rdtsc not available on this host: cycle budgets skipped\n");
+    return 0;
+#endif
+}
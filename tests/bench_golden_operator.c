@@ -0,0 +1,469 @@
+/*
+ * Benchmark - Golden Operator (punto fijo vs double)
+ * Smopsys Q-CORE
+ *
+ * Enlaza el kernel/golden_operator.c real y mide, sobre BENCH_STEPS
+ * pasos, el coste (ns/paso) y el error absoluto máximo y medio de cada
+ * camino que produce Ô_n frente a una referencia long double:
+ *
+ *   golden_operator_step            estado completo del latido
+ *   get_golden_operator_fixed       evaluación directa en BAM
+ *   golden_generator_fixed_next     recurrencia de rotación Q2.30
+ *   golden_operator_generate_fixed  lote de 4 vías
+ *   golden_generator_next           recurrencia en double
+ *   golden_operator_generate        lote de 4 vías en double
+ *   libm cos                        cos() de double directo
+ *
+ * La deriva se reporta por décadas de n: error máximo de Ô_n en
+ * (10^(k-1), 10^k] y |θ_step - θ_ref| en n = 10^k, con θ_ref la misma
+ * dinámica en double alimentada con la referencia.
+ *
+ * En x86 se comprueban además con rdtsc los presupuestos de ciclos del
+ * formato: get_golden_operator_fixed cuesta lo mismo en n = 2^30 que
+ * en n = 0 (≤ 2·pequeño + 10 y ≤ 100 ciclos), fp_mul ≤ 50, fp_div ≤ 1000
+ * y un golden_operator_step ≤ 500. Si alguno se supera, el benchmark
+ * sale con código 1.
+ *
+ * Compilar con: make bench FP_FORMAT=Q16_16
+ * Ejecutar con: ./bench_golden_operator_Q16_16 [salida.json]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "../include/dit_physics.h"
+#include "../include/dit_math_fixed.h"
+#include "../kernel/golden_operator.h"
+
+#define BENCH_STEPS    10000000u
+#define BENCH_DECADES  7            /* 10^1 .. 10^7 */
+#define BENCH_CHUNK    4096         /* Salidas por llamada a los lotes */
+
+enum {
+    PATH_STEP,
+    PATH_DIRECT,
+    PATH_GEN_FIXED,
+    PATH_BATCH_FIXED,
+    PATH_GEN_DOUBLE,
+    PATH_BATCH_DOUBLE,
+    PATH_LIBM,
+    PATH_COUNT
+};
+
+static const char *path_names[PATH_COUNT] = {
+    "golden_operator_step",
+    "get_golden_operator_fixed",
+    "golden_generator_fixed_next",
+    "golden_operator_generate_fixed",
+    "golden_generator_next",
+    "golden_operator_generate",
+    "libm_cos",
+};
+
+typedef struct {
+    double ns_per_step;
+    double max_err;
+    double sum_err;
+    double decade_max[BENCH_DECADES];
+} PathResult;
+
+static PathResult results[PATH_COUNT];
+static double theta_drift[BENCH_DECADES];
+
+/* Presupuestos de ciclos por llamada en el host (-O2) */
+#define BENCH_TRIG_MAX_CYCLES   100.0
+#define BENCH_MUL_MAX_CYCLES     50.0
+#define BENCH_DIV_MAX_CYCLES   1000.0
+#define BENCH_STEP_MAX_CYCLES   500.0
+
+enum {
+    CYCLES_TRIG_SMALL,      /* get_golden_operator_fixed desde n = 0 */
+    CYCLES_TRIG_LARGE,      /* ... desde n = 2^30 */
+    CYCLES_MUL,
+    CYCLES_DIV,
+    CYCLES_STEP,
+    CYCLES_COUNT
+};
+
+static const char *cycle_names[CYCLES_COUNT] = {
+    "golden_fixed_n0",
+    "golden_fixed_n2_30",
+    "fp_mul",
+    "fp_div",
+    "golden_operator_step",
+};
+
+static double cycles[CYCLES_COUNT];
+static double cycle_limit[CYCLES_COUNT];
+
+static fixed_t batch_fixed[BENCH_CHUNK];
+static double batch_double[BENCH_CHUNK];
+
+/* Evita que el compilador descarte los bucles cronometrados */
+static volatile double sink;
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Ô_n exacto: fase en vueltas reducida en long double (64 bits de mantisa) */
+static long double phi_conjugate_l;
+
+static double golden_reference(uint32_t n) {
+    long double turns = phi_conjugate_l * 0.5L * n;
+    turns -= floorl(turns);
+    long double c = cosl(2.0L * 3.14159265358979323846264338327950288L * turns + DIT_DELTA_DEFAULT);
+    return (double)((n & 1) ? -c : c);
+}
+
+static double libm_operator(uint32_t n) {
+    double parity = (n & 1) ? -1.0 : 1.0;
+    return parity * cos(M_PI * PHI_CONJUGATE * n + DIT_DELTA_DEFAULT);
+}
+
+/* Década k (0-based) de n: n en (10^k, 10^(k+1)] */
+static int decade_of(uint32_t n) {
+    int k = 0;
+    uint32_t limit = 10;
+    while (n > limit && k < BENCH_DECADES - 1) {
+        limit *= 10;
+        k++;
+    }
+    return k;
+}
+
+static void record(int path, uint32_t n, double got, double ref) {
+    double e = fabs(got - ref);
+    PathResult *r = &results[path];
+    if (e > r->max_err) r->max_err = e;
+    r->sum_err += e;
+    int k = decade_of(n);
+    if (e > r->decade_max[k]) r->decade_max[k] = e;
+}
+
+/* ============================================================
+ * COSTE
+ * ============================================================ */
+
+static void time_paths(void) {
+    const fixed_t delta = (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE);
+    double t0, acc;
+
+    GoldenState state;
+    golden_operator_init(&state);
+    t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_STEPS; i++) golden_operator_step(&state);
+    results[PATH_STEP].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = (double)state.theta;
+
+    fixed_t facc = 0;
+    t0 = now_ns();
+    for (uint32_t n = 1; n <= BENCH_STEPS; n++) facc += get_golden_operator_fixed((int)n, delta);
+    results[PATH_DIRECT].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = (double)facc;
+
+    GoldenGeneratorFixed gf;
+    golden_generator_fixed_init(&gf, 1, delta);
+    facc = 0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_STEPS; i++) facc += golden_generator_fixed_next(&gf);
+    results[PATH_GEN_FIXED].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = (double)facc;
+
+    facc = 0;
+    t0 = now_ns();
+    for (uint32_t n = 1; n <= BENCH_STEPS; n += BENCH_CHUNK) {
+        golden_operator_generate_fixed(n, BENCH_CHUNK, batch_fixed);
+        facc += batch_fixed[BENCH_CHUNK - 1];
+    }
+    results[PATH_BATCH_FIXED].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = (double)facc;
+
+    GoldenGenerator gd;
+    golden_generator_init(&gd, 1, DIT_DELTA_DEFAULT);
+    acc = 0.0;
+    t0 = now_ns();
+    for (uint32_t i = 0; i < BENCH_STEPS; i++) acc += golden_generator_next(&gd);
+    results[PATH_GEN_DOUBLE].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = acc;
+
+    acc = 0.0;
+    t0 = now_ns();
+    for (uint32_t n = 1; n <= BENCH_STEPS; n += BENCH_CHUNK) {
+        golden_operator_generate(n, BENCH_CHUNK, batch_double);
+        acc += batch_double[BENCH_CHUNK - 1];
+    }
+    results[PATH_BATCH_DOUBLE].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = acc;
+
+    acc = 0.0;
+    t0 = now_ns();
+    for (uint32_t n = 1; n <= BENCH_STEPS; n++) acc += libm_operator(n);
+    results[PATH_LIBM].ns_per_step = (now_ns() - t0) / BENCH_STEPS;
+    sink = acc;
+}
+
+/* ============================================================
+ * PRESUPUESTOS DE CICLOS
+ * ============================================================ */
+
+#if defined(__i386__) || defined(__x86_64__)
+#define CYCLE_N     1024
+#define CYCLE_REPS  200
+
+static fixed_t cycle_a[CYCLE_N];
+static fixed_t cycle_b[CYCLE_N];
+
+static inline uint64_t read_tsc(void) {
+    uint32_t lo, hi;
+    __asm__ __volatile__("lfence; rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+/* xorshift64: operandos reproducibles */
+static uint64_t rng_state = 88172645463325252ULL;
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/*
+ * Coste independiente de la magnitud de la fase: antes, n = 2^30
+ * recorría miles de iteraciones de reducción de rango. Mínimo de
+ * ciclos por llamada sobre CYCLE_REPS rondas de 256 llamadas.
+ */
+static double golden_cycles_per_call(int n0) {
+    fixed_t facc = 0;
+    uint64_t best = ~0ULL;
+    for (int round = 0; round < CYCLE_REPS; round++) {
+        uint64_t t0 = read_tsc();
+        for (int k = 0; k < 256; k++) facc += get_golden_operator_fixed(n0 + k, 0);
+        uint64_t t1 = read_tsc();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    sink = (double)facc;
+    return (double)best / 256.0;
+}
+
+static double op_cycles_per_call(fixed_t (*op)(fixed_t, fixed_t)) {
+    fixed_t facc = 0;
+    uint64_t best = ~0ULL;
+    for (int round = 0; round < CYCLE_REPS; round++) {
+        uint64_t t0 = read_tsc();
+        for (int i = 0; i < CYCLE_N; i++) facc ^= op(cycle_a[i], cycle_b[i]);
+        uint64_t t1 = read_tsc();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    sink = (double)facc;
+    return (double)best / CYCLE_N;
+}
+
+static fixed_t op_mul(fixed_t a, fixed_t b) { return fp_mul(a, b); }
+static fixed_t op_div(fixed_t a, fixed_t b) { return fp_div(a, b); }
+
+static double step_cycles_per_call(void) {
+    GoldenState state;
+    golden_operator_init(&state);
+    uint64_t best = ~0ULL;
+    for (int round = 0; round < CYCLE_REPS; round++) {
+        uint64_t t0 = read_tsc();
+        for (int i = 0; i < CYCLE_N; i++) golden_operator_step(&state);
+        uint64_t t1 = read_tsc();
+        if (t1 - t0 < best) best = t1 - t0;
+    }
+    sink = (double)state.theta;
+    return (double)best / CYCLE_N;
+}
+
+/* Retorna 1 si todo cabe en su presupuesto */
+static int time_cycle_budgets(void) {
+    /* a en ±10, b en (0.001, 2): sin saturar en ningún formato */
+    for (int i = 0; i < CYCLE_N; i++) {
+        cycle_a[i] = FP_FROM_DOUBLE(((double)(rng_next() % 2000000) - 1000000.0) * 1e-5);
+        cycle_b[i] = FP_FROM_DOUBLE(((double)(rng_next() % 2000000) + 1000.0) * 1e-6);
+    }
+
+    cycles[CYCLES_TRIG_SMALL] = golden_cycles_per_call(0);
+    cycles[CYCLES_TRIG_LARGE] = golden_cycles_per_call(1 << 30);
+    cycles[CYCLES_MUL] = op_cycles_per_call(op_mul);
+    cycles[CYCLES_DIV] = op_cycles_per_call(op_div);
+    cycles[CYCLES_STEP] = step_cycles_per_call();
+
+    cycle_limit[CYCLES_TRIG_SMALL] = BENCH_TRIG_MAX_CYCLES;
+    cycle_limit[CYCLES_TRIG_LARGE] = 2.0 * cycles[CYCLES_TRIG_SMALL] + 10.0;
+    if (cycle_limit[CYCLES_TRIG_LARGE] > BENCH_TRIG_MAX_CYCLES) {
+        cycle_limit[CYCLES_TRIG_LARGE] = BENCH_TRIG_MAX_CYCLES;
+    }
+    cycle_limit[CYCLES_MUL] = BENCH_MUL_MAX_CYCLES;
+    cycle_limit[CYCLES_DIV] = BENCH_DIV_MAX_CYCLES;
+    cycle_limit[CYCLES_STEP] = BENCH_STEP_MAX_CYCLES;
+
+    int ok = 1;
+    for (int c = 0; c < CYCLES_COUNT; c++) ok &= cycles[c] < cycle_limit[c];
+    return ok;
+}
+#else
+static int time_cycle_budgets(void) {
+    return 1;
+}
+#endif
+
+/* ============================================================
+ * PRECISIÓN Y DERIVA
+ * ============================================================ */
+
+static void measure_accuracy(void) {
+    const fixed_t delta = (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE);
+    const double two_pi = 2.0 * M_PI;
+    const double relaxation = 1.0 / 50.0;   /* GOLDEN_RELAXATION_FP */
+
+    GoldenState state;
+    GoldenGeneratorFixed gf;
+    GoldenGenerator gd;
+    golden_operator_init(&state);
+    golden_generator_fixed_init(&gf, 1, delta);
+    golden_generator_init(&gd, 1, DIT_DELTA_DEFAULT);
+
+    double theta_ref = fp_to_double(state.theta);
+    uint32_t next_decade = 10;
+    int decade = 0;
+
+    for (uint32_t n = 1; n <= BENCH_STEPS; n++) {
+        uint32_t lane = (n - 1) % BENCH_CHUNK;
+        if (lane == 0) {
+            uint32_t count = BENCH_STEPS - n + 1;
+            if (count > BENCH_CHUNK) count = BENCH_CHUNK;
+            golden_operator_generate_fixed(n, count, batch_fixed);
+            golden_operator_generate(n, count, batch_double);
+        }
+
+        double ref = golden_reference(n);
+        golden_operator_step(&state);
+
+        record(PATH_STEP, n, fp_to_double(state.O_n), ref);
+        record(PATH_DIRECT, n, fp_to_double(get_golden_operator_fixed((int)n, delta)), ref);
+        record(PATH_GEN_FIXED, n, fp_to_double(golden_generator_fixed_next(&gf)), ref);
+        record(PATH_BATCH_FIXED, n, fp_to_double(batch_fixed[lane]), ref);
+        record(PATH_GEN_DOUBLE, n, golden_generator_next(&gd), ref);
+        record(PATH_BATCH_DOUBLE, n, batch_double[lane], ref);
+        record(PATH_LIBM, n, libm_operator(n), ref);
+
+        /* Misma dinámica que golden_operator_step, en double y con Ô_n exacto */
+        theta_ref += ref / 16.0 + 0.1 * (M_PI - theta_ref) * relaxation;
+        while (theta_ref < 0.0) theta_ref += two_pi;
+        while (theta_ref > two_pi) theta_ref -= two_pi;
+
+        if (n == next_decade) {
+            theta_drift[decade++] = fabs(fp_to_double(state.theta) - theta_ref);
+            next_decade *= 10;
+        }
+    }
+}
+
+/* ============================================================
+ * SALIDA
+ * ============================================================ */
+
+static void print_cycle_budgets(void) {
+#if defined(__i386__) || defined(__x86_64__)
+    printf("\n  %-32s %9s %9s\n", "cycle budget", "cy/call", "limit");
+    for (int c = 0; c < CYCLES_COUNT; c++) {
+        printf("  %-32s %9.1f %9.1f%s\n", cycle_names[c], cycles[c], cycle_limit[c],
+               cycles[c] < cycle_limit[c] ? "" : "  FAILED");
+    }
+#else
+    printf("\n  rdtsc not available on this host: cycle budgets skipped\n");
+#endif
+}
+
+static void print_table(void) {
+    printf("  %-32s %9s %12s %12s\n", "path", "ns/step", "max |err|", "mean |err|");
+    for (int p = 0; p < PATH_COUNT; p++) {
+        printf("  %-32s %9.2f %12.3e %12.3e\n", path_names[p], results[p].ns_per_step,
+               results[p].max_err, results[p].sum_err / BENCH_STEPS);
+    }
+
+    printf("\n  Drift (max |err| of O_n per decade, |theta - theta_ref| at n):\n");
+    printf("  %10s %12s %12s %12s\n", "n", "step", "generator", "theta");
+    uint32_t n = 10;
+    for (int k = 0; k < BENCH_DECADES; k++, n *= 10) {
+        printf("  %10u %12.3e %12.3e %12.3e\n", n, results[PATH_STEP].decade_max[k],
+               results[PATH_GEN_FIXED].decade_max[k], theta_drift[k]);
+    }
+}
+
+static void write_json(FILE *f) {
+    fprintf(f, "{\n");
+    fprintf(f, "  \"format\": \"%s\",\n", DIT_FP_NAME);
+    fprintf(f, "  \"steps\": %u,\n", BENCH_STEPS);
+    fprintf(f, "  \"lsb\": %.6e,\n", 1.0 / (double)FP_ONE);
+    fprintf(f, "  \"cycles\": {");
+    for (int c = 0; c < CYCLES_COUNT; c++) {
+        fprintf(f, "%s\"%s\": %.2f", c ? ", " : "", cycle_names[c], cycles[c]);
+    }
+    fprintf(f, "},\n");
+    fprintf(f, "  \"paths\": [\n");
+    for (int p = 0; p < PATH_COUNT; p++) {
+        const PathResult *r = &results[p];
+        fprintf(f, "    {\"name\": \"%s\", \"ns_per_step\": %.4f, \"max_abs_err\": %.6e, "
+                   "\"mean_abs_err\": %.6e, \"drift\": [",
+                path_names[p], r->ns_per_step, r->max_err, r->sum_err / BENCH_STEPS);
+        uint32_t n = 10;
+        for (int k = 0; k < BENCH_DECADES; k++, n *= 10) {
+            fprintf(f, "%s{\"n\": %u, \"max_abs_err\": %.6e}", k ? ", " : "", n, r->decade_max[k]);
+        }
+        fprintf(f, "]}%s\n", p + 1 < PATH_COUNT ? "," : "");
+    }
+    fprintf(f, "  ],\n");
+    fprintf(f, "  \"theta_drift\": [");
+    uint32_t n = 10;
+    for (int k = 0; k < BENCH_DECADES; k++, n *= 10) {
+        fprintf(f, "%s{\"n\": %u, \"abs_err\": %.6e}", k ? ", " : "", n, theta_drift[k]);
+    }
+    fprintf(f, "]\n}\n");
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(int argc, char **argv) {
+    phi_conjugate_l = (sqrtl(5.0L) - 1.0L) / 2.0L;
+
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: Golden Operator Benchmark\n");
+    printf(" Format %s, %u steps\n", DIT_FP_NAME, BENCH_STEPS);
+    printf("============================================\n\n");
+
+    time_paths();
+    int cycles_ok = time_cycle_budgets();
+    measure_accuracy();
+    print_table();
+    print_cycle_budgets();
+
+    if (argc > 1) {
+        FILE *f = fopen(argv[1], "w");
+        if (!f) {
+            perror(argv[1]);
+            return 1;
+        }
+        write_json(f);
+        fclose(f);
+        printf("\n  Wrote %s\n", argv[1]);
+    }
+
+    return cycles_ok ? 0 : 1;
+}
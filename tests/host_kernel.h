@@ -0,0 +1,42 @@
+/*
+ * Entorno del kernel para los tests del host - Smopsys Q-CORE
+ *
+ * Se inyecta con -include al compilar código del kernel para el host:
+ *
+ * - sched_irq_save/restore usan pushfl; cli, que no existe en x86-64 y
+ *   fallaría en modo usuario. La guarda SCHED_H queda definida, así que
+ *   kernel/sched.h no se lee, y las secciones críticas quedan vacías
+ *   (los tests corren en un solo hilo, sin latido).
+ * - El mapa E820 de stage2 está en 0x5000, por debajo del mínimo de
+ *   mmap de muchos hosts: el gestor lo lee de host_e820_map, que
+ *   define el test (a cero: sin magic, megabyte por defecto).
+ */
+
+#ifndef HOST_KERNEL_H
+#define HOST_KERNEL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern uint8_t host_e820_map[];
+
+#ifdef __cplusplus
+}
+#endif
+
+#define E820_MAP_ADDR ((uintptr_t)host_e820_map)
+
+#define SCHED_H
+
+static inline uint32_t sched_irq_save(void) {
+    return 0;
+}
+
+static inline void sched_irq_restore(uint32_t flags) {
+    (void)flags;
+}
+
+#endif /* HOST_KERNEL_H */
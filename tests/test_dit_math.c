@@ -0,0 +1,393 @@
+/*
+ * Test Suite - DIT Math
+ * Smopsys Q-CORE
+ *
+ * Compara la biblioteca freestanding dit_math con libm del host y
+ * verifica las cotas de precisión documentadas en include/dit_math.h.
+ * Los ciclos por llamada se miden en make bench (bench_dit_math.c).
+ *
+ * Compilar con: gcc test_dit_math.c ../kernel/dit_math.c -lm -o test_dit_math
+ * Ejecutar con: ./test_dit_math
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../include/dit_math.h"
+
+/* ============================================================
+ * FRAMEWORK DE TESTS SIMPLE
+ * ============================================================ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+} while(0)
+
+#define ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n", msg); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define ASSERT_MAX(err, bound, msg) do { \
+    if (!((err) <= (bound))) { \
+        printf("FAILED\n    %s: max error %g exceeds %g\n", msg, (double)(err), (double)(bound)); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define PASS() do { \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+#define SWEEP_SAMPLES 200000
+
+/* xorshift64: barridos reproducibles */
+static uint64_t rng_state;
+
+static void rng_seed(void) {
+    rng_state = 88172645463325252ULL;
+}
+
+static double rng_uniform(double lo, double hi) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return lo + (hi - lo) * ((rng_state >> 11) * (1.0 / 9007199254740992.0));
+}
+
+/* Log-uniforme en [lo, hi], lo > 0 */
+static double rng_log_uniform(double lo, double hi) {
+    return exp(rng_uniform(log(lo), log(hi)));
+}
+
+static double ulp_error(double got, double ref) {
+    if (got == ref) return 0.0;
+    double ulp = nextafter(fabs(ref), INFINITY) - fabs(ref);
+    return fabs(got - ref) / ulp;
+}
+
+static double ulp_error_f(float got, double ref) {
+    float r = (float)ref;
+    float ulp = nextafterf(fabsf(r), INFINITY) - fabsf(r);
+    return fabs((double)got - ref) / ulp;
+}
+
+static double rel_error(double got, double ref) {
+    return fabs(got - ref) / fabs(ref);
+}
+
+static double q16_to_double(q16_t x) {
+    return (double)x / Q16_ONE;
+}
+
+/* Error en LSB de Q16.16 */
+static double lsb_error(q16_t got, double ref) {
+    return fabs(q16_to_double(got) - ref) * Q16_ONE;
+}
+
+/* ============================================================
+ * TESTS: DOUBLE, NIVEL ACCURATE
+ * ============================================================ */
+
+TEST(test_sin_cos_accurate) {
+    double max_ulp = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double x = rng_uniform(-100.0, 100.0);
+        double e = ulp_error(dit_sin(x), sin(x));
+        if (e > max_ulp) max_ulp = e;
+        e = ulp_error(dit_cos(x), cos(x));
+        if (e > max_ulp) max_ulp = e;
+    }
+    ASSERT_MAX(max_ulp, 1.0, "sin/cos |x| < 100");
+
+    max_ulp = 0.0;
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double x = rng_uniform(-1e6, 1e6);
+        double e = ulp_error(dit_sin(x), sin(x));
+        if (e > max_ulp) max_ulp = e;
+    }
+    ASSERT_MAX(max_ulp, 2.0, "sin |x| < 1e6");
+    PASS();
+}
+
+TEST(test_exp_accurate) {
+    double max_ulp = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double x = rng_uniform(-708.0, 709.0);
+        double e = ulp_error(dit_exp(x), exp(x));
+        if (e > max_ulp) max_ulp = e;
+    }
+    ASSERT_MAX(max_ulp, 1.0, "exp");
+
+    /* Resultados subnormales: el escalado no debe perder el exponente */
+    for (int i = 0; i < 1000; i++) {
+        double x = rng_uniform(-744.0, -709.0);
+        ASSERT(rel_error(dit_exp(x), exp(x)) < 1e-4, "exp should reach the subnormal range");
+    }
+    PASS();
+}
+
+TEST(test_log_accurate) {
+    double max_ulp = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double x = rng_log_uniform(1e-300, 1e300);
+        double e = ulp_error(dit_log(x), log(x));
+        if (e > max_ulp) max_ulp = e;
+        x = rng_uniform(0.5, 2.0);
+        e = ulp_error(dit_log(x), log(x));
+        if (e > max_ulp) max_ulp = e;
+    }
+    ASSERT_MAX(max_ulp, 2.0, "log");
+    PASS();
+}
+
+TEST(test_sqrt_rsqrt_accurate) {
+    double max_sqrt = 0.0;
+    double max_rsqrt = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double x = rng_log_uniform(1e-300, 1e300);
+        double e = ulp_error(dit_sqrt(x), sqrt(x));
+        if (e > max_sqrt) max_sqrt = e;
+        e = ulp_error(dit_rsqrt(x), 1.0 / sqrt(x));
+        if (e > max_rsqrt) max_rsqrt = e;
+        x = rng_log_uniform(1e-320, 2e-308);
+        e = ulp_error(dit_sqrt(x), sqrt(x));
+        if (e > max_sqrt) max_sqrt = e;
+    }
+    ASSERT_MAX(max_sqrt, 1.0, "sqrt (normal and subnormal)");
+    ASSERT_MAX(max_rsqrt, 3.0, "rsqrt");
+    PASS();
+}
+
+TEST(test_atan2_accurate) {
+    double max_ulp = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double a = rng_uniform(-M_PI, M_PI);
+        double r = rng_log_uniform(1e-8, 1e8);
+        double y = r * sin(a);
+        double x = r * cos(a);
+        double e = ulp_error(dit_atan2(y, x), atan2(y, x));
+        if (e > max_ulp) max_ulp = e;
+    }
+    ASSERT_MAX(max_ulp, 4.0, "atan2");
+    PASS();
+}
+
+TEST(test_special_values) {
+    double inf = INFINITY;
+
+    ASSERT(isnan(dit_sin(inf)) && isnan(dit_cos(NAN)), "sin/cos of inf/NaN should be NaN");
+    ASSERT(dit_exp(inf) == inf && dit_exp(-inf) == 0.0 && dit_exp(0.0) == 1.0, "exp specials");
+    ASSERT(dit_exp(710.0) == inf, "exp should overflow to inf");
+    ASSERT(dit_log(0.0) == -inf && isnan(dit_log(-1.0)) && dit_log(1.0) == 0.0, "log specials");
+    ASSERT(dit_log(inf) == inf, "log(inf) should be inf");
+    ASSERT(dit_sqrt(0.0) == 0.0 && isnan(dit_sqrt(-1.0)) && dit_sqrt(inf) == inf, "sqrt specials");
+    ASSERT(dit_rsqrt(0.0) == inf && dit_rsqrt(inf) == 0.0, "rsqrt specials");
+    ASSERT(dit_atan2(0.0, -1.0) == atan2(0.0, -1.0), "atan2(0, -1) should be pi");
+    ASSERT(dit_atan2(-0.0, -1.0) == atan2(-0.0, -1.0), "atan2(-0, -1) should be -pi");
+    ASSERT(dit_atan2(1.0, 0.0) == atan2(1.0, 0.0), "atan2(1, 0) should be pi/2");
+    ASSERT(dit_atan2(0.0, 0.0) == 0.0, "atan2(0, 0) should be 0");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: DOUBLE, NIVEL FAST
+ * ============================================================ */
+
+TEST(test_fast_tier) {
+    double sin_abs = 0.0, exp_rel = 0.0, log_rel = 0.0;
+    double sqrt_rel = 0.0, rsqrt_rel = 0.0, atan2_abs = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double x = rng_uniform(-100.0, 100.0);
+        double e = fabs(dit_sin_fast(x) - sin(x));
+        if (e > sin_abs) sin_abs = e;
+        e = fabs(dit_cos_fast(x) - cos(x));
+        if (e > sin_abs) sin_abs = e;
+
+        x = rng_uniform(-708.0, 709.0);
+        e = rel_error(dit_exp_fast(x), exp(x));
+        if (e > exp_rel) exp_rel = e;
+
+        x = rng_log_uniform(1e-300, 1e300);
+        e = rel_error(dit_log_fast(x), log(x));
+        if (e > log_rel) log_rel = e;
+        e = rel_error(dit_sqrt_fast(x), sqrt(x));
+        if (e > sqrt_rel) sqrt_rel = e;
+        e = rel_error(dit_rsqrt_fast(x), 1.0 / sqrt(x));
+        if (e > rsqrt_rel) rsqrt_rel = e;
+
+        double a = rng_uniform(-M_PI, M_PI);
+        e = fabs(dit_atan2_fast(sin(a), cos(a)) - atan2(sin(a), cos(a)));
+        if (e > atan2_abs) atan2_abs = e;
+    }
+    ASSERT_MAX(sin_abs, 2e-9, "fast sin/cos");
+    ASSERT_MAX(exp_rel, 3e-10, "fast exp");
+    ASSERT_MAX(log_rel, 1e-10, "fast log");
+    ASSERT_MAX(sqrt_rel, 4e-11, "fast sqrt");
+    ASSERT_MAX(rsqrt_rel, 4e-11, "fast rsqrt");
+    ASSERT_MAX(atan2_abs, 1e-10, "fast atan2");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: FLOAT
+ * ============================================================ */
+
+TEST(test_float_variants) {
+    double max_ulp = 0.0;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        float x = (float)rng_uniform(-100.0, 100.0);
+        double e = ulp_error_f(dit_sinf(x), sin((double)x));
+        if (e > max_ulp) max_ulp = e;
+        e = ulp_error_f(dit_cosf(x), cos((double)x));
+        if (e > max_ulp) max_ulp = e;
+
+        float xe = (float)rng_uniform(-85.0, 85.0);
+        e = ulp_error_f(dit_expf(xe), exp((double)xe));
+        if (e > max_ulp) max_ulp = e;
+
+        float xl = (float)rng_log_uniform(1e-30, 1e30);
+        e = ulp_error_f(dit_logf(xl), log((double)xl));
+        if (e > max_ulp) max_ulp = e;
+        e = ulp_error_f(dit_sqrtf(xl), sqrt((double)xl));
+        if (e > max_ulp) max_ulp = e;
+        e = ulp_error_f(dit_rsqrtf(xl), 1.0 / sqrt((double)xl));
+        if (e > max_ulp) max_ulp = e;
+
+        float y = (float)rng_uniform(-1.0, 1.0);
+        float xx = (float)rng_uniform(-1.0, 1.0);
+        e = ulp_error_f(dit_atan2f(y, xx), atan2((double)y, (double)xx));
+        if (e > max_ulp) max_ulp = e;
+    }
+    ASSERT_MAX(max_ulp, 1.0, "float variants");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: Q16.16
+ * ============================================================ */
+
+TEST(test_q16_exp_log) {
+    double exp_err = 0.0, log_err = 0.0;
+
+    for (q16_t x = -12 * Q16_ONE; x < 681391; x += 3) {
+        double ref = exp(q16_to_double(x));
+        /* Cota: 1 LSB + 2^-15 relativo */
+        double e = lsb_error(dit_exp_q16(x), ref) / (1.0 + ref * Q16_ONE / 32768.0);
+        if (e > exp_err) exp_err = e;
+    }
+    ASSERT_MAX(exp_err, 1.0, "Q16 exp (in units of 1 LSB + 2^-15 rel)");
+    ASSERT(dit_exp_q16(12 * Q16_ONE) == INT32_MAX, "Q16 exp should saturate");
+
+    for (int64_t x = 1; x < INT32_MAX; x += 1 + x / 4096) {
+        double e = lsb_error(dit_log_q16((q16_t)x), log(q16_to_double((q16_t)x)));
+        if (e > log_err) log_err = e;
+    }
+    ASSERT_MAX(log_err, 2.0, "Q16 log");
+    ASSERT(dit_log_q16(0) == INT32_MIN, "Q16 log(0) should be INT32_MIN");
+    PASS();
+}
+
+TEST(test_q16_sqrt_rsqrt) {
+    double sqrt_err = 0.0, rsqrt_err = 0.0;
+
+    for (int64_t x = 1; x < INT32_MAX; x += 1 + x / 4096) {
+        double X = q16_to_double((q16_t)x);
+        double e = lsb_error(dit_sqrt_q16((q16_t)x), sqrt(X));
+        if (e > sqrt_err) sqrt_err = e;
+
+        double ref = 1.0 / sqrt(X);
+        if (ref < 32767.0) {
+            e = lsb_error(dit_rsqrt_q16((q16_t)x), ref) / (1.0 + ref * Q16_ONE / 32768.0);
+            if (e > rsqrt_err) rsqrt_err = e;
+        }
+    }
+    ASSERT_MAX(sqrt_err, 0.5, "Q16 sqrt");
+    ASSERT_MAX(rsqrt_err, 1.0, "Q16 rsqrt (in units of 1 LSB + 2^-15 rel)");
+    PASS();
+}
+
+TEST(test_q16_trig) {
+    double sin_err = 0.0, atan2_err = 0.0;
+
+    for (q16_t x = -40 * Q16_ONE; x < 40 * Q16_ONE; x += 7) {
+        double e = lsb_error(dit_sin_q16(x), sin(q16_to_double(x)));
+        if (e > sin_err) sin_err = e;
+        e = lsb_error(dit_cos_q16(x), cos(q16_to_double(x)));
+        if (e > sin_err) sin_err = e;
+    }
+    ASSERT_MAX(sin_err, 1.0, "Q16 sin/cos");
+
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        double a = rng_uniform(-M_PI, M_PI);
+        double r = rng_log_uniform(4.0, 30000.0);
+        q16_t y = (q16_t)(r * sin(a) * Q16_ONE);
+        q16_t x = (q16_t)(r * cos(a) * Q16_ONE);
+        double e = lsb_error(dit_atan2_q16(y, x), atan2((double)y, (double)x));
+        if (e > atan2_err) atan2_err = e;
+    }
+    ASSERT_MAX(atan2_err, 1.0, "Q16 atan2");
+    PASS();
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void) {
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: DIT Math Tests\n");
+    printf("============================================\n\n");
+
+    printf("Double, Accurate Tier:\n");
+    RUN_TEST(test_sin_cos_accurate);
+    RUN_TEST(test_exp_accurate);
+    RUN_TEST(test_log_accurate);
+    RUN_TEST(test_sqrt_rsqrt_accurate);
+    RUN_TEST(test_atan2_accurate);
+    RUN_TEST(test_special_values);
+
+    printf("\nDouble, Fast Tier:\n");
+    RUN_TEST(test_fast_tier);
+
+    printf("\nFloat:\n");
+    RUN_TEST(test_float_variants);
+
+    printf("\nQ16.16:\n");
+    RUN_TEST(test_q16_exp_log);
+    RUN_TEST(test_q16_sqrt_rsqrt);
+    RUN_TEST(test_q16_trig);
+
+    printf("\n============================================\n");
+    printf(" Results: %d/%d passed, %d failed\n", tests_passed, tests_run, tests_failed);
+    printf("============================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,280 @@
+/*
+ * Test Suite - Fixed-Point Formats
+ * Smopsys Q-CORE
+ *
+ * Precisión del formato de punto fijo elegido en la compilación
+ * (DIT_FP_FORMAT). El Makefile construye este test una vez por formato:
+ * Q16.16, Q8.24 y Q32.32. Los ciclos de fp_mul, fp_div y del latido se
+ * miden en make bench FP_FORMAT=... (bench_golden_operator.c).
+ *
+ * Compilar con: gcc -O2 -DDIT_FP_FORMAT=DIT_FP_Q32_32 test_fixed_format.c \
+ *               ../kernel/golden_operator.c ../kernel/dit_math.c -lm
+ * Ejecutar con: ./test_fixed_format_Q32_32
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../include/dit_physics.h"
+#include "../include/dit_math_fixed.h"
+#include "../kernel/golden_operator.h"
+
+/* ============================================================
+ * FRAMEWORK DE TESTS SIMPLE
+ * ============================================================ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+} while(0)
+
+#define ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n", msg); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define ASSERT_FLOAT_EQ(a, b, eps, msg) do { \
+    if (fabs((a) - (b)) > (eps)) { \
+        printf("FAILED\n    %s: expected %f, got %f\n", msg, (b), (a)); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define PASS() do { \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+#define SWEEP_SAMPLES 200000
+
+/* Referencia exacta en el host: enteros de 128 bits */
+typedef __int128 wide_t;
+
+static const double LSB = 1.0 / (double)FP_ONE;
+
+static uint64_t rng_state;
+
+static void rng_seed(void) {
+    rng_state = 88172645463325252ULL;
+}
+
+static uint64_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* fixed_t aleatorio con magnitud log-uniforme hasta 2^max_bits */
+static fixed_t rng_fixed(int max_bits) {
+    int bits = 1 + (int)(rng_next() % (uint64_t)max_bits);
+    uint64_t mag = rng_next() & ((bits >= 64) ? ~0ULL : ((1ULL << bits) - 1));
+    fixed_t x = (fixed_t)(mag >> 1);
+    return (rng_next() & 1) ? -x : x;
+}
+
+static fixed_t wide_saturate(wide_t x) {
+    if (x > (wide_t)FP_MAX) return FP_MAX;
+    if (x < (wide_t)FP_MIN) return FP_MIN;
+    return (fixed_t)x;
+}
+
+/* ⌊a·b / 2^FP_SHIFT⌋ saturado */
+static fixed_t ref_mul(fixed_t a, fixed_t b) {
+    return wide_saturate(((wide_t)a * b) >> FP_SHIFT);
+}
+
+/* trunc(a·2^FP_SHIFT / b) saturado */
+static fixed_t ref_div(fixed_t a, fixed_t b) {
+    if (b == 0) return (a < 0) ? FP_MIN : FP_MAX;
+    return wide_saturate(((wide_t)a << FP_SHIFT) / b);
+}
+
+/* ============================================================
+ * TESTS: ARITMÉTICA
+ * ============================================================ */
+
+TEST(test_format_constants) {
+    ASSERT(FP_ONE == ((fixed_t)1 << FP_SHIFT), "FP_ONE should be 2^FP_SHIFT");
+    ASSERT(sizeof(fixed_t) * 8 == (FP_SHIFT == 32 ? 64 : 32), "fixed_t width should match the format");
+    ASSERT_FLOAT_EQ(fp_to_double(PI_FP), M_PI, LSB, "PI_FP should be pi to 1 LSB");
+    ASSERT_FLOAT_EQ(fp_to_double(PHI_FP), PHI, LSB, "PHI_FP should be phi to 1 LSB");
+    ASSERT_FLOAT_EQ(fp_to_double(PHI_CONJUGATE_FP), PHI_CONJUGATE, LSB, "PHI_CONJUGATE_FP to 1 LSB");
+    ASSERT(fp_to_double(FP_FROM_DOUBLE(-0.25)) == -0.25, "FP_FROM_DOUBLE should handle negatives");
+    PASS();
+}
+
+TEST(test_fp_mul_exact) {
+    int bits = (int)sizeof(fixed_t) * 8;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        fixed_t a = rng_fixed(bits);
+        fixed_t b = rng_fixed(bits);
+        ASSERT(fp_mul(a, b) == ref_mul(a, b), "fp_mul should match the 128-bit reference bit for bit");
+    }
+    PASS();
+}
+
+TEST(test_fp_mul_saturates) {
+    ASSERT(fp_mul(FP_MAX, 2 * FP_ONE) == FP_MAX, "Positive overflow should saturate to FP_MAX");
+    ASSERT(fp_mul(FP_MIN, 2 * FP_ONE) == FP_MIN, "Negative overflow should saturate to FP_MIN");
+    ASSERT(fp_mul(FP_MAX, -FP_MAX) == FP_MIN, "Mixed-sign overflow should saturate to FP_MIN");
+    ASSERT(fp_mul(FP_MIN, FP_MIN) == FP_MAX, "FP_MIN squared should saturate to FP_MAX");
+    ASSERT(fp_mul(FP_MAX, FP_ONE) == FP_MAX, "Multiplying by one should be exact at the edge");
+    PASS();
+}
+
+TEST(test_fp_div_exact) {
+    int bits = (int)sizeof(fixed_t) * 8;
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        fixed_t a = rng_fixed(bits);
+        fixed_t b = rng_fixed(bits);
+        ASSERT(fp_div(a, b) == ref_div(a, b), "fp_div should match the 128-bit reference bit for bit");
+    }
+    ASSERT(fp_div(FP_ONE, 0) == FP_MAX && fp_div(-FP_ONE, 0) == FP_MIN, "Division by zero should saturate");
+    ASSERT(fp_div(FP_MAX, FP_ONE / 2) == FP_MAX, "Quotient overflow should saturate");
+    ASSERT(fp_div(FP_MIN, FP_ONE / 2) == FP_MIN, "Negative quotient overflow should saturate");
+    PASS();
+}
+
+TEST(test_angle_conversion) {
+    rng_seed();
+    for (int i = 0; i < SWEEP_SAMPLES; i++) {
+        fixed_t x = rng_fixed((int)sizeof(fixed_t) * 8);
+        dit_angle_t ref = (dit_angle_t)(((wide_t)x * DIT_RAD_TO_ANGLE) >> FP_SHIFT);
+        ASSERT(dit_angle_from_fixed(x) == ref, "dit_angle_from_fixed should wrap exactly");
+
+        dit_angle_t a = (dit_angle_t)rng_next();
+        double rad = a * (2.0 * M_PI / 4294967296.0);
+        ASSERT_FLOAT_EQ(fp_to_double(dit_fixed_from_angle(a)), rad, LSB + 1e-9,
+                        "dit_fixed_from_angle should be within 1 LSB");
+    }
+    PASS();
+}
+
+TEST(test_trig_precision) {
+    /* El límite de la tabla (5e-6) domina en los formatos anchos */
+    double bound = (FP_SHIFT == 16) ? 1.0 / (2 * FP_ONE) + 5e-6 : 5e-6;
+    double max_err = 0.0;
+    for (int i = 0; i < 100000; i++) {
+        double x = -50.0 + i * 1e-3;
+        fixed_t fx = FP_FROM_DOUBLE(x);
+        double xr = fp_to_double(fx);
+        double e = fabs(fp_to_double(dit_sin_fixed(fx)) - sin(xr));
+        if (e > max_err) max_err = e;
+        e = fabs(fp_to_double(dit_cos_fixed(fx)) - cos(xr));
+        if (e > max_err) max_err = e;
+    }
+    ASSERT(max_err <= bound, "sin/cos should stay within the table bound");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: TRAYECTORIA ÁUREA
+ * ============================================================ */
+
+TEST(test_golden_lagrangian_no_overflow) {
+    GoldenState state;
+    golden_operator_init(&state);
+
+    /* |θ̇| = 1 y θ = 0: L_symp = ½ - 1, L_metr = ½·η·π² */
+    state.O_n = -FP_ONE;
+    state.theta = 0;
+    fixed_t L_symp, L_metr;
+    golden_operator_compute_lagrangian(&state, &L_symp, &L_metr);
+    ASSERT_FLOAT_EQ(fp_to_double(L_symp), -0.5, 4 * LSB + 1e-5, "L_symp at |O_n| = 1");
+    ASSERT_FLOAT_EQ(fp_to_double(L_metr), 0.5 * 0.1 * M_PI * M_PI, 1e-4, "L_metr at theta = 0");
+
+    /* Trayectoria: comparar con la misma fórmula en double */
+    golden_operator_init(&state);
+    double max_err = 0.0;
+    for (int i = 0; i < 20000; i++) {
+        golden_operator_step(&state);
+        golden_operator_compute_lagrangian(&state, &L_symp, &L_metr);
+        double o = fp_to_double(state.O_n);
+        double th = fp_to_double(state.theta);
+        double eta = fp_to_double(state.viscosity);
+        double ls = 0.5 * o * o - cos(th);
+        double lm = 0.5 * eta * (th - fp_to_double(PI_FP)) * (th - fp_to_double(PI_FP));
+        double e = fabs(fp_to_double(L_symp) - ls) + fabs(fp_to_double(L_metr) - lm);
+        if (e > max_err) max_err = e;
+    }
+    ASSERT(max_err < 1e-4, "Lagrangians should track the double formula");
+    PASS();
+}
+
+TEST(test_golden_observables_no_overflow) {
+    GoldenState state;
+    GoldenObservables obs;
+    golden_operator_init(&state);
+
+    /* Re = O_n / η: desbordaba en Q16.16 con |O_n| ≥ ½ */
+    static const double o_values[] = { 1.0, -1.0, 0.75, -0.5 };
+    for (uint32_t k = 0; k < 4; k++) {
+        state.O_n = FP_FROM_DOUBLE(o_values[k]);
+        golden_operator_compute_observables(&state, &obs);
+        double expected = o_values[k] / fp_to_double(state.viscosity);
+        ASSERT_FLOAT_EQ(fp_to_double(obs.reynolds_info), expected, 1e-3,
+                        "reynolds_info should be O_n / viscosity");
+    }
+
+    /* Fase πφ'n reducida módulo 2π, sin importar n */
+    static const uint32_t n_values[] = { 1, 1000, 100000, 40000000, 4000000000u };
+    for (uint32_t k = 0; k < 5; k++) {
+        state.n = n_values[k];
+        golden_operator_compute_observables(&state, &obs);
+        double expected = fmod(M_PI * PHI_CONJUGATE * (double)n_values[k], 2.0 * M_PI);
+        double got = fp_to_double(obs.phase_accumulator);
+        double diff = fabs(got - expected);
+        if (diff > M_PI) diff = 2.0 * M_PI - diff;
+        ASSERT(got >= 0.0 && got < 2.0 * M_PI + LSB, "Phase should lie in [0, 2pi)");
+        ASSERT(diff < 2 * LSB + 1e-5, "Phase should match pi*phi'*n mod 2pi");
+    }
+    PASS();
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void) {
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: Fixed-Point Format %s\n", DIT_FP_NAME);
+    printf("============================================\n\n");
+
+    printf("Arithmetic:\n");
+    RUN_TEST(test_format_constants);
+    RUN_TEST(test_fp_mul_exact);
+    RUN_TEST(test_fp_mul_saturates);
+    RUN_TEST(test_fp_div_exact);
+    RUN_TEST(test_angle_conversion);
+    RUN_TEST(test_trig_precision);
+
+    printf("\nGolden Path:\n");
+    RUN_TEST(test_golden_lagrangian_no_overflow);
+    RUN_TEST(test_golden_observables_no_overflow);
+
+    printf("\n============================================\n");
+    printf(" Results: %d/%d passed, %d failed\n", tests_passed, tests_run, tests_failed);
+    printf("============================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
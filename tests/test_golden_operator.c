@@ -21,6 +21,7 @@
 
 #include "../include/dit_physics.h"
 #include "../include/dit_math_fixed.h"
+#include "../kernel/golden_operator.h"
 
 /* Usar math.h para tests en host */
 #define golden_cos(x) cos(x)
@@ -261,6 +262,163 @@ TEST(test_fixed_point_accuracy) {
     PASS();
 }
 
+TEST(test_fixed_sin_table_accuracy) {
+    /* Barrido de toda la vuelta binaria: error ≤ 2^-16 (1 LSB en Q16.16) */
+    double max_err = 0.0;
+    for (uint32_t k = 0; k < (1u << 20); k++) {
+        dit_angle_t a = k << 12;
+        double x = (double)a * (2.0 * M_PI / 4294967296.0);
+        double err_s = fabs((double)dit_sin_angle(a) / FP_ONE - sin(x));
+        double err_c = fabs((double)dit_cos_angle(a) / FP_ONE - cos(x));
+        if (err_s > max_err) max_err = err_s;
+        if (err_c > max_err) max_err = err_c;
+    }
+    ASSERT(max_err <= 1.0 / FP_ONE, "Table sin/cos error should be within 1 LSB");
+    PASS();
+}
+
+TEST(test_fixed_golden_large_n) {
+    /* La fase πφn en BAM no se degrada con n grande */
+    static const int ns[] = {1000, 123457, 10000000, 1000000007, 2147483647};
+    for (int i = 0; i < (int)(sizeof(ns) / sizeof(ns[0])); i++) {
+        int n = ns[i];
+        long double turns = (long double)PHI_CONJUGATE * 0.5L * n;
+        turns -= floorl(turns);
+        double expected = ((n & 1) ? -1.0 : 1.0) * cos(2.0 * M_PI * (double)turns);
+        double got = (double)get_golden_operator_fixed(n, 0) / FP_ONE;
+        ASSERT_FLOAT_EQ(got, expected, 1e-3, "O_n should stay accurate at large n");
+    }
+    PASS();
+}
+
+TEST(test_fixed_trig_phase_independent_of_n) {
+    /*
+     * La reducción de rango en BAM da el mismo error para n pequeño que
+     * para n = 2^30 (antes, miles de iteraciones de reducción). El coste
+     * por llamada se mide en make bench, no aquí: -O0 y rdtsc en un
+     * test unitario dan cotas frágiles.
+     */
+    static const int bases[] = {0, 1 << 30};
+    double worst[2] = {0.0, 0.0};
+    for (int b = 0; b < 2; b++) {
+        for (int k = 0; k < 256; k++) {
+            int n = bases[b] + k;
+            long double turns = (long double)PHI_CONJUGATE * 0.5L * n;
+            turns -= floorl(turns);
+            double expected = ((n & 1) ? -1.0 : 1.0) * cos(2.0 * M_PI * (double)turns);
+            double err = fabs((double)get_golden_operator_fixed(n, 0) / FP_ONE - expected);
+            if (err > worst[b]) worst[b] = err;
+        }
+    }
+    ASSERT(worst[0] < 1e-3, "O_n accurate for small n");
+    ASSERT(worst[1] < 1e-3, "O_n equally accurate at n = 2^30");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS DEL GENERADOR (RECURRENCIA DE ROTACIÓN)
+ * ============================================================ */
+
+/* Referencia directa: (-1)^n cos(πφn + δ) con δ = DIT_DELTA_DEFAULT */
+static double golden_reference(uint32_t n) {
+    long double turns = (long double)PHI_CONJUGATE * 0.5L * n;
+    turns -= floorl(turns);
+    return ((n & 1) ? -1.0 : 1.0) * cos(2.0 * M_PI * (double)turns + DIT_DELTA_DEFAULT);
+}
+
+TEST(test_generator_double_accuracy) {
+    /* Varias resincronizaciones: el error no se acumula */
+    GoldenGenerator gen;
+    golden_generator_init(&gen, 7, DIT_DELTA_DEFAULT);
+    for (uint32_t n = 7; n < 7 + 10 * GOLDEN_RESYNC_INTERVAL; n++) {
+        ASSERT_FLOAT_EQ(golden_generator_next(&gen), golden_reference(n), 1e-10,
+                        "Double generator should match the direct operator");
+    }
+    PASS();
+}
+
+TEST(test_generator_fixed_accuracy) {
+    GoldenGeneratorFixed gen;
+    golden_generator_fixed_init(&gen, 7, (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE));
+    for (uint32_t n = 7; n < 7 + 10 * GOLDEN_RESYNC_INTERVAL; n++) {
+        double got = (double)golden_generator_fixed_next(&gen) / FP_ONE;
+        ASSERT_FLOAT_EQ(got, golden_reference(n), 3.0 / FP_ONE,
+                        "Fixed generator should stay within 3 LSB");
+    }
+    PASS();
+}
+
+TEST(test_generate_batch_matches_generator) {
+    /* El lote de 4 vías reproduce el generador secuencial (incluida la cola) */
+    static double batch[1001];
+    static fixed_t batch_fx[1001];
+    GoldenGenerator gen;
+    GoldenGeneratorFixed gen_fx;
+    
+    golden_operator_generate(12345, 1001, batch);
+    golden_operator_generate_fixed(12345, 1001, batch_fx);
+    golden_generator_init(&gen, 12345, DIT_DELTA_DEFAULT);
+    golden_generator_fixed_init(&gen_fx, 12345, (fixed_t)(DIT_DELTA_DEFAULT * FP_ONE));
+    
+    for (uint32_t k = 0; k < 1001; k++) {
+        ASSERT_FLOAT_EQ(batch[k], golden_generator_next(&gen), 1e-10,
+                        "Batch should match the double generator");
+        double fx = (double)golden_generator_fixed_next(&gen_fx);
+        ASSERT_FLOAT_EQ((double)batch_fx[k], fx, 3.0, "Batch should match the fixed generator");
+    }
+    PASS();
+}
+
+TEST(test_advance_matches_stepwise) {
+    /* golden_operator_advance(k) ≡ k × golden_operator_step, dentro de la cota */
+    static const uint32_t prefix[] = {0, 100, 3000};
+    static const uint32_t jumps[] = {1, 31, 32, 1000, 20000};
+    
+    for (uint32_t a = 0; a < 3; a++) {
+        for (uint32_t b = 0; b < 5; b++) {
+            GoldenState stepped, jumped;
+            golden_operator_init(&stepped);
+            for (uint32_t i = 0; i < prefix[a]; i++) golden_operator_step(&stepped);
+            jumped = stepped;
+            
+            for (uint32_t i = 0; i < jumps[b]; i++) golden_operator_step(&stepped);
+            golden_operator_advance(&jumped, jumps[b]);
+            
+            ASSERT(jumped.n == stepped.n, "Advance should reach step n + k");
+            double dtheta = fabs((double)(jumped.theta - stepped.theta) / FP_ONE);
+            ASSERT(dtheta <= GOLDEN_ADVANCE_MAX_ERROR, "Theta should stay within the advance error bound");
+            ASSERT(abs(jumped.O_n - stepped.O_n) <= 2, "O_n at n + k should match");
+        }
+    }
+    PASS();
+}
+
+TEST(test_lazy_observables) {
+    /* Sólo se recalcula cuando el estado avanzó, y coincide con el cálculo directo */
+    GoldenState state;
+    GoldenObservablesCache cache;
+    GoldenObservables direct;
+    golden_operator_init(&state);
+    golden_observables_cache_init(&cache);
+    
+    for (uint32_t i = 0; i < 50; i++) golden_operator_step(&state);
+    const GoldenObservables *obs = golden_operator_get_observables(&state, &cache);
+    golden_operator_compute_observables(&state, &direct);
+    ASSERT(memcmp(obs, &direct, sizeof(direct)) == 0, "Lazy observables should match the direct computation");
+    ASSERT(cache.generation == state.generation, "Cache should record the state generation");
+    
+    /* Sin pasos nuevos: la caché se devuelve tal cual */
+    cache.obs.ipr = -1;
+    obs = golden_operator_get_observables(&state, &cache);
+    ASSERT(obs->ipr == -1, "No step should mean no recomputation");
+    
+    golden_operator_step(&state);
+    obs = golden_operator_get_observables(&state, &cache);
+    golden_operator_compute_observables(&state, &direct);
+    ASSERT(memcmp(obs, &direct, sizeof(direct)) == 0, "A step should invalidate the cache");
+    PASS();
+}
+
 /* ============================================================
  * MAIN
  * ============================================================ */
@@ -289,6 +447,16 @@ int main(void) {
     
     printf("\nFixed-Point Operator Tests:\n");
     RUN_TEST(test_fixed_point_accuracy);
+    RUN_TEST(test_fixed_sin_table_accuracy);
+    RUN_TEST(test_fixed_golden_large_n);
+    RUN_TEST(test_fixed_trig_phase_independent_of_n);
+    
+    printf("\nRotation Recurrence Generator Tests:\n");
+    RUN_TEST(test_generator_double_accuracy);
+    RUN_TEST(test_generator_fixed_accuracy);
+    RUN_TEST(test_generate_batch_matches_generator);
+    RUN_TEST(test_advance_matches_stepwise);
+    RUN_TEST(test_lazy_observables);
 
     printf("\n============================================\n");
     printf(" Results: %d/%d passed, %d failed\n", tests_passed, tests_run, tests_failed);
@@ -0,0 +1,460 @@
+/*
+ * Test Suite - Memory Manager
+ * Smopsys Q-CORE
+ *
+ * Ejecuta MemoryManager.cpp en el host sobre su megabyte por defecto:
+ * la RAM del gestor se mapea en su dirección física (0x100000), así
+ * que el gestor trabaja con las mismas direcciones de 32 bits que en
+ * el kernel, y el mapa E820 es host_e820_map (sin magic).
+ * Cubre el buddy (alineación, fusión tras la evaporación, descarte),
+ * la reserva de páginas a cero y la compactación de manejadores.
+ *
+ * Compilar con: make test (MemoryManager.cpp con g++ -include
+ *               tests/host_kernel.h, este fichero con gcc -no-pie)
+ * Ejecutar con: ./test_memory_manager
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+
+/* ============================================================
+ * FRAMEWORK DE TESTS SIMPLE
+ * ============================================================ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+} while(0)
+
+#define ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n", msg); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define PASS() do { \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+/* ============================================================
+ * API DEL GESTOR (MemoryManager.cpp, extern "C")
+ * ============================================================ */
+
+void memory_init(void);
+void memory_sweep(uint32_t global_time, uint32_t budget_cycles);
+uint32_t memory_allocate(uint32_t size);
+void memory_free(uint32_t address);
+void memory_discard(uint32_t address);
+uint32_t memory_allocate_zeroed(uint32_t size);
+void memory_zero_pool_refill(void);
+uint32_t memory_handle_alloc(uint32_t size);
+uint32_t memory_handle_lock(uint32_t handle);
+void memory_handle_unlock(uint32_t handle);
+void memory_handle_free(uint32_t handle);
+void memory_compact(uint32_t budget_cycles);
+uint32_t memory_get_used_pages(void);
+uint32_t memory_get_total_pages(void);
+void memory_get_fragmentation(uint32_t *free_pages, uint32_t *largest_run, uint32_t *largest_block,
+                              uint32_t *histogram, uint32_t buckets);
+void memory_get_compact_stats(uint32_t *passes, uint32_t *moves, uint32_t *pages, uint32_t *handles);
+void memory_get_zero_pool_stats(uint32_t *count, uint32_t *hits, uint32_t *misses);
+
+/* Las versiones del kernel (rep stosl/movsl), no las de libc */
+void *memset(void *dest, int ch, uint32_t count);
+void *memcpy(void *dest, const void *src, uint32_t count);
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+#define MM_BASE          0x100000u  /* MEMORY_BASE */
+#define MM_PAGES         256        /* MEMORY_DEFAULT_PAGES */
+#define MM_PAGE_SIZE     4096
+#define MM_ZERO_POOL     32         /* ZERO_POOL_PAGES */
+#define MM_BUCKETS       11         /* Órdenes del buddy: 2^0..2^10 */
+#define EVAPORATE_TICKS  200000     /* Tope de ticks para evaporar */
+#define COMPACT_CALLS    64
+
+/* Mapa E820 del gestor (tests/host_kernel.h): sin magic */
+uint8_t host_e820_map[4096];
+
+static uint32_t ticks = 0;
+
+/* Gestor recién iniciado sobre el megabyte por defecto */
+static void fresh_heap(void) {
+    memory_init();
+    ticks = 0;
+}
+
+/* Avanzar el latido hasta que sólo queden used páginas entregadas */
+static int evaporate_until(uint32_t used) {
+    while (memory_get_used_pages() > used) {
+        if (ticks >= EVAPORATE_TICKS) return 0;
+        ticks += 16;
+        memory_sweep(ticks, 1000000);
+    }
+    return 1;
+}
+
+/* Compactar con presupuesto ilimitado hasta que ninguna pasada mueva nada */
+static void compact_until_idle(void) {
+    uint32_t passes, moves, pages, handles;
+    uint32_t last_passes = ~0u, last_moves = ~0u;
+    for (int call = 0; call < COMPACT_CALLS; call++) {
+        memory_compact(~0u);
+        memory_get_compact_stats(&passes, &moves, &pages, &handles);
+        if (passes == last_passes && moves == last_moves) return;
+        last_passes = passes;
+        last_moves = moves;
+    }
+}
+
+static uint32_t largest_free_block(void) {
+    uint32_t free_pages, run, block, hist[MM_BUCKETS];
+    memory_get_fragmentation(&free_pages, &run, &block, hist, MM_BUCKETS);
+    return block;
+}
+
+static uint32_t word_pattern(uint32_t handle, uint32_t word) {
+    return handle * 1000003u + word;
+}
+
+static void fill_block(uint32_t handle, uint32_t bytes) {
+    uint32_t *w = (uint32_t *)(uintptr_t)memory_handle_lock(handle);
+    for (uint32_t j = 0; j < bytes / 4; j++) w[j] = word_pattern(handle, j);
+    memory_handle_unlock(handle);
+}
+
+static int block_intact(uint32_t handle, uint32_t bytes) {
+    const uint32_t *w = (const uint32_t *)(uintptr_t)memory_handle_lock(handle);
+    int ok = w != 0;
+    for (uint32_t j = 0; ok && j < bytes / 4; j++) ok = w[j] == word_pattern(handle, j);
+    memory_handle_unlock(handle);
+    return ok;
+}
+
+static int page_is_zero(uint32_t address) {
+    const uint8_t *p = (const uint8_t *)(uintptr_t)address;
+    for (uint32_t i = 0; i < MM_PAGE_SIZE; i++) {
+        if (p[i]) return 0;
+    }
+    return 1;
+}
+
+/* ============================================================
+ * TESTS: memset / memcpy
+ * ============================================================ */
+
+/* Cabeza, cuerpo de 32 bits y cola, con cualquier alineación */
+TEST(test_memset_memcpy_unaligned) {
+    static uint8_t buf[300], src[300], ref[300];
+
+    for (uint32_t off = 0; off < 8; off++) {
+        for (uint32_t len = 0; len < 200; len++) {
+            for (int i = 0; i < 300; i++) buf[i] = ref[i] = (uint8_t)(i * 7);
+            memset(buf + off, 0xAB, len);
+            for (uint32_t i = off; i < off + len; i++) ref[i] = 0xAB;
+            for (int i = 0; i < 300; i++) ASSERT(buf[i] == ref[i], "memset writes exactly [off, off+len)");
+
+            for (uint32_t so = 0; so < 4; so++) {
+                for (int i = 0; i < 300; i++) {
+                    src[i] = (uint8_t)(i * 13 + 1);
+                    buf[i] = ref[i] = 0;
+                }
+                memcpy(buf + off, src + so, len);
+                for (uint32_t i = 0; i < len; i++) ref[off + i] = src[so + i];
+                for (int i = 0; i < 300; i++) ASSERT(buf[i] == ref[i], "memcpy copies exactly len bytes");
+            }
+        }
+    }
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: BUDDY
+ * ============================================================ */
+
+/* Sin mapa E820: un único tramo libre, menos los metadatos */
+TEST(test_default_heap_is_one_free_run) {
+    fresh_heap();
+    uint32_t total = memory_get_total_pages();
+    uint32_t free_pages, run, block, hist[MM_BUCKETS];
+    memory_get_fragmentation(&free_pages, &run, &block, hist, MM_BUCKETS);
+
+    ASSERT(total > 0 && total < MM_PAGES, "metadata carved from the default megabyte");
+    ASSERT(memory_get_used_pages() == 0, "nothing allocated after init");
+    ASSERT(free_pages == total, "every usable page is on a free list");
+    ASSERT(run == total, "free blocks tile one contiguous run");
+    ASSERT(block == MM_PAGES / 2, "largest block is the aligned lower half");
+    PASS();
+}
+
+/* Cada bloque es de 2^k páginas, alineado a 2^k y sin solaparse */
+TEST(test_blocks_aligned_and_disjoint) {
+    static const uint32_t sizes[] = { 100, 4096, 8192, 12288, 16384, 20480, 65536, 4097 };
+    static const uint32_t pages[] = { 1, 1, 2, 4, 4, 8, 16, 2 };
+    enum { N = sizeof(sizes) / sizeof(sizes[0]) };
+    uint32_t addr[N];
+    uint32_t expect_used = 0;
+
+    fresh_heap();
+    for (int k = 0; k < N; k++) {
+        addr[k] = memory_allocate(sizes[k]);
+        ASSERT(addr[k] != 0, "allocation succeeds");
+        ASSERT((addr[k] - MM_BASE) % (pages[k] * MM_PAGE_SIZE) == 0, "block aligned to its size");
+        expect_used += pages[k];
+    }
+    for (int a = 0; a < N; a++) {
+        for (int b = a + 1; b < N; b++) {
+            uint32_t a_end = addr[a] + pages[a] * MM_PAGE_SIZE;
+            uint32_t b_end = addr[b] + pages[b] * MM_PAGE_SIZE;
+            ASSERT(a_end <= addr[b] || b_end <= addr[a], "blocks do not overlap");
+        }
+    }
+    ASSERT(memory_get_used_pages() == expect_used, "used pages count whole blocks");
+    ASSERT(memory_allocate(MM_PAGES * MM_PAGE_SIZE) == 0, "request larger than the heap fails");
+    PASS();
+}
+
+/* Liberado, un bloque se evapora página a página y el buddy lo fusiona */
+TEST(test_free_merges_back_after_evaporation) {
+    uint32_t addr[64];
+    int n = 0;
+
+    fresh_heap();
+    uint32_t total = memory_get_total_pages();
+    uint32_t block = largest_free_block();
+    while (n < 64 && (addr[n] = memory_allocate((n % 3 + 1) * MM_PAGE_SIZE)) != 0) n++;
+    ASSERT(n > 16, "heap takes a mix of small blocks");
+
+    for (int k = 0; k < n; k++) memory_free(addr[k]);
+    memory_free(addr[0]);                   /* Doble liberación: ignorada */
+    memory_free(addr[1] + MM_PAGE_SIZE);    /* Página interior: ignorada */
+    ASSERT(memory_get_used_pages() > 0, "freed pages evaporate, not return at once");
+    ASSERT(evaporate_until(0), "every freed page evaporates");
+
+    uint32_t free_pages, run, largest, hist[MM_BUCKETS];
+    memory_get_fragmentation(&free_pages, &run, &largest, hist, MM_BUCKETS);
+    ASSERT(free_pages == total, "all pages back on the free lists");
+    ASSERT(run == total && largest == block, "buddies merged back to the initial blocks");
+    PASS();
+}
+
+/* memory_discard devuelve el bloque al buddy en el acto */
+TEST(test_discard_returns_pages_immediately) {
+    fresh_heap();
+    uint32_t block = largest_free_block();
+    uint32_t a = memory_allocate(3 * MM_PAGE_SIZE);
+    uint32_t b = memory_allocate(MM_PAGE_SIZE);
+    ASSERT(a && b, "allocations succeed");
+    ASSERT(memory_get_used_pages() == 5, "4-page and 1-page blocks");
+
+    memory_discard(a);
+    memory_discard(b);
+    memory_discard(b);                      /* Segunda vez: ignorada */
+    ASSERT(memory_get_used_pages() == 0, "discarded pages are free without ticks");
+    ASSERT(largest_free_block() == block, "discarded blocks merge at once");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: RESERVA DE PÁGINAS A CERO
+ * ============================================================ */
+
+/* La reserva sirve páginas a cero aunque el buddy tenga basura */
+TEST(test_zero_pool_serves_zeroed_pages) {
+    uint32_t count, hits, misses;
+
+    fresh_heap();
+    uint32_t total = memory_get_total_pages();
+    memset((void *)(uintptr_t)MM_BASE, 0xA5, total * MM_PAGE_SIZE);
+
+    memory_zero_pool_refill();
+    memory_get_zero_pool_stats(&count, &hits, &misses);
+    ASSERT(count == MM_ZERO_POOL, "refill fills the pool");
+    ASSERT(memory_get_used_pages() == MM_ZERO_POOL, "pool pages count as used");
+
+    for (uint32_t k = 0; k < MM_ZERO_POOL; k++) {
+        uint32_t p = memory_allocate_zeroed(MM_PAGE_SIZE);
+        ASSERT(p != 0 && page_is_zero(p), "pool page is zeroed");
+    }
+    memory_get_zero_pool_stats(&count, &hits, &misses);
+    ASSERT(count == 0 && hits == MM_ZERO_POOL && misses == 0, "every request hit the pool");
+
+    uint32_t p = memory_allocate_zeroed(MM_PAGE_SIZE);
+    memory_get_zero_pool_stats(&count, &hits, &misses);
+    ASSERT(p != 0 && page_is_zero(p), "empty pool falls back to allocate + memset");
+    ASSERT(misses == 1, "fallback counted as a miss");
+    ASSERT(memory_get_used_pages() == MM_ZERO_POOL + 1, "pool pages stay allocated");
+    PASS();
+}
+
+/* Bajo presión la reserva cede sus páginas y el heap se llena entero */
+TEST(test_zero_pool_reclaimed_under_pressure) {
+    uint32_t count, hits, misses;
+
+    fresh_heap();
+    uint32_t total = memory_get_total_pages();
+    memory_zero_pool_refill();
+
+    uint32_t got = 0;
+    while (memory_allocate(MM_PAGE_SIZE)) got++;
+    memory_get_zero_pool_stats(&count, &hits, &misses);
+    ASSERT(count == 0, "pool emptied by the reclaimer");
+    ASSERT(got == total && memory_get_used_pages() == total, "every page reachable under pressure");
+
+    memory_zero_pool_refill();
+    memory_get_zero_pool_stats(&count, &hits, &misses);
+    ASSERT(count == 0, "no refill without slack");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: COMPACTACIÓN
+ * ============================================================ */
+
+#define FRAG_HANDLES 192
+
+static uint32_t frag_handle[FRAG_HANDLES];
+static uint32_t frag_bytes[FRAG_HANDLES];
+static int frag_count;
+static uint32_t pinned_handle, pinned_addr;
+
+/* Heap fragmentado: lleno de manejadores de 1 y 2 páginas, uno de cada
+ * dos liberado (huecos pequeños) y el último fijado */
+static int build_fragmented_heap(void) {
+    fresh_heap();
+    for (frag_count = 0; frag_count < FRAG_HANDLES; frag_count++) {
+        int k = frag_count;
+        frag_bytes[k] = (k % 3 == 0 ? 2 : 1) * MM_PAGE_SIZE;
+        frag_handle[k] = memory_handle_alloc(frag_bytes[k]);
+        if (!frag_handle[k]) break;
+        fill_block(frag_handle[k], frag_bytes[k]);
+    }
+    if (frag_count < 16) return 0;
+
+    uint32_t used = memory_get_used_pages();
+    for (int k = 0; k < frag_count - 1; k += 2) {
+        used -= frag_bytes[k] / MM_PAGE_SIZE;
+        memory_handle_free(frag_handle[k]);
+        frag_handle[k] = 0;
+    }
+    pinned_handle = frag_handle[frag_count - 1];
+    pinned_addr = memory_handle_lock(pinned_handle);
+    return evaporate_until(used);
+}
+
+static uint32_t free_runs(const uint32_t *hist) {
+    uint32_t runs = 0;
+    for (int b = 0; b < MM_BUCKETS; b++) runs += hist[b];
+    return runs;
+}
+
+TEST(test_compaction_merges_holes) {
+    uint32_t free_before, run_before, block_before, hist_before[MM_BUCKETS];
+    uint32_t free_after, run_after, block_after, hist_after[MM_BUCKETS];
+    uint32_t passes, moves, pages, handles;
+
+    ASSERT(build_fragmented_heap(), "fragmented heap built");
+    memory_get_fragmentation(&free_before, &run_before, &block_before, hist_before, MM_BUCKETS);
+    ASSERT(block_before <= 2, "freed handles leave only small holes");
+
+    compact_until_idle();
+    memory_get_fragmentation(&free_after, &run_after, &block_after, hist_after, MM_BUCKETS);
+    memory_get_compact_stats(&passes, &moves, &pages, &handles);
+
+    ASSERT(moves > 0 && pages >= moves, "compaction moved blocks");
+    uint32_t kept = 0;
+    for (int k = 0; k < frag_count; k++) kept += frag_handle[k] != 0;
+    ASSERT(handles == kept, "moving keeps every handle");
+    ASSERT(free_after == free_before, "moving neither leaks nor gains pages");
+    ASSERT(free_runs(hist_after) < free_runs(hist_before), "holes merged into fewer runs");
+    ASSERT(block_after > block_before, "a larger free block formed");
+
+    memory_handle_unlock(pinned_handle);
+    PASS();
+}
+
+TEST(test_compaction_preserves_contents) {
+    ASSERT(build_fragmented_heap(), "fragmented heap built");
+    compact_until_idle();
+
+    for (int k = 0; k < frag_count; k++) {
+        if (frag_handle[k]) ASSERT(block_intact(frag_handle[k], frag_bytes[k]), "moved block keeps its data");
+    }
+    memory_handle_unlock(pinned_handle);
+    PASS();
+}
+
+TEST(test_compaction_never_moves_pinned) {
+    uint32_t passes, moves, pages, handles;
+
+    ASSERT(build_fragmented_heap(), "fragmented heap built");
+    compact_until_idle();
+    memory_get_compact_stats(&passes, &moves, &pages, &handles);
+    ASSERT(moves > 0, "compaction ran around the pinned block");
+    ASSERT(memory_handle_lock(pinned_handle) == pinned_addr, "pinned block stays put");
+    memory_handle_unlock(pinned_handle);
+    memory_handle_unlock(pinned_handle);
+
+    /* Sin huecos nuevos la compactación no hace nada */
+    memory_compact(~0u);
+    uint32_t passes_idle, moves_idle;
+    memory_get_compact_stats(&passes_idle, &moves_idle, &pages, &handles);
+    ASSERT(passes_idle == passes && moves_idle == moves, "idle call starts no pass");
+    PASS();
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void) {
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: Memory Manager Tests\n");
+    printf("============================================\n\n");
+
+    /* RAM del gestor en su dirección física; -no-pie deja el
+     * ejecutable por encima (0x400000) */
+    void *ram = mmap((void *)(uintptr_t)MM_BASE, MM_PAGES * MM_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (ram != (void *)(uintptr_t)MM_BASE) {
+        printf("  FAILED: cannot map the manager's RAM at 0x%x\n", MM_BASE);
+        return 1;
+    }
+
+    printf("memset / memcpy:\n");
+    RUN_TEST(test_memset_memcpy_unaligned);
+
+    printf("\nBuddy:\n");
+    RUN_TEST(test_default_heap_is_one_free_run);
+    RUN_TEST(test_blocks_aligned_and_disjoint);
+    RUN_TEST(test_free_merges_back_after_evaporation);
+    RUN_TEST(test_discard_returns_pages_immediately);
+
+    printf("\nZero Pool:\n");
+    RUN_TEST(test_zero_pool_serves_zeroed_pages);
+    RUN_TEST(test_zero_pool_reclaimed_under_pressure);
+
+    printf("\nCompaction:\n");
+    RUN_TEST(test_compaction_merges_holes);
+    RUN_TEST(test_compaction_preserves_contents);
+    RUN_TEST(test_compaction_never_moves_pinned);
+
+    printf("\n============================================\n");
+    printf(" Results: %d/%d passed, %d failed\n", tests_passed, tests_run, tests_failed);
+    printf("============================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,466 @@
+/*
+ * Test Suite - Quantum Laser
+ * Smopsys Q-CORE
+ *
+ * Integra el láser de Lindblad en el host tal como lo usa el bridge
+ * de SmopsysQL (átomo ⊗ cavidad en LINDBLAD_MAX_DIM, bombeo Gaussiano)
+ * y comprueba que ρ sigue siendo una matriz densidad. El propio bridge
+ * (laser_pulse_emit) se enlaza con el puerto serie, la caché y la
+ * arena simulados.
+ *
+ * Compilar con: gcc -no-pie -include host_kernel.h test_quantum_laser.c ../kernel/quantum_laser.c
+ *               ../kernel/lindblad.c ../kernel/pulse_envelope.c
+ *               ../kernel/ql_bridge.c ../kernel/dit_math.c -lm
+ *               -o test_quantum_laser
+ * Ejecutar con: ./test_quantum_laser
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdint.h>
+
+#include "../kernel/quantum_laser.h"
+#include "../kernel/laser_cache.h"
+#include "../kernel/ql_bridge.h"
+
+/* ============================================================
+ * FRAMEWORK DE TESTS SIMPLE
+ * ============================================================ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+} while(0)
+
+#define ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n", msg); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define ASSERT_MAX(err, bound, msg) do { \
+    if (!((err) <= (bound))) { \
+        printf("FAILED\n    %s: max error %g exceeds %g\n", msg, (double)(err), (double)(bound)); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define PASS() do { \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+/* ============================================================
+ * GESTOR DE MEMORIA SIMULADO
+ *
+ * lindblad.c pide su espacio de trabajo RK4 al gestor del kernel
+ * (memory_handle_*). Aquí un único bloque estático: -no-pie lo deja
+ * por debajo de 4GB, donde cabe en una dirección de 32 bits.
+ * ============================================================ */
+
+static uint8_t handle_block[64 * 1024] __attribute__((aligned(16)));
+static int handle_lock_fails = 0;       /* Simula un bloque no fijable */
+
+uint32_t memory_handle_alloc(uint32_t size) {
+    return (size <= sizeof(handle_block)) ? 1 : 0;
+}
+
+uint32_t memory_handle_lock(uint32_t handle) {
+    if (handle_lock_fails) return 0;
+    return handle ? (uint32_t)(uintptr_t)handle_block : 0;
+}
+
+void memory_handle_unlock(uint32_t handle) {
+    (void)handle;
+}
+
+/* El bridge reserva su LindbladSystem en una arena de paging.c; el
+ * gestor (memory_allocate) solo es la reserva sin PSE. */
+static LindbladSystem arena_system;
+static uint32_t arena_reserves = 0;
+
+uint32_t paging_arena_reserve(uint32_t size) {
+    arena_reserves++;
+    return (size <= sizeof(arena_system)) ? (uint32_t)(uintptr_t)&arena_system : 0;
+}
+
+uint32_t memory_allocate(uint32_t size) {
+    (void)size;
+    return 0;
+}
+
+/* ============================================================
+ * PUERTO SERIE Y CACHÉ SIMULADOS (ql_bridge.c)
+ *
+ * La caché nunca acierta; laser_cache_store copia lo que el bridge
+ * guardaría para comprobar que todas las muestras están escritas.
+ * ============================================================ */
+
+static uint32_t cache_stores = 0;
+static LaserObservable stored_obs[LASER_CACHE_SAMPLES];
+static uint32_t stored_samples = 0;
+
+void bayesian_serial_write(const char *str) { (void)str; }
+void bayesian_serial_write_char(char c) { (void)c; }
+void bayesian_serial_write_hex(uint32_t val) { (void)val; }
+void bayesian_serial_write_float(double val, uint8_t precision) { (void)val; (void)precision; }
+
+void check_thermal_page_impl(uint32_t address, double threshold, double *out_entropy, int *out_critical) {
+    (void)address; (void)threshold;
+    *out_entropy = 0.0;
+    *out_critical = 0;
+}
+
+int laser_cache_lookup(uint64_t key, CMatrix *r, LaserObservable *o, uint32_t num_samples) {
+    (void)key; (void)r; (void)o; (void)num_samples;
+    return 0;
+}
+
+void laser_cache_store(uint64_t key, const CMatrix *r, const LaserObservable *o, uint32_t num_samples) {
+    (void)key; (void)r;
+    cache_stores++;
+    stored_samples = num_samples;
+    for (uint32_t k = 0; k < num_samples && k < LASER_CACHE_SAMPLES; k++) stored_obs[k] = o[k];
+}
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+#define PULSE_SAMPLES    32
+
+static LindbladSystem sys;
+static CMatrix rho;
+static PulseEnvelope pump_env;
+static LaserObservable obs[PULSE_SAMPLES];
+
+/* Parámetros del bridge para un pulso de FWHM width (unidades de 10 ns) */
+static void pulse_params(LaserParams *p, double width) {
+    laser_params_default(p);
+    p->dim_cavity = LINDBLAD_MAX_DIM / p->dim_atom;
+    envelope_build(&pump_env, ENVELOPE_GAUSSIAN, 0.0, 2.0 * width, width, width, 1.0);
+    p->pump_envelope = &pump_env;
+    laser_set_time_window(p, 0.0, 2.0 * width, QL_PULSE_STEPS);
+}
+
+/* |Tr ρ - 1| y la población diagonal más negativa */
+static void density_check(const CMatrix *r, double *trace_err, double *min_diag) {
+    double tr = 0.0;
+    *min_diag = 0.0;
+    for (uint32_t i = 0; i < r->rows; i++) {
+        double d = r->data[i][i].re;
+        tr += d;
+        if (d < *min_diag) *min_diag = d;
+    }
+    *trace_err = fabs(tr - 1.0);
+}
+
+/* ============================================================
+ * TESTS: PASO ESTABLE
+ * ============================================================ */
+
+TEST(test_short_pulse_keeps_min_steps) {
+    LaserParams p;
+    pulse_params(&p, 2.0);      /* 20 ns */
+    ASSERT(fabs(p.dt - p.t_end / QL_PULSE_STEPS) < 1e-12, "short pulse uses the minimum step count");
+    ASSERT(p.dt <= laser_max_stable_dt(&p), "dt within stability bound");
+    PASS();
+}
+
+TEST(test_long_pulse_trace_preserved) {
+    /* 1 µs, 1.5 µs y 10 µs: con 40 pasos fijos dt > 2.8 y RK4 divergía */
+    static const double widths[] = {100.0, 150.0, 1000.0};
+    for (uint32_t k = 0; k < sizeof(widths) / sizeof(widths[0]); k++) {
+        LaserParams p;
+        pulse_params(&p, widths[k]);
+        ASSERT(p.dt <= laser_max_stable_dt(&p), "dt within stability bound");
+
+        laser_build_system(&p, &sys, &rho);
+        for (uint32_t s = 0; s < PULSE_SAMPLES; s++) obs[s].time = -1.0;
+        ASSERT(laser_evolve(&p, &sys, &rho, obs, PULSE_SAMPLES), "evolution completes");
+        ASSERT(obs[0].time == p.t_start, "first sample at t_start");
+        ASSERT(obs[PULSE_SAMPLES - 1].time == p.t_end, "last sample at t_end");
+        for (uint32_t s = 1; s < PULSE_SAMPLES; s++) {
+            ASSERT(obs[s].time > obs[s - 1].time, "samples written in increasing time");
+        }
+
+        double trace_err, min_diag;
+        density_check(&rho, &trace_err, &min_diag);
+        ASSERT_MAX(trace_err, 1e-9, "|Tr(rho) - 1| after long pulse");
+        ASSERT(min_diag > -1e-9, "populations stay non-negative");
+        ASSERT(obs[PULSE_SAMPLES - 1].n_photons >= 0.0 &&
+               obs[PULSE_SAMPLES - 1].n_photons < (double)p.dim_cavity, "<a+a> in range");
+    }
+    PASS();
+}
+
+TEST(test_stable_dt_shrinks_with_rates) {
+    LaserParams p;
+    pulse_params(&p, 10.0);
+    double dt = laser_max_stable_dt(&p);
+    p.kappa *= 10.0;
+    ASSERT(laser_max_stable_dt(&p) < dt, "faster cavity decay needs a smaller step");
+    p.kappa /= 10.0;
+    p.g *= 10.0;
+    ASSERT(laser_max_stable_dt(&p) < dt, "stronger coupling needs a smaller step");
+    PASS();
+}
+
+TEST(test_evolve_reports_missing_workspace) {
+    LaserParams p;
+    pulse_params(&p, 2.0);
+    laser_build_system(&p, &sys, &rho);
+    double rho00 = rho.data[0][0].re;
+
+    handle_lock_fails = 1;
+    int ok = laser_evolve(&p, &sys, &rho, obs, PULSE_SAMPLES);
+    handle_lock_fails = 0;
+    ASSERT(!ok, "failed RK4 step reported to the caller");
+    ASSERT(rho.data[0][0].re == rho00, "rho untouched by the failed step");
+
+    ASSERT(laser_evolve(&p, &sys, &rho, obs, PULSE_SAMPLES), "evolves once the workspace is back");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: BRIDGE
+ * ============================================================ */
+
+TEST(test_bridge_rejects_overlong_pulse) {
+    /* dt ≈ 0.27: 1 ms serían ~7.5e5 pasos y 1 s ~7.5e8 */
+    cache_stores = 0;
+    ASSERT(laser_pulse_emit("1550nm", "1ms", 'H') == 0, "1 ms pulse rejected");
+    ASSERT(laser_pulse_emit("1550nm", "1s", 'H') == 0, "1 s pulse rejected");
+    ASSERT(cache_stores == 0, "rejected pulses not cached");
+
+    LaserParams p;
+    pulse_params(&p, 1e5);
+    ASSERT(laser_set_time_window(&p, 0.0, 2e5, QL_PULSE_STEPS) > QL_MAX_PULSE_STEPS,
+           "1 ms window exceeds the cap");
+    pulse_params(&p, 1000.0);
+    ASSERT(laser_set_time_window(&p, 0.0, 2000.0, QL_PULSE_STEPS) <= QL_MAX_PULSE_STEPS,
+           "10 us window fits under the cap");
+    PASS();
+}
+
+TEST(test_bridge_caches_every_sample) {
+    /* 10 µs: ventana de 2000 unidades, por debajo del tope */
+    cache_stores = 0;
+    for (uint32_t s = 0; s < LASER_CACHE_SAMPLES; s++) stored_obs[s].time = -1.0;
+    ASSERT(laser_pulse_emit("1550nm", "10us", 'H') == 1, "10 us pulse evolves");
+    ASSERT(cache_stores == 1 && stored_samples == LASER_CACHE_SAMPLES, "pulse stored once");
+    ASSERT(stored_obs[0].time == 0.0, "first cached sample at t_start");
+    ASSERT(stored_obs[LASER_CACHE_SAMPLES - 1].time == 2000.0, "last cached sample at t_end");
+    for (uint32_t s = 1; s < LASER_CACHE_SAMPLES; s++) {
+        ASSERT(stored_obs[s].time > stored_obs[s - 1].time, "every cached sample written");
+    }
+    PASS();
+}
+
+TEST(test_bridge_system_reserved_once) {
+    /* Varios pulsos reutilizan el mismo sistema de la arena */
+    ASSERT(laser_pulse_emit("1550nm", "10us", 'V') == 1, "pulse evolves");
+    ASSERT(laser_pulse_emit("1550nm", "10us", 'D') == 1, "second pulse evolves");
+    ASSERT(arena_reserves == 1, "Lindblad system reserved once");
+    ASSERT(arena_system.dim > 0, "system lives in the arena");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: HUELLA DE LA CACHÉ
+ * ============================================================ */
+
+TEST(test_described_envelope_hashes_like_built) {
+    /* El bridge busca en la caché antes de tabular el bombeo */
+    LaserParams built, described;
+    pulse_params(&built, 10.0);
+    uint64_t key = laser_params_hash(&built);
+    double dt = built.dt;
+
+    static PulseEnvelope lazy_env;
+    laser_params_default(&described);
+    described.dim_cavity = LINDBLAD_MAX_DIM / described.dim_atom;
+    envelope_describe(&lazy_env, ENVELOPE_GAUSSIAN, 0.0, 20.0, 10.0, 10.0, 1.0);
+    described.pump_envelope = &lazy_env;
+    laser_set_time_window(&described, 0.0, 20.0, QL_PULSE_STEPS);
+
+    ASSERT(laser_params_hash(&described) == key, "same key before tabulating");
+    ASSERT(described.dt == dt, "same step before tabulating");
+
+    envelope_build(&pump_env, ENVELOPE_GAUSSIAN, 0.0, 40.0, 20.0, 20.0, 1.0);
+    ASSERT(laser_params_hash(&built) != key, "different pulse, different key");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: OPERADORES DISPERSOS
+ * ============================================================ */
+
+TEST(test_dense_jump_operator_dagger_product) {
+    /* L denso d×d: Σ nnz_k² = d³ productos, que deben quedar en d² entradas */
+    static CMatrix L, LdL, sparse;
+    uint32_t d = LINDBLAD_MAX_DIM;
+    cmatrix_zero(&L, d, d);
+    for (uint32_t i = 0; i < d; i++) {
+        for (uint32_t j = 0; j < d; j++) {
+            L.data[i][j] = complex_make(0.1 * (double)(i + 1) - 0.03 * (double)j,
+                                        0.02 * (double)(i * j % 7) + 0.01);
+        }
+    }
+
+    lindblad_init(&sys, d);
+    ASSERT(lindblad_add_jump_operator(&sys, &L, 1.0), "dense jump operator accepted");
+    ASSERT(sys.L_dag_L[0].nnz <= d * d, "duplicates merged into at most d^2 entries");
+    ASSERT(!sys.L_dag_L[0].overflow, "no entry dropped");
+
+    /* Referencia densa: (L†L)_ij = Σ_k conj(L_ki) L_kj */
+    cmatrix_zero(&LdL, d, d);
+    for (uint32_t i = 0; i < d; i++) {
+        for (uint32_t j = 0; j < d; j++) {
+            for (uint32_t k = 0; k < d; k++) {
+                LdL.data[i][j] = complex_add(LdL.data[i][j],
+                    complex_mul(complex_conj(L.data[k][i]), L.data[k][j]));
+            }
+        }
+    }
+
+    smatrix_to_dense(&sparse, &sys.L_dag_L[0]);
+    double err = 0.0;
+    for (uint32_t i = 0; i < d; i++) {
+        for (uint32_t j = 0; j < d; j++) {
+            double e = fabs(sparse.data[i][j].re - LdL.data[i][j].re)
+                     + fabs(sparse.data[i][j].im - LdL.data[i][j].im);
+            if (e > err) err = e;
+        }
+    }
+    ASSERT_MAX(err, 1e-12, "sparse L^dagger L vs dense product");
+    PASS();
+}
+
+TEST(test_full_sparse_matrix_reports_overflow) {
+    static SMatrix m;
+    smatrix_init(&m, LINDBLAD_MAX_DIM);
+    for (uint32_t e = 0; e < LINDBLAD_MAX_NNZ; e++) {
+        smatrix_push(&m, e % LINDBLAD_MAX_DIM, e / LINDBLAD_MAX_DIM, complex_make(1.0, 0.0));
+    }
+    ASSERT(!m.overflow, "exactly LINDBLAD_MAX_NNZ entries fit");
+    ASSERT(smatrix_push(&m, 0, 0, complex_make(0.0, 0.0)), "zeros never overflow");
+    ASSERT(!smatrix_push(&m, 0, 0, complex_make(1.0, 0.0)), "push into a full matrix reported");
+    ASSERT(m.overflow, "overflow flag set");
+
+    lindblad_init(&sys, LINDBLAD_MAX_DIM);
+    ASSERT(!lindblad_add_jump_operator_sparse(&sys, &m, 1.0), "overflowed operator rejected");
+    ASSERT(sys.num_ops == 0, "rejected operator not counted");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: TAMAÑO DEL SISTEMA
+ * ============================================================ */
+
+TEST(test_oversized_system_rejected) {
+    LaserParams p;
+    laser_params_default(&p);
+    p.dim_cavity = LINDBLAD_MAX_DIM / p.dim_atom + 1;
+    sys.dim = 0xDEAD;
+    ASSERT(laser_build_system(&p, &sys, &rho) == 0, "single atom beyond LINDBLAD_MAX_DIM rejected");
+    ASSERT(sys.dim == 0xDEAD, "rejected build leaves the system untouched");
+
+    /* N = 2: C(5, 3) = 10 estados atómicos, ×2 de Fock = 20 */
+    p.num_atoms = 2;
+    p.dim_cavity = 2;
+    ASSERT(laser_atom_dim(&p) == 10, "C(N+3, 3) atomic states");
+    ASSERT(laser_build_system(&p, &sys, &rho) == 0, "ensemble with cavity rejected at default size");
+
+    /* N = 3: C(6, 3) = 20 estados ya sin cavidad */
+    p.num_atoms = 3;
+    p.dim_cavity = 1;
+    ASSERT(laser_build_system(&p, &sys, &rho) == 0, "N = 3 rejected at default size");
+
+    p.num_atoms = 100000;
+    ASSERT(laser_build_system(&p, &sys, &rho) == 0, "huge ensemble rejected without overflow");
+    PASS();
+}
+
+TEST(test_ensemble_without_cavity_evolves) {
+    LaserParams p;
+    laser_params_default(&p);
+    p.num_atoms = 2;
+    p.dim_cavity = 1;
+    p.gamma_collective = 0.05;
+    laser_set_time_window(&p, 0.0, 20.0, QL_PULSE_STEPS);
+    ASSERT(laser_build_system(&p, &sys, &rho) == 10, "N = 2 without cavity fits");
+
+    ASSERT(laser_evolve(&p, &sys, &rho, obs, PULSE_SAMPLES), "evolution completes");
+    double trace_err, min_diag;
+    density_check(&rho, &trace_err, &min_diag);
+    ASSERT_MAX(trace_err, 1e-9, "|Tr(rho) - 1| for the ensemble");
+    ASSERT(min_diag > -1e-9, "ensemble populations stay non-negative");
+    PASS();
+}
+
+TEST(test_ensemble_local_pump_populations) {
+    /* Sólo bombeo local 0 → 3: las ocupaciones siguen la binomial de
+     * N emisores independientes, lo que la proyección √n_j sí reproduce */
+    LaserParams p;
+    laser_params_default(&p);
+    p.num_atoms = 2;
+    p.dim_cavity = 1;
+    p.g = 0.0;
+    p.gamma_32 = p.gamma_21 = p.gamma_10 = 0.0;
+    laser_set_time_window(&p, 0.0, 5.0, QL_PULSE_STEPS);
+    uint32_t dim = laser_build_system(&p, &sys, &rho);
+    ASSERT(dim == 10, "N = 2 without cavity fits");
+    ASSERT(laser_evolve(&p, &sys, &rho, obs, PULSE_SAMPLES), "evolution completes");
+
+    double q = exp(-p.pump_rate * 5.0);
+    ASSERT_MAX(fabs(rho.data[0][0].re - q * q), 1e-6, "P(|2, 0, 0, 0>) = e^(-2 Gamma t)");
+    ASSERT_MAX(fabs(rho.data[dim - 1][dim - 1].re - (1.0 - q) * (1.0 - q)), 1e-6,
+               "P(|0, 0, 0, 2>) = (1 - e^(-Gamma t))^2");
+    PASS();
+}
+
+int main(void) {
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: Quantum Laser Tests\n");
+    printf("============================================\n\n");
+
+    printf("RK4 Step:\n");
+    RUN_TEST(test_short_pulse_keeps_min_steps);
+    RUN_TEST(test_long_pulse_trace_preserved);
+    RUN_TEST(test_stable_dt_shrinks_with_rates);
+    RUN_TEST(test_evolve_reports_missing_workspace);
+
+    printf("\nBridge:\n");
+    RUN_TEST(test_bridge_rejects_overlong_pulse);
+    RUN_TEST(test_bridge_caches_every_sample);
+    RUN_TEST(test_bridge_system_reserved_once);
+
+    printf("\nCache Key:\n");
+    RUN_TEST(test_described_envelope_hashes_like_built);
+
+    printf("\nSparse Operators:\n");
+    RUN_TEST(test_dense_jump_operator_dagger_product);
+    RUN_TEST(test_full_sparse_matrix_reports_overflow);
+
+    printf("\nSystem Size:\n");
+    RUN_TEST(test_oversized_system_rejected);
+    RUN_TEST(test_ensemble_without_cavity_evolves);
+    RUN_TEST(test_ensemble_local_pump_populations);
+
+    printf("\n============================================\n");
+    printf(" Results: %d/%d passed, %d failed\n", tests_passed, tests_run, tests_failed);
+    printf("============================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,474 @@
+/*
+ * Test Suite - Slab Allocator
+ * Smopsys Q-CORE
+ *
+ * kernel/slab.c y su primer consumidor, la caché de pulsos
+ * (kernel/laser_cache.c), sobre un gestor de páginas simulado: bloques
+ * de SLAB_SIZE alineados a su tamaño en un arena estático, con los
+ * reclamadores registrados invocados cuando se agota, como hace
+ * memory_allocate.
+ *
+ * Compilar con: make test (gcc -no-pie -include tests/host_kernel.h)
+ * Ejecutar con: ./test_slab
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "../kernel/slab.h"
+#include "../kernel/laser_cache.h"
+
+/* ============================================================
+ * FRAMEWORK DE TESTS SIMPLE
+ * ============================================================ */
+
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+#define TEST(name) void name(void)
+#define RUN_TEST(name) do { \
+    printf("  Running %s... ", #name); \
+    tests_run++; \
+    name(); \
+} while(0)
+
+#define ASSERT(cond, msg) do { \
+    if (!(cond)) { \
+        printf("FAILED\n    Assertion failed: %s\n", msg); \
+        tests_failed++; \
+        return; \
+    } \
+} while(0)
+
+#define PASS() do { \
+    tests_passed++; \
+    printf("PASSED\n"); \
+} while(0)
+
+/* ============================================================
+ * GESTOR DE PÁGINAS SIMULADO
+ *
+ * Cada petición recibe un bloque entero de SLAB_SIZE alineado a
+ * SLAB_SIZE (el slab enmascara la dirección para hallar su cabecera).
+ * -no-pie deja el arena por debajo de 4GB, en una dirección de 32 bits.
+ * ============================================================ */
+
+#define POOL_BLOCKS     64
+#define MAX_RECLAIMERS  4
+
+/* tests/host_kernel.h lo declara para el gestor; aquí no se usa */
+uint8_t host_e820_map[4096];
+
+static uint8_t pool[POOL_BLOCKS * SLAB_SIZE] __attribute__((aligned(SLAB_SIZE)));
+static uint8_t pool_used[POOL_BLOCKS];
+static uint32_t pool_limit = POOL_BLOCKS;   /* Bloques disponibles */
+static uint32_t pool_live = 0;
+static uint32_t pool_frees = 0;             /* memory_free (se evaporarían) */
+static uint32_t pool_discards = 0;          /* memory_discard (en el acto) */
+
+static uint32_t (*reclaimers[MAX_RECLAIMERS])(uint32_t pages_wanted);
+static uint32_t num_reclaimers = 0;
+
+static int pool_block(uint32_t address) {
+    uintptr_t off = (uintptr_t)address - (uintptr_t)pool;
+    return (off % SLAB_SIZE == 0 && off / SLAB_SIZE < POOL_BLOCKS) ? (int)(off / SLAB_SIZE) : -1;
+}
+
+static uint32_t pool_take(void) {
+    if (pool_live >= pool_limit) return 0;
+    for (uint32_t i = 0; i < POOL_BLOCKS; i++) {
+        if (!pool_used[i]) {
+            pool_used[i] = 1;
+            pool_live++;
+            return (uint32_t)(uintptr_t)(pool + i * SLAB_SIZE);
+        }
+    }
+    return 0;
+}
+
+static void pool_return(uint32_t address) {
+    int b = pool_block(address);
+    if (b < 0 || !pool_used[b]) return;
+    pool_used[b] = 0;
+    pool_live--;
+}
+
+uint32_t memory_allocate(uint32_t size) {
+    if (size == 0 || size > SLAB_SIZE) return 0;
+    uint32_t address = pool_take();
+    for (uint32_t r = 0; !address && r < num_reclaimers; r++) {
+        reclaimers[r](SLAB_PAGES);
+        address = pool_take();
+    }
+    return address;
+}
+
+void memory_free(uint32_t address) {
+    pool_frees++;
+    pool_return(address);
+}
+
+void memory_discard(uint32_t address) {
+    pool_discards++;
+    pool_return(address);
+}
+
+void memory_register_reclaimer(uint32_t (*reclaim)(uint32_t pages_wanted)) {
+    if (num_reclaimers < MAX_RECLAIMERS) reclaimers[num_reclaimers++] = reclaim;
+}
+
+/* ============================================================
+ * AUXILIARES
+ * ============================================================ */
+
+/* Vuelta al arranque: gestor vacío, clases de kmalloc y caché de pulsos */
+static void fresh_slabs(void) {
+    memset(pool_used, 0, sizeof(pool_used));
+    pool_limit = POOL_BLOCKS;
+    pool_live = 0;
+    pool_frees = 0;
+    pool_discards = 0;
+    num_reclaimers = 0;
+    slab_init();
+    laser_cache_init();
+}
+
+/* Estadísticas de la caché llamada name; 0 si no existe */
+static int cache_stats(const char *name, SlabCacheStats *st) {
+    for (uint32_t id = 0; id < SLAB_MAX_CACHES; id++) {
+        if (slab_get_stats(id, st) && strcmp(st->name, name) == 0) return 1;
+    }
+    return 0;
+}
+
+/* xorshift32: secuencia reproducible */
+static uint32_t rng_state = 2463534242u;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ============================================================
+ * TESTS: kmalloc
+ * ============================================================ */
+
+TEST(test_kmalloc_size_classes) {
+    SlabCacheStats st;
+    fresh_slabs();
+
+    ASSERT(kmalloc(0) == NULL, "zero bytes rejected");
+    ASSERT(kmalloc(SLAB_MAX_OBJECT + 1) == NULL, "larger than the biggest class rejected");
+
+    void *a = kmalloc(1);
+    void *b = kmalloc(17);
+    void *c = kmalloc(SLAB_MAX_OBJECT);
+    ASSERT(a && b && c, "allocations succeed");
+    ASSERT(((uintptr_t)a & 15) == 0 && ((uintptr_t)b & 15) == 0, "objects 16-byte aligned");
+
+    ASSERT(cache_stats("kmalloc-16", &st) && st.objs_in_use == 1, "1 byte from kmalloc-16");
+    ASSERT(cache_stats("kmalloc-32", &st) && st.objs_in_use == 1, "17 bytes from kmalloc-32");
+    ASSERT(cache_stats("kmalloc-2048", &st) && st.objs_in_use == 1, "2048 bytes from kmalloc-2048");
+    ASSERT(pool_live == 3, "one slab per class in use");
+
+    kfree(a);
+    kfree(b);
+    kfree(c);
+    kfree(NULL);
+    ASSERT(cache_stats("kmalloc-32", &st) && st.objs_in_use == 0 && st.slabs_empty == 1,
+           "freed slab kept empty");
+    PASS();
+}
+
+/* Objetos mezclados con su patrón: ninguno pisa a otro */
+TEST(test_kmalloc_mixed_objects_disjoint) {
+    enum { N = 2000 };
+    static uint8_t *obj[N];
+    static uint32_t len[N];
+    fresh_slabs();
+
+    uint32_t got = 0;
+    for (uint32_t i = 0; i < N; i++) {
+        len[i] = 1 + rng_next() % 256;
+        obj[i] = (uint8_t *)kmalloc(len[i]);
+        if (!obj[i]) continue;
+        memset(obj[i], (int)(i & 0xFF), len[i]);
+        got++;
+    }
+    ASSERT(got == N, "pool holds every object");
+
+    /* Liberar la mitad y volver a pedirla */
+    for (uint32_t i = 0; i < N; i += 2) kfree(obj[i]);
+    for (uint32_t i = 0; i < N; i += 2) {
+        obj[i] = (uint8_t *)kmalloc(len[i]);
+        ASSERT(obj[i] != NULL, "reallocation succeeds");
+        memset(obj[i], (int)(i & 0xFF), len[i]);
+    }
+    for (uint32_t i = 0; i < N; i++) {
+        for (uint32_t k = 0; k < len[i]; k++) {
+            ASSERT(obj[i][k] == (uint8_t)(i & 0xFF), "object contents intact");
+        }
+    }
+
+    for (uint32_t i = 0; i < N; i++) kfree(obj[i]);
+    for (uint32_t id = 0; id < SLAB_MAX_CACHES; id++) {
+        SlabCacheStats st;
+        if (!slab_get_stats(id, &st)) continue;
+        ASSERT(st.objs_in_use == 0 && st.slabs_partial == 0 && st.slabs_full == 0,
+               "every object returned");
+        ASSERT(st.slabs_empty <= SLAB_EMPTY_KEEP, "surplus empty slabs released");
+    }
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: listas de slabs
+ * ============================================================ */
+
+/* vacío → parcial → lleno → parcial → vacío, y el excedente al gestor */
+TEST(test_list_transitions) {
+    SlabCacheStats st;
+    static void *obj[64];
+    fresh_slabs();
+
+    SlabCache *c = slab_cache_create("test-1k", 1024, NULL);
+    ASSERT(c != NULL, "cache created");
+    ASSERT(cache_stats("test-1k", &st), "cache listed");
+    uint32_t cap = st.objs_per_slab;
+    ASSERT(cap == SLAB_SIZE / 1024 - 1, "slab header costs one object");
+
+    obj[0] = slab_alloc(c);
+    cache_stats("test-1k", &st);
+    ASSERT(st.slabs_partial == 1 && st.slabs_full == 0 && st.slabs_empty == 0, "first object: partial");
+
+    for (uint32_t i = 1; i < cap; i++) obj[i] = slab_alloc(c);
+    cache_stats("test-1k", &st);
+    ASSERT(st.slabs_partial == 0 && st.slabs_full == 1, "capacity objects: full");
+
+    obj[cap] = slab_alloc(c);
+    cache_stats("test-1k", &st);
+    ASSERT(st.slabs_partial == 1 && st.slabs_full == 1 && st.objs_in_use == cap + 1, "second slab grown");
+
+    slab_free(obj[0]);
+    cache_stats("test-1k", &st);
+    ASSERT(st.slabs_partial == 2 && st.slabs_full == 0, "free from full slab: partial");
+
+    for (uint32_t i = 1; i < cap; i++) slab_free(obj[i]);
+    cache_stats("test-1k", &st);
+    ASSERT(st.slabs_partial == 1 && st.slabs_empty == 1, "drained slab kept empty");
+    ASSERT(pool_frees == 0, "kept slab not returned");
+
+    slab_free(obj[cap]);
+    cache_stats("test-1k", &st);
+    ASSERT(st.slabs_partial == 0 && st.slabs_empty == SLAB_EMPTY_KEEP && st.objs_in_use == 0,
+           "second drained slab released");
+    ASSERT(pool_frees == 1, "surplus slab back to the manager");
+
+    slab_free(obj[cap]);                            /* Doble liberación: ignorada */
+    slab_free((uint8_t *)pool + 4);                 /* Dentro de la cabecera: ignorado */
+    cache_stats("test-1k", &st);
+    ASSERT(st.objs_in_use == 0, "stray frees ignored");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: constructor
+ * ============================================================ */
+
+#define CTOR_SIZE   40
+#define CTOR_WORDS  (CTOR_SIZE / 4)
+#define CTOR_MAGIC  0xC0DE0000u
+
+static uint32_t ctor_calls = 0;
+
+static void ctor_fill(void *obj) {
+    uint32_t *w = (uint32_t *)obj;
+    for (uint32_t k = 0; k < CTOR_WORDS; k++) w[k] = CTOR_MAGIC + k;
+    ctor_calls++;
+}
+
+static int ctor_intact(const void *obj) {
+    const uint32_t *w = (const uint32_t *)obj;
+    for (uint32_t k = 0; k < CTOR_WORDS; k++) {
+        if (w[k] != CTOR_MAGIC + k) return 0;
+    }
+    return 1;
+}
+
+/* El enlace de la lista libre va tras el objeto: el estado construido
+ * sobrevive a la lista libre y a la reutilización */
+TEST(test_ctor_state_survives_reuse) {
+    SlabCacheStats st;
+    static void *obj[512];
+    fresh_slabs();
+    ctor_calls = 0;
+
+    SlabCache *c = slab_cache_create("test-ctor", CTOR_SIZE, ctor_fill);
+    ASSERT(c != NULL && cache_stats("test-ctor", &st), "cache created");
+    uint32_t cap = st.objs_per_slab;
+    ASSERT(cap <= 512, "slab fits the test array");
+
+    for (uint32_t i = 0; i < cap; i++) {
+        obj[i] = slab_alloc(c);
+        ASSERT(obj[i] != NULL && ctor_intact(obj[i]), "fresh object constructed");
+    }
+    ASSERT(ctor_calls == cap, "constructor runs once per object, at slab creation");
+    uint32_t slabs = pool_live;
+
+    /* Devolver en otro orden: cada objeto queda en la lista libre */
+    for (uint32_t i = 0; i < cap; i += 2) slab_free(obj[i]);
+    for (uint32_t i = 1; i < cap; i += 2) slab_free(obj[i]);
+    for (uint32_t i = 0; i < cap; i++) {
+        obj[i] = slab_alloc(c);
+        ASSERT(obj[i] != NULL && ctor_intact(obj[i]), "reused object still constructed");
+    }
+    ASSERT(ctor_calls == cap, "reuse does not construct again");
+    ASSERT(pool_live == slabs, "no new slab for reused objects");
+    PASS();
+}
+
+/* Sin constructor el enlace ocupa la primera palabra del objeto; con
+ * constructor, una palabra propia tras él */
+TEST(test_ctor_link_after_object) {
+    SlabCacheStats plain, with_ctor;
+    fresh_slabs();
+
+    ASSERT(slab_cache_create("test-16", 16, NULL) != NULL, "16-byte cache");
+    ASSERT(slab_cache_create("test-16c", 16, ctor_fill) != NULL, "16-byte cache with ctor");
+    ASSERT(cache_stats("test-16", &plain) && cache_stats("test-16c", &with_ctor), "both listed");
+    ASSERT(with_ctor.objs_per_slab < plain.objs_per_slab, "ctor cache reserves a link word per object");
+    ASSERT(slab_cache_create("too-big", SLAB_SIZE, NULL) == NULL, "object larger than a slab rejected");
+    ASSERT(slab_cache_create("empty", 0, NULL) == NULL, "zero-size cache rejected");
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: reclamación
+ * ============================================================ */
+
+/* slab_reclaim descarta los slabs vacíos (en el acto), nunca los usados */
+TEST(test_reclaim_releases_empty_slabs) {
+    SlabCacheStats st;
+    fresh_slabs();
+
+    void *small = kmalloc(16);
+    void *mid = kmalloc(100);
+    void *big = kmalloc(1000);
+    kfree(mid);
+    kfree(big);
+    ASSERT(pool_live == 3, "three slabs, two empty");
+
+    ASSERT(slab_reclaim(1) == SLAB_PAGES, "one slab reclaimed for one page");
+    ASSERT(pool_discards == 1 && pool_live == 2, "reclaimed slab discarded");
+    ASSERT(slab_reclaim(1000) == SLAB_PAGES, "the other empty slab reclaimed");
+    ASSERT(slab_reclaim(1000) == 0, "nothing left to reclaim");
+    ASSERT(pool_live == 1, "slab in use survives");
+    ASSERT(cache_stats("kmalloc-16", &st) && st.objs_in_use == 1 && st.slabs_partial == 1,
+           "partial slab untouched");
+    kfree(small);
+    PASS();
+}
+
+/* Sin bloques libres, memory_allocate recurre al reclamador registrado */
+TEST(test_reclaim_under_pressure) {
+    fresh_slabs();
+
+    void *a = kmalloc(64);
+    kfree(a);                                   /* Slab vacío retenido */
+    pool_limit = 1;
+    void *b = kmalloc(512);
+    ASSERT(b != NULL, "allocation served by reclaiming the empty slab");
+    ASSERT(pool_discards == 1 && pool_live == 1, "empty slab discarded, not evaporated");
+    ASSERT(kmalloc(16) == NULL, "nothing more to reclaim");
+    kfree(b);
+    PASS();
+}
+
+/* ============================================================
+ * TESTS: caché de pulsos
+ * ============================================================ */
+
+static CMatrix cm_rho;
+static LaserObservable cm_obs[LASER_CACHE_SAMPLES];
+
+static void store_pulse(uint64_t key) {
+    cm_rho.rows = cm_rho.cols = 2;
+    cm_rho.data[0][0].re = (double)key;
+    cm_obs[0].time = (double)key;
+    laser_cache_store(key, &cm_rho, cm_obs, 1);
+}
+
+/* Las entradas salen de la caché slab "laser-cache" y vuelven a ella */
+TEST(test_laser_cache_entries_from_slab) {
+    SlabCacheStats st;
+    uint32_t hits, misses, entries;
+    fresh_slabs();
+
+    ASSERT(cache_stats("laser-cache", &st) && st.objs_in_use == 0, "entry cache registered");
+    store_pulse(1);
+    store_pulse(2);
+    store_pulse(3);
+    cache_stats("laser-cache", &st);
+    ASSERT(st.objs_in_use == 3, "one slab object per entry");
+
+    ASSERT(laser_cache_lookup(2, &cm_rho, cm_obs, 1), "stored pulse hits");
+    ASSERT(cm_rho.data[0][0].re == 2.0 && cm_obs[0].time == 2.0, "entry contents copied back");
+
+    ASSERT(laser_cache_reclaim(2) == 2, "two entries reclaimed");
+    cache_stats("laser-cache", &st);
+    laser_cache_stats(&hits, &misses, &entries);
+    ASSERT(st.objs_in_use == 1 && entries == 1, "reclaimed entries back in the slab");
+    ASSERT(laser_cache_lookup(2, &cm_rho, cm_obs, 1), "most recently used entry survives");
+
+    for (uint64_t k = 10; k < 10 + LASER_CACHE_ENTRIES + 3; k++) store_pulse(k);
+    cache_stats("laser-cache", &st);
+    laser_cache_stats(&hits, &misses, &entries);
+    ASSERT(st.objs_in_use == LASER_CACHE_ENTRIES && entries == LASER_CACHE_ENTRIES,
+           "full cache recycles LRU entries instead of growing");
+    ASSERT(!laser_cache_lookup(2, &cm_rho, cm_obs, 1), "LRU entry evicted");
+    ASSERT(laser_cache_lookup(10 + LASER_CACHE_ENTRIES + 2, &cm_rho, cm_obs, 1), "newest entry kept");
+
+    laser_cache_reclaim(LASER_CACHE_ENTRIES);
+    cache_stats("laser-cache", &st);
+    ASSERT(st.objs_in_use == 0, "every entry returned to the slab");
+    PASS();
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(void) {
+    printf("============================================\n");
+    printf(" Smopsys Q-CORE: Slab Allocator Tests\n");
+    printf("============================================\n\n");
+
+    printf("kmalloc:\n");
+    RUN_TEST(test_kmalloc_size_classes);
+    RUN_TEST(test_kmalloc_mixed_objects_disjoint);
+
+    printf("\nSlab Lists:\n");
+    RUN_TEST(test_list_transitions);
+
+    printf("\nConstructor:\n");
+    RUN_TEST(test_ctor_state_survives_reuse);
+    RUN_TEST(test_ctor_link_after_object);
+
+    printf("\nReclaim:\n");
+    RUN_TEST(test_reclaim_releases_empty_slabs);
+    RUN_TEST(test_reclaim_under_pressure);
+
+    printf("\nLaser Cache:\n");
+    RUN_TEST(test_laser_cache_entries_from_slab);
+
+    printf("\n============================================\n");
+    printf(" Results: %d/%d passed, %d failed\n", tests_passed, tests_run, tests_failed);
+    printf("============================================\n");
+
+    return tests_failed > 0 ? 1 : 0;
+}